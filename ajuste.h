@@ -0,0 +1,254 @@
+/*
+ * ajuste.h
+ * Noyau d'ajustement entierement dans l'en-tete, specialise a la
+ * compilation. Un modele a deux parametres est une "politique" : une macro
+ * qui donne la valeur f(x) et les derivees partielles df/da, df/db.
+ *   AJUSTE_DROITE         f(x) = a + b x
+ *   AJUSTE_EXPONENTIELLE  f(x) = a exp(b x)
+ *
+ * AJUSTE_BOUCLES(nom, T, MODELE) engendre les boucles d'un bloc de points,
+ * avec r = f(x) - y :
+ *   nom_sommes_boucle    s[0] = Σ r², s[1] = Σ r df/da, s[2] = Σ r df/db
+ *   nom_normales_boucle  en plus s[3] = Σ (df/da)², s[4] = Σ df/da df/db,
+ *                        s[5] = Σ (df/db)² (JᵀJ de Gauss-Newton)
+ * memes conventions que expvec_sommes et expvec_normales. Le modele et
+ * l'exponentielle du type (expf ou exp) y sont developpes ; les produits
+ * sont faits dans T et accumules en double.
+ *
+ * AJUSTE_DEFINIR(nom, T, MODELE, SOMMES, NORMALES) engendre, pour les
+ * boucles de bloc SOMMES et NORMALES :
+ *   nom_valeur         f(x)
+ *   nom_sommes         3 ou 6 sommes sur tous les points, reparties sur le pool
+ *   nom_cout           J = Σ (f(x) - y)² / 2n
+ *   nom_descente       descente de optim.h (OPTIM_DEFINIR), parametres dans T
+ *   nom_lm             Levenberg-Marquardt de lm.h (LM_DEFINIR)
+ *   nom_ecrire_points, nom_ecrire_courbe  fichiers pour gnuplot (ecriture.h)
+ * La descente et LM appellent leur evaluateur directement ; le seul appel
+ * indirect est celui de chaque bloc par le pool, une fois par bloc et par
+ * passe.
+ *
+ * Instanciations fournies (suffixe f : colonnes float) :
+ *   ajuste_droitef  droite en float (gauchy.c, moinCarre.c)
+ *   ajuste_exp      exponentielle en double, blocs de expvec (gradient.c,
+ *                   gauchy_exp.c, departs.c, solveurs.c, lm.c)
+ *   ajuste_expf     exponentielle en float (gradient_int.c)
+ * et ajuste_droitef_descente_moments, la descente de la droite sur les
+ * moments (O(1) par iteration).
+ */
+
+#ifndef AJUSTE_H
+#define AJUSTE_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "pool.h"
+#include "expvec.h"
+#include "moments.h"
+#include "optim.h"
+#include "lm.h"
+#include "ecriture.h"
+
+/* Exponentielle de chaque type scalaire (T doit etre un seul mot) */
+#define AJUSTE_EXP_float expf
+#define AJUSTE_EXP_double exp
+
+/* ===== Politiques de modele ===== */
+
+/* E : exponentielle du type ; f, fa, fb recoivent f(x), df/da, df/db */
+#define AJUSTE_DROITE(E, a, b, x, f, fa, fb) \
+    do { (f) = (a) + (b) * (x); (fa) = 1; (fb) = (x); } while (0)
+
+#define AJUSTE_EXPONENTIELLE(E, a, b, x, f, fa, fb) \
+    do { (fa) = E((b) * (x)); (f) = (a) * (fa); (fb) = (f) * (x); } while (0)
+
+/* ===== Boucles de bloc ===== */
+
+#define AJUSTE_BOUCLES(nom, T, MODELE)                                          \
+                                                                                \
+static inline void nom##_sommes_boucle(const T *x, const T *y, size_t n,       \
+                                       T a, T b, double s[3]) {                 \
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0;                                        \
+    size_t i;                                                                   \
+    for (i = 0; i < n; i++) {                                                   \
+        T f, fa, fb, r;                                                         \
+        MODELE(AJUSTE_EXP_##T, a, b, x[i], f, fa, fb);                          \
+        r = f - y[i];                                                           \
+        s0 += r * r;                                                            \
+        s1 += r * fa;                                                           \
+        s2 += r * fb;                                                           \
+    }                                                                           \
+    s[0] = s0;                                                                  \
+    s[1] = s1;                                                                  \
+    s[2] = s2;                                                                  \
+}                                                                               \
+                                                                                \
+static inline void nom##_normales_boucle(const T *x, const T *y, size_t n,     \
+                                         T a, T b, double s[6]) {               \
+    double t[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };                             \
+    size_t i;                                                                   \
+    int j;                                                                      \
+    for (i = 0; i < n; i++) {                                                   \
+        T f, fa, fb, r;                                                         \
+        MODELE(AJUSTE_EXP_##T, a, b, x[i], f, fa, fb);                          \
+        r = f - y[i];                                                           \
+        t[0] += r * r;                                                          \
+        t[1] += r * fa;                                                         \
+        t[2] += r * fb;                                                         \
+        t[3] += fa * fa;                                                        \
+        t[4] += fa * fb;                                                        \
+        t[5] += fb * fb;                                                        \
+    }                                                                           \
+    for (j = 0; j < 6; j++) s[j] = t[j];                                        \
+}
+
+/* ===== Fonctions engendrees ===== */
+
+#define AJUSTE_DEFINIR(nom, T, MODELE, SOMMES, NORMALES)                        \
+                                                                                \
+static inline T nom##_valeur(T a, T b, T x) {                                   \
+    T f, fa, fb;                                                                \
+    MODELE(AJUSTE_EXP_##T, a, b, x, f, fa, fb);                                 \
+    (void)fa; (void)fb;                                                         \
+    return f;                                                                   \
+}                                                                               \
+                                                                                \
+typedef struct {                                                                \
+    const T *x, *y;                                                             \
+    size_t n;                                                                   \
+    T a, b;                                                                     \
+    int nsommes;                                                                \
+} nom##_Donnees;                                                                \
+                                                                                \
+static inline void nom##_bloc(void *ctx, size_t debut, size_t fin, double *s) { \
+    const nom##_Donnees *d = (const nom##_Donnees *)ctx;                        \
+    if (d->nsommes == 3) SOMMES(d->x + debut, d->y + debut, fin - debut, d->a, d->b, s); \
+    else NORMALES(d->x + debut, d->y + debut, fin - debut, d->a, d->b, s);      \
+}                                                                               \
+                                                                                \
+/* nsommes = 3 (cout et gradient) ou 6 (equations normales), non normalisees */ \
+static inline void nom##_sommes(const T *x, const T *y, size_t n, T a, T b,    \
+                                int nsommes, double *s) {                       \
+    nom##_Donnees d = { x, y, n, a, b, nsommes };                               \
+    pool_reduire(pool_defaut(), n, nsommes, nom##_bloc, &d, s);                 \
+}                                                                               \
+                                                                                \
+static inline double nom##_cout(const T *x, const T *y, size_t n, T a, T b) {  \
+    double s[3];                                                                \
+    nom##_sommes(x, y, n, a, b, 3, s);                                          \
+    return s[0] / (2.0 * (double)n);                                            \
+}                                                                               \
+                                                                                \
+static inline int nom##_evaluer(void *ctx, const T p[2], double *cout, T g[2]) { \
+    const nom##_Donnees *d = (const nom##_Donnees *)ctx;                        \
+    double s[3];                                                                \
+    nom##_sommes(d->x, d->y, d->n, p[0], p[1], 3, s);                           \
+    *cout = s[0] / (2.0 * (double)d->n);                                        \
+    g[0] = (T)(s[1] / (double)d->n);                                            \
+    g[1] = (T)(s[2] / (double)d->n);                                            \
+    return 0;                                                                   \
+}                                                                               \
+                                                                                \
+OPTIM_DEFINIR(nom##_minimiser, T, nom##_evaluer)                                \
+                                                                                \
+/* Descente depuis (*a, *b), qui recoivent le point atteint */                 \
+static inline OptimResultat nom##_descente(const T *x, const T *y, size_t n,   \
+                                           T *a, T *b, const OptimOptions *o) { \
+    nom##_Donnees d = { x, y, n, 0, 0, 3 };                                     \
+    double p[2] = { *a, *b };                                                   \
+    OptimResultat r = nom##_minimiser(&d, p, o);                                \
+    *a = (T)r.p[0];                                                             \
+    *b = (T)r.p[1];                                                             \
+    return r;                                                                   \
+}                                                                               \
+                                                                                \
+static inline int nom##_evaluer_lm(void *ctx, double a, double b, double s[6]) { \
+    const nom##_Donnees *d = (const nom##_Donnees *)ctx;                        \
+    int j;                                                                      \
+    nom##_sommes(d->x, d->y, d->n, (T)a, (T)b, 6, s);                           \
+    for (j = 0; j < 6; j++) s[j] /= (double)d->n;                               \
+    return 0;                                                                   \
+}                                                                               \
+                                                                                \
+LM_DEFINIR(nom##_lm_minimiser, nom##_evaluer_lm)                                \
+                                                                                \
+static inline LmResultat nom##_lm(const T *x, const T *y, size_t n,            \
+                                  double a, double b, const LmOptions *o) {     \
+    nom##_Donnees d = { x, y, n, 0, 0, 6 };                                     \
+    return nom##_lm_minimiser(&d, a, b, o);                                     \
+}                                                                               \
+                                                                                \
+/* Une ligne "x y" par point (deux doubles en mode binaire) */                 \
+static inline void nom##_ecrire_points(Ecriture *f, const T *x, const T *y,    \
+                                       size_t n) {                              \
+    size_t i;                                                                   \
+    for (i = 0; i < n; i++) {                                                   \
+        double v[2] = { x[i], y[i] };                                           \
+        ecriture_ligne(f, v, 2, " ", 6);                                        \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+/* m + 1 points du modele sur l'etendue des x elargie de 10 % de chaque cote */ \
+static inline void nom##_ecrire_courbe(Ecriture *f, const T *x, size_t n,      \
+                                       T a, T b, int m) {                       \
+    double xmin = x[0], xmax = x[0], debut, etendue;                            \
+    size_t i;                                                                   \
+    int k;                                                                      \
+    for (i = 1; i < n; i++) {                                                   \
+        if (x[i] < xmin) xmin = x[i];                                           \
+        if (x[i] > xmax) xmax = x[i];                                           \
+    }                                                                           \
+    etendue = xmax - xmin;                                                      \
+    if (etendue == 0.0) { xmin -= 1.0; etendue = 2.0; }                         \
+    debut = xmin - 0.1 * etendue;                                               \
+    etendue *= 1.2;                                                             \
+    for (k = 0; k <= m; k++) {                                                  \
+        T xv = (T)(debut + etendue * k / m);                                    \
+        double v[2] = { xv, nom##_valeur(a, b, xv) };                           \
+        ecriture_ligne(f, v, 2, " ", 6);                                        \
+    }                                                                           \
+}
+
+AJUSTE_BOUCLES(ajuste_droitef, float, AJUSTE_DROITE)
+AJUSTE_DEFINIR(ajuste_droitef, float, AJUSTE_DROITE,
+               ajuste_droitef_sommes_boucle, ajuste_droitef_normales_boucle)
+
+AJUSTE_DEFINIR(ajuste_exp, double, AJUSTE_EXPONENTIELLE, expvec_sommes, expvec_normales)
+
+AJUSTE_BOUCLES(ajuste_expf, float, AJUSTE_EXPONENTIELLE)
+AJUSTE_DEFINIR(ajuste_expf, float, AJUSTE_EXPONENTIELLE,
+               ajuste_expf_sommes_boucle, ajuste_expf_normales_boucle)
+
+/* ===== Droite sur les moments ===== */
+
+/* Cout et gradient par les moments, en O(1), parametres en float */
+static inline int ajuste_droitef_evaluer_moments(void *ctx, const float p[2], double *cout, float g[2]) {
+    const Moments *m = (const Moments *)ctx;
+    double g0, g1;
+    moments_gradient(m, p[0], p[1], &g0, &g1);
+    g[0] = (float)g0;
+    g[1] = (float)g1;
+    *cout = moments_cout(m, p[0], p[1]);
+    return 0;
+}
+
+OPTIM_DEFINIR(ajuste_droitef_minimiser_moments, float, ajuste_droitef_evaluer_moments)
+
+static inline OptimResultat ajuste_droitef_descente_moments(const Moments *m, float *a, float *b,
+                                                            const OptimOptions *o) {
+    double p[2] = { *a, *b };
+    OptimResultat r = ajuste_droitef_minimiser_moments((void *)m, p, o);
+    *a = (float)r.p[0];
+    *b = (float)r.p[1];
+    return r;
+}
+
+/* ===== Suivi ===== */
+
+/* Affichage toutes les 5000 iterations (gradient.c, gauchy_exp.c) */
+static inline void ajuste_suivi(int iteration, const double p[2], double cout) {
+    if (iteration % 5000 == 0)
+        printf("it=%6d  a=%.6f  b=%.6f  cost=%.6f\n", iteration, p[0], p[1], cout);
+}
+
+#endif
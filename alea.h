@@ -0,0 +1,36 @@
+/*
+ * alea.h
+ * Tirages sans etat de la serie : splitmix64 d'un compteur. Un tirage est
+ * une fonction de (cle, numero) et non d'un etat partage, si bien que les
+ * resultats ne dependent ni de l'ordre des tirages ni du nombre de
+ * threads (departs.c, sgd.c, synthese.c, robuste.c, verif_robuste.c,
+ * bootstrap.c, croisee.c).
+ */
+
+#ifndef ALEA_H
+#define ALEA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ALEA_GAMMA 0x9e3779b97f4a7c15ULL        /* increment de splitmix64 */
+
+/* splitmix64 : melange bijectif de 64 bits */
+static inline uint64_t alea_melange(uint64_t z) {
+    z += ALEA_GAMMA;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Uniforme dans ]0, 1) a partir des 53 bits de poids fort */
+static inline double alea_uniforme(uint64_t z) {
+    return ((z >> 11) + 0.5) * 0x1.0p-53;
+}
+
+/* Indice uniforme dans [0, n) : partie haute du produit z * n, sans division */
+static inline size_t alea_indice(uint64_t z, size_t n) {
+    return (size_t)(((unsigned __int128)z * n) >> 64);
+}
+
+#endif
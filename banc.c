@@ -0,0 +1,197 @@
+/*
+ * banc.c
+ * Banc de mesure des solveurs sur des donnees synthetiques (synthese.h).
+ *
+ * Pour chaque taille n = 10^3, 10^4, ... jusqu'a -n, chaque modele et
+ * chaque solveur qui lui correspond (droite : moindres, lineaire,
+ * theilsen, siegel ; exponentielle : exp, lm, sgd), un processus fils
+ * mesure separement :
+ *   lecture     chargement du fichier texte (lecture_points)
+ *   ajustement  solveur_ajuster
+ *   sortie      ecriture des points et de la courbe ajustee (comme les
+ *               fichiers de trace des programmes)
+ * puis ecrit une ligne JSON : debits, iterations/s, pic de memoire
+ * residente du fils (getrusage) et erreur relative des parametres par
+ * rapport aux parametres vrais. Une ligne par mesure, a ajouter a un
+ * historique (./banc >> mesures.jsonl) pour suivre l'evolution.
+ *
+ * Usage : ./banc [-n nmax] [-s solveur]... [-r repertoire] [-g graine]
+ *                [-a proportion_aberrants] [-i] [-B]
+ *   -n    plus grande taille (defaut 1e6, jusqu'a 1e8)
+ *   -s    restreint aux solveurs nommes (option repetable)
+ *   -r    repertoire des fichiers temporaires (defaut : TMPDIR ou /tmp)
+ *   -i    depart log-lineaire pour exp, lm et sgd
+ *   -B    donnees au format binaire en colonnes (lecture par projection)
+ * REGRESSION_SORTIE=binaire : phase de sortie en doubles bruts (ecriture.h)
+ *
+ * Compilation : gcc -O2 banc.c synthese.c solveurs.c flux.c points.c lecture.c binaire.c pool.c moments.c expvec.c lm.c sgd.c optim.c trace.c ecriture.c robuste.c -o banc -lm -pthread
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "points.h"
+#include "lecture.h"
+#include "pool.h"
+#include "expvec.h"
+#include "solveurs.h"
+#include "synthese.h"
+#include "ecriture.h"
+
+static void error_and_exit(const char *msg) {
+    fprintf(stderr, "%s\n", msg);
+    exit(EXIT_FAILURE);
+}
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double erreur_relative(double estime, double vrai) {
+    return vrai != 0.0 ? fabs(estime - vrai) / fabs(vrai) : fabs(estime);
+}
+
+/* Phase de sortie : x, y et valeur ajustee pour chaque point */
+static double ecrire_sortie(const char *fichier, const Points *pts, const Synthese *s, const Ajustement *aj) {
+    double debut = maintenant();
+    Ecriture e;
+    size_t i;
+
+    if (ecriture_ouvrir(&e, fichier, ecriture_env()) != 0) return -1.0;
+    for (i = 0; i < pts->n; i++) {
+        double v[3];
+        v[0] = pts->type == POINTS_FLOAT ? pts->xf[i] : pts->xd[i];
+        v[1] = pts->type == POINTS_FLOAT ? pts->yf[i] : pts->yd[i];
+        v[2] = s->modele == SYNTHESE_LINEAIRE ? aj->p0 + aj->p1 * v[0] : aj->p0 * exp(aj->p1 * v[0]);
+        ecriture_ligne(&e, v, 3, " ", 6);
+    }
+    ecriture_fermer(&e);
+    return maintenant() - debut;
+}
+
+/* Une mesure, executee dans un processus fils pour isoler le pic de memoire */
+static void mesurer(const char *donnees, const char *sortie, const Synthese *s, size_t n,
+                    Solveur solveur, int init_log, int format_binaire) {
+    Points pts;
+    LectureInfo info;
+    Ajustement aj;
+    struct rusage ru;
+    double t_lecture, t_ajustement, t_sortie, debut;
+    LectureCode code;
+
+    debut = maintenant();
+    code = lecture_points(donnees, &pts, solveur_type(solveur), &info);
+    t_lecture = maintenant() - debut;
+    if (code != LECTURE_OK) {
+        fprintf(stderr, "%s : %s\n", donnees, lecture_message(code));
+        exit(EXIT_FAILURE);
+    }
+
+    debut = maintenant();
+    aj = solveur_ajuster(solveur, &pts, init_log);
+    t_ajustement = maintenant() - debut;
+
+    t_sortie = ecrire_sortie(sortie, &pts, s, &aj);
+    unlink(sortie);
+    getrusage(RUSAGE_SELF, &ru);
+
+    printf("{\"date\": %ld, \"modele\": \"%s\", \"solveur\": \"%s\", \"n\": %zu, "
+           "\"format\": \"%s\", \"threads\": %d, \"isa\": \"%s\", \"aberrants\": %g, \"depart_log\": %d, "
+           "\"lecture_s\": %.6f, \"ajustement_s\": %.6f, \"sortie_s\": %.6f, "
+           "\"lecture_mo_s\": %.1f, \"lecture_points_s\": %.0f, \"ajustement_points_s\": %.0f, "
+           "\"iterations\": %d, \"passes\": %d, \"iterations_s\": %.1f, \"rss_max_ko\": %ld, "
+           "\"p0\": %.9g, \"p1\": %.9g, \"erreur_p0\": %.3e, \"erreur_p1\": %.3e, "
+           "\"cout\": %.9g, \"statut\": \"%s\"}\n",
+           (long)time(NULL), s->modele == SYNTHESE_LINEAIRE ? "lin" : "exp", solveur_nom(solveur), n,
+           format_binaire ? "binaire" : "texte", pool_threads(pool_defaut()), expvec_isa(), s->aberrants, init_log,
+           t_lecture, t_ajustement, t_sortie,
+           info.octets / (1024.0 * 1024.0) / t_lecture, n / t_lecture,
+           (double)n * aj.passes / t_ajustement,
+           aj.iterations, aj.passes, aj.iterations / t_ajustement, ru.ru_maxrss,
+           aj.p0, aj.p1, erreur_relative(aj.p0, s->p0), erreur_relative(aj.p1, s->p1),
+           aj.cout, aj.statut);
+    fflush(stdout);
+    points_free(&pts);
+}
+
+int main(int argc, char **argv) {
+    static const SyntheseModele modeles[2] = { SYNTHESE_LINEAIRE, SYNTHESE_EXP };
+    int choisis[SOLVEUR_NOMBRE] = { 0 };
+    int filtre = 0, init_log = 0, format_binaire = 0, m, k;
+    size_t nmax = 1000000, n;
+    const char *repertoire = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    uint64_t graine = 1;
+    double aberrants = 0.0;
+    char donnees[4096], sortie[4096];
+
+    for (k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "-n") == 0 && k + 1 < argc) nmax = (size_t)strtod(argv[++k], NULL);
+        else if (strcmp(argv[k], "-r") == 0 && k + 1 < argc) repertoire = argv[++k];
+        else if (strcmp(argv[k], "-g") == 0 && k + 1 < argc) graine = strtoull(argv[++k], NULL, 10);
+        else if (strcmp(argv[k], "-a") == 0 && k + 1 < argc) aberrants = atof(argv[++k]);
+        else if (strcmp(argv[k], "-i") == 0) init_log = 1;
+        else if (strcmp(argv[k], "-B") == 0) format_binaire = 1;
+        else if (strcmp(argv[k], "-s") == 0 && k + 1 < argc) {
+            Solveur s;
+            if (solveur_depuis_nom(argv[++k], &s) != 0)
+                error_and_exit("Solveur inconnu (moindres, lineaire, exp, lm, sgd, theilsen, siegel)");
+            choisis[s] = 1;
+            filtre = 1;
+        } else {
+            fprintf(stderr, "Usage : %s [-n nmax] [-s solveur]... [-r repertoire] [-g graine] "
+                            "[-a proportion_aberrants] [-i] [-B]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    snprintf(donnees, sizeof(donnees), "%s/banc_%ld_donnees.%s", repertoire, (long)getpid(),
+             format_binaire ? "bin" : "txt");
+    snprintf(sortie, sizeof(sortie), "%s/banc_%ld_sortie.txt", repertoire, (long)getpid());
+
+    for (n = 1000; n <= nmax; n *= 10) {
+        for (m = 0; m < 2; m++) {
+            Synthese s;
+            double debut;
+
+            synthese_defaut(&s, modeles[m]);
+            s.graine = graine;
+            s.aberrants = aberrants;
+            debut = maintenant();
+            if ((format_binaire ? synthese_ecrire_binaire(&s, n, donnees) : synthese_ecrire(&s, n, donnees)) != 0)
+                error_and_exit("Ecriture des donnees impossible");
+            fprintf(stderr, "n=%zu %s : donnees generees en %.3f s\n", n,
+                    modeles[m] == SYNTHESE_LINEAIRE ? "lin" : "exp", maintenant() - debut);
+
+            for (k = 0; k < SOLVEUR_NOMBRE; k++) {
+                Solveur solveur = (Solveur)k;
+                int lineaire = solveur == SOLVEUR_MOINDRES || solveur == SOLVEUR_LINEAIRE ||
+                               solveur == SOLVEUR_THEILSEN || solveur == SOLVEUR_SIEGEL;
+                pid_t fils;
+                int etat;
+
+                if (filtre && !choisis[k]) continue;
+                if (lineaire != (modeles[m] == SYNTHESE_LINEAIRE)) continue;
+
+                fils = fork();
+                if (fils < 0) error_and_exit("fork impossible");
+                if (fils == 0) {
+                    mesurer(donnees, sortie, &s, n, solveur, init_log, format_binaire);
+                    exit(EXIT_SUCCESS);
+                }
+                if (waitpid(fils, &etat, 0) < 0 || !WIFEXITED(etat) || WEXITSTATUS(etat) != 0)
+                    fprintf(stderr, "n=%zu %s : mesure en echec\n", n, solveur_nom(solveur));
+            }
+            unlink(donnees);
+        }
+    }
+    return 0;
+}
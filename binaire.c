@@ -0,0 +1,90 @@
+/*
+ * binaire.c
+ * Ecriture du format binaire en colonnes (voir binaire.h).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "binaire.h"
+
+static size_t arrondi(size_t octets) {
+    return (octets + POINTS_ALIGN - 1) / POINTS_ALIGN * POINTS_ALIGN;
+}
+
+int binaire_creer(const char *fichier, size_t n, PointsType type, Points *pts) {
+    size_t elt = (type == POINTS_FLOAT) ? sizeof(float) : sizeof(double);
+    size_t colonne = arrondi(n * elt);
+    size_t taille = sizeof(BinaireEntete) + 2 * colonne;
+    BinaireEntete *e;
+    char *carte;
+    int fd;
+
+    memset(pts, 0, sizeof(*pts));
+    if (n == 0 || n > ((size_t)-1) / 4 / elt) return -1;
+
+    fd = open(fichier, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+    /* blocs reserves maintenant : un disque plein est signale ici, pas par SIGBUS */
+    if (posix_fallocate(fd, 0, (off_t)taille) != 0) {
+        close(fd);
+        return -1;
+    }
+    carte = mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (carte == MAP_FAILED) return -1;
+
+    e = (BinaireEntete *)carte;
+    memcpy(e->magie, BINAIRE_MAGIE, sizeof(e->magie));
+    e->boutisme = BINAIRE_BOUTISME;
+    e->type = (uint32_t)type;
+    e->n = n;
+    e->offset_x = sizeof(BinaireEntete);
+    e->offset_y = sizeof(BinaireEntete) + colonne;
+
+    pts->n = n;
+    pts->type = type;
+    pts->projection = carte;
+    pts->projection_octets = taille;
+    if (type == POINTS_FLOAT) {
+        pts->xf = (float *)(carte + e->offset_x);
+        pts->yf = (float *)(carte + e->offset_y);
+    } else {
+        pts->xd = (double *)(carte + e->offset_x);
+        pts->yd = (double *)(carte + e->offset_y);
+    }
+    return 0;
+}
+
+int binaire_ecrire(const char *fichier, const Points *pts) {
+    size_t elt = (pts->type == POINTS_FLOAT) ? sizeof(float) : sizeof(double);
+    Points copie;
+
+    if (binaire_creer(fichier, pts->n, pts->type, &copie) != 0) return -1;
+    if (pts->type == POINTS_FLOAT) {
+        memcpy(copie.xf, pts->xf, pts->n * elt);
+        memcpy(copie.yf, pts->yf, pts->n * elt);
+    } else {
+        memcpy(copie.xd, pts->xd, pts->n * elt);
+        memcpy(copie.yd, pts->yd, pts->n * elt);
+    }
+    points_free(&copie);
+    return 0;
+}
+
+int binaire_type(const char *fichier, PointsType *type) {
+    BinaireEntete e;
+    int fd = open(fichier, O_RDONLY);
+    ssize_t lus;
+
+    if (fd < 0) return -1;
+    lus = read(fd, &e, sizeof(e));
+    close(fd);
+    if (lus != (ssize_t)sizeof(e) || memcmp(e.magie, BINAIRE_MAGIE, sizeof(e.magie)) != 0) return -1;
+    if (e.boutisme != BINAIRE_BOUTISME || (e.type != POINTS_FLOAT && e.type != POINTS_DOUBLE)) return -1;
+    *type = (PointsType)e.type;
+    return 0;
+}
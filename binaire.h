@@ -0,0 +1,49 @@
+/*
+ * binaire.h
+ * Format binaire en colonnes des fichiers de points :
+ *   entete de 64 octets (BinaireEntete)
+ *   colonne x puis colonne y, chacune commencant a un multiple de
+ *   POINTS_ALIGN octets, n valeurs float ou double dans l'ordre des
+ *   octets de la machine qui a ecrit le fichier
+ * lecture_points reconnait ce format a sa signature et projette le
+ * fichier en memoire : les colonnes sont utilisees en place, sans copie
+ * ni conversion, quand la precision demandee est celle du fichier.
+ */
+
+#ifndef BINAIRE_H
+#define BINAIRE_H
+
+#include <stdint.h>
+#include "points.h"
+
+#define BINAIRE_MAGIE "PTSCOL01"
+#define BINAIRE_BOUTISME 0x01020304u
+
+typedef struct {
+    char magie[8];              /* BINAIRE_MAGIE, sans zero final */
+    uint32_t boutisme;          /* BINAIRE_BOUTISME tel qu'ecrit */
+    uint32_t type;              /* PointsType des colonnes */
+    uint64_t n;
+    uint64_t offset_x;          /* position des colonnes depuis le debut du fichier */
+    uint64_t offset_y;
+    uint8_t reserve[24];
+} BinaireEntete;
+
+/*
+ * Cree fichier pour n points et le projette en ecriture : pts pointe sur
+ * les colonnes du fichier, a remplir puis a rendre par points_free.
+ * Retourne 0, ou -1 en cas d'erreur (errno renseigne).
+ */
+int binaire_creer(const char *fichier, size_t n, PointsType type, Points *pts);
+
+/* Ecrit une copie de pts. Retourne 0, ou -1 en cas d'erreur. */
+int binaire_ecrire(const char *fichier, const Points *pts);
+
+/*
+ * Lit l'entete de fichier : si c'est un fichier binaire de cette machine,
+ * range la precision de ses colonnes dans *type et retourne 0 ; retourne
+ * -1 sinon (fichier texte, illisible ou d'un autre boutisme).
+ */
+int binaire_type(const char *fichier, PointsType *type);
+
+#endif
@@ -0,0 +1,410 @@
+/*
+ * bootstrap.c
+ * Intervalles de confiance par bootstrap (voir bootstrap.h).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bootstrap.h"
+#include "pool.h"
+#include "moments.h"
+#include "lm.h"
+#include "alea.h"
+
+/* Tirage k de la replique de cle donnee : indice uniforme dans [0, n) */
+static size_t indice(uint64_t cle, uint64_t k, size_t n) {
+    return alea_indice(alea_melange(cle + k * ALEA_GAMMA), n);
+}
+
+static uint64_t cle_replique(uint64_t graine, int r) {
+    return alea_melange(graine ^ alea_melange((uint64_t)r));
+}
+
+/* Cle des tirages de la replique dans le bloc b */
+static uint64_t cle_bloc(uint64_t cle, size_t b) {
+    return alea_melange(cle ^ alea_melange(~(uint64_t)b));
+}
+
+static size_t nombre_blocs(size_t n) {
+    return (n + BOOTSTRAP_BLOC - 1) / BOOTSTRAP_BLOC;
+}
+
+/* Premiere etape : nombre des n tirages de la replique tombes dans chaque bloc */
+static void repartir(uint64_t cle, size_t n, size_t *compte) {
+    size_t k;
+
+    memset(compte, 0, nombre_blocs(n) * sizeof(size_t));
+    for (k = 0; k < n; k++) compte[indice(cle, k, n) / BOOTSTRAP_BLOC]++;
+}
+
+/* Seconde etape : pour chaque bloc, ses tirages i dans [debut, debut + taille) */
+#define BOOTSTRAP_PARCOURIR(cle, n, compte, CORPS)                              \
+    do {                                                                        \
+        size_t bloc_, k_;                                                       \
+        for (bloc_ = 0; bloc_ < nombre_blocs(n); bloc_++) {                     \
+            size_t debut_ = bloc_ * BOOTSTRAP_BLOC;                             \
+            size_t taille_ = (n) - debut_ < BOOTSTRAP_BLOC ? (n) - debut_ : BOOTSTRAP_BLOC; \
+            uint64_t cb_ = cle_bloc(cle, bloc_);                                \
+            for (k_ = 0; k_ < (compte)[bloc_]; k_++) {                          \
+                size_t i = debut_ + indice(cb_, k_, taille_);                   \
+                CORPS                                                           \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+void bootstrap_options_defaut(BootstrapOptions *o) {
+    const char *b = getenv("REGRESSION_BOOTSTRAP");
+
+    o->repliques = b && atoi(b) > 1 ? atoi(b) : BOOTSTRAP_REPLIQUES;
+    o->niveau = 0.95;
+    o->graine = 1;
+}
+
+/* ===== Intervalles ===== */
+
+static double normale(double z) {
+    return 0.5 * erfc(-z / sqrt(2.0));
+}
+
+/* Quantile de la loi normale : approximation rationnelle d'Acklam, puis un pas de Halley */
+static double quantile_normale(double p) {
+    static const double a[6] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    static const double b[5] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                 6.680131188771972e+01, -1.328068155288572e+01 };
+    static const double c[6] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                 -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    static const double d[4] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                 3.754408661907416e+00 };
+    double q, r, x, e, u;
+
+    if (p <= 0.0) return -INFINITY;
+    if (p >= 1.0) return INFINITY;
+    if (p < 0.02425 || p > 1.0 - 0.02425) {
+        q = sqrt(-2.0 * log(p < 0.5 ? p : 1.0 - p));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+        if (p > 0.5) x = -x;
+    } else {
+        q = p - 0.5;
+        r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+    }
+    e = normale(x) - p;
+    u = e * 2.5066282746310002 * exp(0.5 * x * x);       /* e / densite, sqrt(2 pi) = 2.5066... */
+    return x - u / (1.0 + 0.5 * x * u);
+}
+
+static int comparer(const void *a, const void *b) {
+    double u = *(const double *)a, v = *(const double *)b;
+    return (u > v) - (u < v);
+}
+
+/* Quantile p de v[m] trie, par interpolation lineaire */
+static double quantile(const double *v, int m, double p) {
+    double h = p * (m - 1);
+    int i = (int)floor(h);
+
+    if (i < 0) return v[0];
+    if (i >= m - 1) return v[m - 1];
+    return v[i] + (h - i) * (v[i + 1] - v[i]);
+}
+
+/*
+ * Intervalles d'un parametre a partir des m repliques valides (triees
+ * ici) et des sommes Σu², Σu³ des valeurs d'influence (jackknife).
+ */
+static void intervalle(BootstrapIntervalle *iv, double estimation, double *rep, int m, double su2, double su3,
+                       double niveau) {
+    double alpha = 0.5 * (1.0 - niveau), somme = 0.0, carres = 0.0, moyenne, dessous = 0.0;
+    double z[2];
+    int k;
+
+    for (k = 0; k < m; k++) somme += rep[k];
+    moyenne = somme / m;
+    for (k = 0; k < m; k++) {
+        carres += (rep[k] - moyenne) * (rep[k] - moyenne);
+        dessous += rep[k] < estimation ? 1.0 : rep[k] == estimation ? 0.5 : 0.0;
+    }
+    qsort(rep, (size_t)m, sizeof(double), comparer);
+
+    iv->estimation = estimation;
+    iv->ecart_type = sqrt(carres / (m - 1));
+    iv->biais = moyenne - estimation;
+    iv->percentile[0] = quantile(rep, m, alpha);
+    iv->percentile[1] = quantile(rep, m, 1.0 - alpha);
+    iv->z0 = quantile_normale(dessous / m);
+    iv->acceleration = su2 > 0.0 ? su3 / (6.0 * pow(su2, 1.5)) : 0.0;
+
+    z[0] = quantile_normale(alpha);
+    z[1] = -z[0];
+    for (k = 0; k < 2; k++) {
+        double t = iv->z0 + z[k];
+        iv->bca[k] = isfinite(iv->z0) ? quantile(rep, m, normale(iv->z0 + t / (1.0 - iv->acceleration * t))) : NAN;
+    }
+}
+
+/* Repliques valides de chaque parametre dans rep[0..m) et rep[B..B+m), puis intervalles */
+static int conclure(BootstrapResultat *r, const double est[2], double *rep, int repliques, const double su2[2],
+                    const double su3[2], double niveau) {
+    int k, j, m = 0;
+
+    for (k = 0; k < repliques; k++) {
+        if (isnan(rep[k])) continue;
+        rep[m] = rep[k];
+        rep[repliques + m] = rep[repliques + k];
+        m++;
+    }
+    r->valides = m;
+    if (m < 2) return -1;
+    for (j = 0; j < 2; j++) intervalle(&r->p[j], est[j], rep + j * repliques, m, su2[j], su3[j], niveau);
+    return 0;
+}
+
+/* ===== Droite ===== */
+
+typedef struct {
+    double w, sx, sy, sxx, sxy;     /* sommes des ecarts aux moyennes de toutes les donnees */
+} Sommes;
+
+/* Droite des sommes, par moments_droite ; retourne -1 si les x tires sont tous egaux */
+static int droite(const Sommes *s, double mx, double my, double *a0, double *a1) {
+    Moments m;
+
+    memset(&m, 0, sizeof(m));
+    m.n = s->w;
+    m.mx = mx + s->sx / s->w;
+    m.my = my + s->sy / s->w;
+    m.sxx = s->sxx - s->sx * s->sx / s->w;
+    m.sxy = s->sxy - s->sx * s->sy / s->w;
+    return moments_droite(&m, a0, a1);
+}
+
+typedef struct {
+    const Points *pts;
+    const BootstrapOptions *o;
+    double mx, my;
+    double *rep;                /* a0 des repliques puis a1 */
+    int erreur;
+} DroiteCtx;
+
+#define BOOTSTRAP_SOMMES(X, Y)                                                  \
+    {                                                                           \
+        double dx = (X) - c->mx, dy = (Y) - c->my;                              \
+        s.sx += dx;                                                             \
+        s.sy += dy;                                                             \
+        s.sxx += dx * dx;                                                       \
+        s.sxy += dx * dy;                                                       \
+    }
+
+static void tache_droite(void *ctx, size_t part) {
+    DroiteCtx *c = (DroiteCtx *)ctx;
+    int b = c->o->repliques, r, debut = (int)(part * b / BOOTSTRAP_PARTS), fin = (int)((part + 1) * b / BOOTSTRAP_PARTS);
+    size_t n = c->pts->n, *compte;
+
+    if (debut == fin) return;
+    compte = (size_t *)malloc(nombre_blocs(n) * sizeof(size_t));
+    if (!compte) {
+        c->erreur = 1;
+        return;
+    }
+    for (r = debut; r < fin; r++) {
+        uint64_t cle = cle_replique(c->o->graine, r);
+        Sommes s = { (double)n, 0.0, 0.0, 0.0, 0.0 };
+
+        repartir(cle, n, compte);
+        if (c->pts->type == POINTS_FLOAT)
+            BOOTSTRAP_PARCOURIR(cle, n, compte, BOOTSTRAP_SOMMES(c->pts->xf[i], c->pts->yf[i]));
+        else
+            BOOTSTRAP_PARCOURIR(cle, n, compte, BOOTSTRAP_SOMMES(c->pts->xd[i], c->pts->yd[i]));
+        if (droite(&s, c->mx, c->my, &c->rep[r], &c->rep[b + r]) != 0) c->rep[r] = c->rep[b + r] = NAN;
+    }
+    free(compte);
+}
+
+int bootstrap_droite(const Points *pts, const BootstrapOptions *o, BootstrapResultat *r) {
+    DroiteCtx c;
+    Moments m;
+    Sommes total = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    double est[2], moy[2] = { 0.0, 0.0 }, su2[2] = { 0.0, 0.0 }, su3[2] = { 0.0, 0.0 }, x, y;
+    size_t n = pts->n, i, valides = 0;
+    int passe, j, code;
+
+    memset(r, 0, sizeof(*r));
+    moments_init(&m);
+    moments_ajouter_points(&m, pts);
+    if (n < 3 || o->repliques < 2 || moments_droite(&m, &est[0], &est[1]) != 0) return -1;
+
+    c.pts = pts;
+    c.o = o;
+    c.mx = m.mx;
+    c.my = m.my;
+    c.erreur = 0;
+    c.rep = (double *)malloc(2 * (size_t)o->repliques * sizeof(double));
+    if (!c.rep) return -2;
+    pool_executer(pool_defaut(), BOOTSTRAP_PARTS, tache_droite, &c);
+    if (c.erreur) {
+        free(c.rep);
+        return -2;
+    }
+
+    /* Jackknife : la droite sans le point i se deduit des sommes totales (deux passes) */
+    total.w = (double)n;
+    total.sxx = m.sxx;
+    total.sxy = m.sxy;
+    for (passe = 0; passe < 2; passe++) {
+        for (i = 0; i < n; i++) {
+            Sommes s = total;
+            double t[2];
+            x = pts->type == POINTS_FLOAT ? pts->xf[i] : pts->xd[i];
+            y = pts->type == POINTS_FLOAT ? pts->yf[i] : pts->yd[i];
+            s.w -= 1.0;
+            s.sx -= x - m.mx;
+            s.sy -= y - m.my;
+            s.sxx -= (x - m.mx) * (x - m.mx);
+            s.sxy -= (x - m.mx) * (y - m.my);
+            if (droite(&s, m.mx, m.my, &t[0], &t[1]) != 0) continue;
+            for (j = 0; j < 2; j++) {
+                if (passe == 0) moy[j] += t[j];
+                else {
+                    double u = moy[j] - t[j];
+                    su2[j] += u * u;
+                    su3[j] += u * u * u;
+                }
+            }
+            if (passe == 0) valides++;
+        }
+        if (passe == 0 && valides) for (j = 0; j < 2; j++) moy[j] /= (double)valides;
+    }
+
+    code = conclure(r, est, c.rep, o->repliques, su2, su3, o->niveau);
+    free(c.rep);
+    return code;
+}
+
+/* ===== Exponentielle ===== */
+
+typedef struct {
+    const Points *pts;
+    const BootstrapOptions *o;
+    double a, b;
+    double *rep;                /* a des repliques puis b */
+    int erreur;
+} ExpCtx;
+
+static void tache_exp(void *ctx, size_t part) {
+    ExpCtx *c = (ExpCtx *)ctx;
+    int nb = c->o->repliques, r, debut = (int)(part * nb / BOOTSTRAP_PARTS), fin = (int)((part + 1) * nb / BOOTSTRAP_PARTS);
+    size_t n = c->pts->n, k, *compte;
+    LmOptions opt;
+    Points tire;
+
+    if (debut == fin) return;
+    memset(&tire, 0, sizeof(tire));
+    tire.n = n;
+    tire.type = POINTS_DOUBLE;
+    tire.xd = (double *)malloc(2 * n * sizeof(double));
+    compte = (size_t *)malloc(nombre_blocs(n) * sizeof(size_t));
+    if (!tire.xd || !compte) {
+        free(tire.xd);
+        free(compte);
+        c->erreur = 1;
+        return;
+    }
+    tire.yd = tire.xd + n;
+    lm_options_defaut(&opt);
+
+    for (r = debut; r < fin; r++) {
+        uint64_t cle = cle_replique(c->o->graine, r);
+        LmResultat res;
+
+        repartir(cle, n, compte);
+        k = 0;
+        BOOTSTRAP_PARCOURIR(cle, n, compte, {
+            tire.xd[k] = c->pts->type == POINTS_FLOAT ? c->pts->xf[i] : c->pts->xd[i];
+            tire.yd[k] = c->pts->type == POINTS_FLOAT ? c->pts->yf[i] : c->pts->yd[i];
+            k++;
+        });
+        /* appele depuis une tache, lm_exponentiel reste dans ce thread */
+        res = lm_exponentiel(&tire, c->a, c->b, &opt);
+        if (res.raison == LM_ECHEC || !isfinite(res.a) || !isfinite(res.b)) c->rep[r] = c->rep[nb + r] = NAN;
+        else {
+            c->rep[r] = res.a;
+            c->rep[nb + r] = res.b;
+        }
+    }
+    free(tire.xd);
+    free(compte);
+}
+
+int bootstrap_exponentiel(const Points *pts, double a, double b, const BootstrapOptions *o, BootstrapResultat *r) {
+    ExpCtx c;
+    double est[2] = { a, b }, su2[2] = { 0.0, 0.0 }, su3[2] = { 0.0, 0.0 };
+    double jj[3] = { 0.0, 0.0, 0.0 }, det = 0.0, x, y;
+    size_t n = pts->n, i;
+    int passe, j, code;
+
+    memset(r, 0, sizeof(*r));
+    if (n < 3 || o->repliques < 2) return -1;
+
+    c.pts = pts;
+    c.o = o;
+    c.a = a;
+    c.b = b;
+    c.erreur = 0;
+    c.rep = (double *)malloc(2 * (size_t)o->repliques * sizeof(double));
+    if (!c.rep) return -2;
+    pool_executer(pool_defaut(), BOOTSTRAP_PARTS, tache_exp, &c);
+    if (c.erreur) {
+        free(c.rep);
+        return -2;
+    }
+
+    /* Influence du point i : u_i = -(JᵀJ)⁻¹ J_iᵀ r_i, J_i = (e^{b x_i}, a x_i e^{b x_i}) */
+    for (passe = 0; passe < 2; passe++) {
+        for (i = 0; i < n; i++) {
+            double e, j0, j1, res;
+            x = pts->type == POINTS_FLOAT ? pts->xf[i] : pts->xd[i];
+            y = pts->type == POINTS_FLOAT ? pts->yf[i] : pts->yd[i];
+            e = exp(b * x);
+            j0 = e;
+            j1 = a * x * e;
+            if (passe == 0) {
+                jj[0] += j0 * j0;
+                jj[1] += j0 * j1;
+                jj[2] += j1 * j1;
+            } else {
+                double u[2];
+                res = a * e - y;
+                u[0] = -(jj[2] * j0 - jj[1] * j1) * res / det;
+                u[1] = -(jj[0] * j1 - jj[1] * j0) * res / det;
+                for (j = 0; j < 2; j++) {
+                    su2[j] += u[j] * u[j];
+                    su3[j] += u[j] * u[j] * u[j];
+                }
+            }
+        }
+        det = jj[0] * jj[2] - jj[1] * jj[1];
+        if (!(det > 0.0) || !isfinite(det)) break;
+    }
+
+    code = conclure(r, est, c.rep, o->repliques, su2, su3, o->niveau);
+    free(c.rep);
+    return code;
+}
+
+void bootstrap_afficher(const BootstrapResultat *r, const char *noms[2]) {
+    int j;
+
+    for (j = 0; j < 2; j++) {
+        const BootstrapIntervalle *p = &r->p[j];
+        printf("  %s = %.6f  (ecart-type %.6f, biais %+.6f)\n", noms[j], p->estimation, p->ecart_type, p->biais);
+        printf("    Intervalle percentile: [%.6f, %.6f]\n", p->percentile[0], p->percentile[1]);
+        printf("    Intervalle BCa:        [%.6f, %.6f]  (z0 = %.3f, acceleration = %.4f)\n",
+               p->bca[0], p->bca[1], p->z0, p->acceleration);
+    }
+    printf("  Repliques valides: %d\n", r->valides);
+}
@@ -0,0 +1,80 @@
+/*
+ * bootstrap.h
+ * Intervalles de confiance par bootstrap non parametrique des parametres
+ * de la droite des moindres carres (a0, a1) et de a * exp(b x) (a, b).
+ *
+ * La replique r tire n indices avec remise. Le tirage k est
+ * alea_melange(cle + k * gamma) (alea.h) : il ne depend que de
+ * (graine, r, k), sans etat partage, et les repliques sont reparties
+ * sur le pool (pool.h) en BOOTSTRAP_PARTS parts fixes ; les resultats
+ * ne dependent pas du nombre de threads.
+ * Des indices tires au hasard dans tout le tableau manqueraient le cache
+ * a chaque point : les n tirages sont d'abord repartis entre les blocs de
+ * BOOTSTRAP_BLOC points (seul le numero de bloc est retenu), puis chaque
+ * bloc tire ses indices en son sein, pendant qu'il est dans le cache. La
+ * loi des indices tires est la meme (multinomiale).
+ *
+ * Droite : une replique n'accumule que les cinq sommes suffisantes
+ * (poids, Σdx, Σdy, Σdx², Σdxdy, avec x et y decales de leurs moyennes)
+ * des points tires, sans recopier les donnees, puis resout en O(1).
+ * Exponentielle : les points tires sont rassembles dans un tampon par
+ * part et ajustes par Levenberg-Marquardt (lm.h) depuis la solution sur
+ * toutes les donnees, proche de celle de chaque replique.
+ *
+ * Intervalles de niveau 1 - 2α : percentile (quantiles α et 1 - α des
+ * repliques) et BCa (quantiles corriges du biais z0 et de l'acceleration).
+ * L'acceleration vient du jackknife exact pour la droite (les n droites
+ * sans un point se deduisent des sommes en O(n)) et des valeurs
+ * d'influence empiriques -(JᵀJ)⁻¹ J_iᵀ r_i pour l'exponentielle, dont le
+ * jackknife couterait n ajustements.
+ *
+ * REGRESSION_BOOTSTRAP=B fixe le nombre de repliques par defaut.
+ */
+
+#ifndef BOOTSTRAP_H
+#define BOOTSTRAP_H
+
+#include <stdint.h>
+#include "points.h"
+
+#define BOOTSTRAP_REPLIQUES 2000
+#define BOOTSTRAP_PARTS 64
+#define BOOTSTRAP_BLOC 4096         /* points par bloc de tirage */
+
+typedef struct {
+    int repliques;          /* B */
+    double niveau;          /* niveau de confiance, ex. 0.95 */
+    uint64_t graine;
+} BootstrapOptions;
+
+typedef struct {
+    double estimation;      /* sur toutes les donnees */
+    double ecart_type;      /* des repliques */
+    double biais;           /* moyenne des repliques - estimation */
+    double percentile[2];
+    double bca[2];          /* NaN si z0 est infini (toutes les repliques du meme cote) */
+    double z0, acceleration;
+} BootstrapIntervalle;
+
+typedef struct {
+    BootstrapIntervalle p[2];   /* (a0, a1) ou (a, b) */
+    int valides;                /* repliques ajustees (x non tous egaux, LM sans echec) */
+} BootstrapResultat;
+
+/* B = REGRESSION_BOOTSTRAP ou BOOTSTRAP_REPLIQUES, niveau 0.95, graine 1 */
+void bootstrap_options_defaut(BootstrapOptions *o);
+
+/*
+ * Droite des moindres carres. Retourne 0 ; -1 si les x sont tous egaux
+ * ou si moins de deux repliques sont valides ; -2 en cas d'allocation
+ * impossible.
+ */
+int bootstrap_droite(const Points *pts, const BootstrapOptions *o, BootstrapResultat *r);
+
+/* a * exp(b x), (a, b) ajuste sur toutes les donnees. Retourne comme bootstrap_droite. */
+int bootstrap_exponentiel(const Points *pts, double a, double b, const BootstrapOptions *o, BootstrapResultat *r);
+
+/* Estimation, ecart-type, biais et intervalles de chaque parametre, nommes noms[0] et noms[1] */
+void bootstrap_afficher(const BootstrapResultat *r, const char *noms[2]);
+
+#endif
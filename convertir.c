@@ -0,0 +1,87 @@
+/*
+ * convertir.c
+ * Conversion entre le format texte de donnees.txt et le format binaire
+ * en colonnes (binaire.h).
+ *
+ * Usage : ./convertir entree sortie.bin [float|double]   texte ou binaire -> binaire
+ *         ./convertir -t entree sortie.txt               binaire ou texte -> texte
+ * La precision par defaut est double ; avec -t, un fichier binaire est
+ * relu dans sa propre precision. Le texte est ecrit avec le moins de
+ * chiffres qui redonnent a la relecture la meme valeur double ou float
+ * (ecriture.h).
+ *
+ * Compilation : gcc -O2 convertir.c points.c lecture.c binaire.c ecriture.c -o convertir -lm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "points.h"
+#include "lecture.h"
+#include "binaire.h"
+#include "ecriture.h"
+
+static void error_and_exit(const char *msg) {
+    fprintf(stderr, "%s\n", msg);
+    exit(EXIT_FAILURE);
+}
+
+static int ecrire_texte(const char *fichier, const Points *pts) {
+    Ecriture e;
+    size_t i;
+
+    if (ecriture_ouvrir(&e, fichier, 0) != 0) return -1;
+    ecriture_format(&e, "%zu\n", pts->n);
+    for (i = 0; i < pts->n; i++) {
+        double v[2];
+        if (pts->type == POINTS_FLOAT) {
+            v[0] = pts->xf[i];
+            v[1] = pts->yf[i];
+            ecriture_ligne(&e, v, 2, ", ", ECRITURE_COURTF);
+        } else {
+            v[0] = pts->xd[i];
+            v[1] = pts->yd[i];
+            ecriture_ligne(&e, v, 2, ", ", ECRITURE_COURT);
+        }
+    }
+    return ecriture_fermer(&e);
+}
+
+int main(int argc, char **argv) {
+    int vers_texte = argc > 1 && strcmp(argv[1], "-t") == 0;
+    const char *entree, *sortie;
+    PointsType type = POINTS_DOUBLE;
+    Points pts;
+    LectureInfo info;
+    LectureCode code;
+
+    if (vers_texte ? argc != 4 : argc < 3 || argc > 4) {
+        fprintf(stderr, "Usage : %s entree sortie.bin [float|double]\n"
+                        "        %s -t entree sortie.txt\n", argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+    entree = argv[1 + vers_texte];
+    sortie = argv[2 + vers_texte];
+    if (!vers_texte && argc == 4) {
+        if (strcmp(argv[3], "float") == 0) type = POINTS_FLOAT;
+        else if (strcmp(argv[3], "double") != 0) error_and_exit("Precision attendue : float ou double");
+    }
+    if (vers_texte) binaire_type(entree, &type);     /* texte : reste en double */
+
+    code = lecture_points(entree, &pts, type, &info);
+    if (code != LECTURE_OK) {
+        fprintf(stderr, "%s (ligne %zu)\n", entree, info.ligne);
+        error_and_exit(lecture_message(code));
+    }
+    printf("Lecture: %zu points, %.3f Mo en %.3f s (%.1f Mo/s)\n", pts.n,
+           info.octets / (1024.0 * 1024.0), info.secondes, lecture_debit(&info));
+
+    if ((vers_texte ? ecrire_texte(sortie, &pts) : binaire_ecrire(sortie, &pts)) != 0) {
+        perror(sortie);
+        points_free(&pts);
+        return EXIT_FAILURE;
+    }
+    printf("Ecrit: %s (%s)\n", sortie, vers_texte ? "texte" : type == POINTS_FLOAT ? "binaire float" : "binaire double");
+    points_free(&pts);
+    return 0;
+}
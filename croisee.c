@@ -0,0 +1,349 @@
+/*
+ * croisee.c
+ * Validation croisee par plis (voir croisee.h).
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "croisee.h"
+#include "pool.h"
+#include "moments.h"
+#include "expvec.h"
+#include "lm.h"
+#include "alea.h"
+
+/* ===== Plis ===== */
+
+typedef struct {
+    size_t n, k;
+    double *x, *y;          /* points ranges par pli */
+    size_t *debut;          /* pli f : [debut[f], debut[f + 1]) ; NULL en leave-one-out (pli f = point f) */
+} Plis;
+
+static void bornes(const Plis *p, size_t f, size_t *debut, size_t *fin) {
+    if (p->debut) {
+        *debut = p->debut[f];
+        *fin = p->debut[f + 1];
+    } else {
+        *debut = f;
+        *fin = f + 1;
+    }
+}
+
+/* Plis des k points du groupe g : permutation de Fisher-Yates tiree par compteur */
+static void permutation(uint64_t graine, size_t g, size_t k, size_t *ordre) {
+    uint64_t cle = alea_melange(graine ^ alea_melange((uint64_t)g));
+    size_t j;
+
+    for (j = 0; j < k; j++) ordre[j] = j;
+    for (j = k - 1; j > 0; j--) {
+        size_t r = alea_indice(alea_melange(cle + j * ALEA_GAMMA), j + 1);
+        size_t t = ordre[j];
+        ordre[j] = ordre[r];
+        ordre[r] = t;
+    }
+}
+
+/*
+ * Recopie les points en double, ranges par pli. Chaque groupe complet
+ * donne un point a chaque pli : le point du groupe g dans le pli f va en
+ * debut[f] + g, sans compteur. Seul le dernier groupe, partiel, fixe
+ * quels plis ont un point de plus.
+ */
+static int ranger(const Points *pts, size_t k, uint64_t graine, Plis *p) {
+    size_t n = pts->n, complets = n / k, reste = n % k, g, j, f, *ordre;
+
+    p->n = n;
+    p->k = k;
+    p->debut = NULL;
+    p->x = (double *)malloc(2 * n * sizeof(double));
+    if (!p->x) return -1;
+    p->y = p->x + n;
+
+    if (k == n) {
+        for (j = 0; j < n; j++) {
+            p->x[j] = pts->type == POINTS_FLOAT ? pts->xf[j] : pts->xd[j];
+            p->y[j] = pts->type == POINTS_FLOAT ? pts->yf[j] : pts->yd[j];
+        }
+        return 0;
+    }
+
+    p->debut = (size_t *)malloc((k + 1) * sizeof(size_t));
+    ordre = (size_t *)malloc(k * sizeof(size_t));
+    if (!p->debut || !ordre) {
+        free(p->x);
+        free(p->debut);
+        free(ordre);
+        return -1;
+    }
+    for (f = 0; f <= k; f++) p->debut[f] = f == 0 ? 0 : complets;
+    if (reste) {
+        permutation(graine, complets, k, ordre);
+        for (j = 0; j < reste; j++) p->debut[ordre[j] + 1]++;
+    }
+    for (f = 1; f <= k; f++) p->debut[f] += p->debut[f - 1];
+
+    for (g = 0; g * k < n; g++) {
+        size_t taille = n - g * k < k ? n - g * k : k;
+        permutation(graine, g, k, ordre);
+        for (j = 0; j < taille; j++) {
+            size_t i = g * k + j, dest = p->debut[ordre[j]] + g;
+            p->x[dest] = pts->type == POINTS_FLOAT ? pts->xf[i] : pts->xd[i];
+            p->y[dest] = pts->type == POINTS_FLOAT ? pts->yf[i] : pts->yd[i];
+        }
+    }
+    free(ordre);
+    return 0;
+}
+
+static void liberer(Plis *p) {
+    free(p->x);
+    free(p->debut);
+}
+
+/* Premier et dernier pli (exclu) de la part, sur parts parts */
+static void plis_part(size_t k, size_t parts, size_t part, size_t *debut, size_t *fin) {
+    *debut = part * k / parts;
+    *fin = (part + 1) * k / parts;
+}
+
+static size_t nombre_parts(size_t k) {
+    return k < CROISEE_PARTS ? k : CROISEE_PARTS;
+}
+
+/* ===== Droite ===== */
+
+typedef struct {
+    const Plis *p;
+    Moments *m;             /* moments de chaque pli */
+} MomentsCtx;
+
+static void tache_moments(void *ctx, size_t part) {
+    MomentsCtx *c = (MomentsCtx *)ctx;
+    size_t f, debut, fin, d, e;
+
+    plis_part(c->p->k, nombre_parts(c->p->k), part, &debut, &fin);
+    for (f = debut; f < fin; f++) {
+        Points pli;
+
+        bornes(c->p, f, &d, &e);
+        memset(&pli, 0, sizeof(pli));
+        pli.n = e - d;
+        pli.type = POINTS_DOUBLE;
+        pli.xd = c->p->x + d;
+        pli.yd = c->p->y + d;
+        moments_init(&c->m[f]);
+        moments_ajouter_points(&c->m[f], &pli);
+    }
+}
+
+typedef struct {
+    const Points *pts;
+    Moments total;
+} LooCtx;
+
+/* Leave-one-out : le pli d'un point n'a que lui, ses moments s'ecrivent directement */
+static void bloc_loo(void *ctx, size_t debut, size_t fin, double *sommes) {
+    const LooCtx *c = (const LooCtx *)ctx;
+    size_t i;
+
+    for (i = debut; i < fin; i++) {
+        Moments t = c->total, point;
+        double a0, a1, e;
+
+        moments_init(&point);
+        point.n = 1.0;
+        point.mx = c->pts->type == POINTS_FLOAT ? c->pts->xf[i] : c->pts->xd[i];
+        point.my = c->pts->type == POINTS_FLOAT ? c->pts->yf[i] : c->pts->yd[i];
+        moments_retrait(&t, &point);
+        if (moments_droite(&t, &a0, &a1) != 0) sommes[1] += 1.0;
+        else {
+            e = a0 + a1 * point.mx - point.my;
+            sommes[0] += e * e;
+        }
+    }
+}
+
+int croisee_droite(const Points *pts, size_t plis, uint64_t graine, CroiseeResultat *r) {
+    size_t n = pts->n, k = plis ? plis : n, f;
+    Moments total;
+    double a0, a1, sse = 0.0;
+
+    memset(r, 0, sizeof(*r));
+    if (n < 3 || k < 2 || k > n) return -1;
+    r->plis = k;
+
+    if (k == n) {
+        LooCtx c;
+        double s[2];
+
+        c.pts = pts;
+        moments_init(&c.total);
+        moments_ajouter_points(&c.total, pts);
+        if (moments_droite(&c.total, &a0, &a1) != 0) return -1;
+        r->rmse_ajustement = sqrt(2.0 * moments_cout(&c.total, a0, a1));
+        pool_reduire(pool_defaut(), n, 2, bloc_loo, &c, s);
+        r->echecs = (size_t)s[1];
+        r->predits = n - r->echecs;
+        sse = s[0];
+    } else {
+        Plis p;
+        MomentsCtx c;
+
+        if (ranger(pts, k, graine, &p) != 0) return -2;
+        c.p = &p;
+        c.m = (Moments *)malloc(k * sizeof(Moments));
+        if (!c.m) {
+            liberer(&p);
+            return -2;
+        }
+        pool_executer(pool_defaut(), nombre_parts(k), tache_moments, &c);
+        liberer(&p);
+
+        moments_init(&total);
+        for (f = 0; f < k; f++) moments_fusion(&total, &c.m[f]);
+        if (moments_droite(&total, &a0, &a1) != 0) {
+            free(c.m);
+            return -1;
+        }
+        r->rmse_ajustement = sqrt(2.0 * moments_cout(&total, a0, a1));
+
+        /* apprentissage du pli f = total \ pli f ; Σ r² sur le pli = 2 n_f J */
+        for (f = 0; f < k; f++) {
+            Moments t = total;
+            double b0, b1;
+
+            moments_retrait(&t, &c.m[f]);
+            if (moments_droite(&t, &b0, &b1) != 0) r->echecs++;
+            else {
+                sse += 2.0 * c.m[f].n * moments_cout(&c.m[f], b0, b1);
+                r->predits += (size_t)c.m[f].n;
+            }
+        }
+        free(c.m);
+    }
+
+    if (r->predits == 0) return -1;
+    r->rmse = sqrt(sse / (double)r->predits);
+    return 0;
+}
+
+/* ===== Exponentielle ===== */
+
+/* Donnees privees du pli [debut, fin) : l'indice j du complement est j ou j + (fin - debut) */
+typedef struct {
+    const Plis *p;
+    size_t debut, fin;
+    double a, b;
+} Complement;
+
+static void normales_complement(void *ctx, size_t debut, size_t fin, double *sommes) {
+    const Complement *c = (const Complement *)ctx;
+    size_t trou = c->fin - c->debut, coupe;
+    double s[6];
+    int j;
+
+    if (debut < c->debut) {
+        coupe = fin < c->debut ? fin : c->debut;
+        expvec_normales(c->p->x + debut, c->p->y + debut, coupe - debut, c->a, c->b, s);
+        for (j = 0; j < 6; j++) sommes[j] += s[j];
+        debut = coupe;
+    }
+    if (debut < fin) {
+        expvec_normales(c->p->x + debut + trou, c->p->y + debut + trou, fin - debut, c->a, c->b, s);
+        for (j = 0; j < 6; j++) sommes[j] += s[j];
+    }
+}
+
+/* Sommes de expvec_normales sur le complement, normalisees (lm_minimiser) */
+static int evaluer_complement(void *ctx, double a, double b, double s[6]) {
+    Complement *c = (Complement *)ctx;
+    size_t m = c->p->n - (c->fin - c->debut);
+    int j;
+
+    c->a = a;
+    c->b = b;
+    pool_reduire(pool_defaut(), m, 6, normales_complement, c, s);
+    for (j = 0; j < 6; j++) s[j] /= (double)m;
+    return 0;
+}
+
+typedef struct {
+    const Plis *p;
+    double a, b;
+    double sse[CROISEE_PARTS];
+    size_t predits[CROISEE_PARTS], echecs[CROISEE_PARTS];
+    long evaluations[CROISEE_PARTS];
+} ExpCtx;
+
+static void tache_exp(void *ctx, size_t part) {
+    ExpCtx *c = (ExpCtx *)ctx;
+    size_t f, debut, fin;
+    LmOptions opt;
+
+    lm_options_defaut(&opt);
+    plis_part(c->p->k, nombre_parts(c->p->k), part, &debut, &fin);
+    c->sse[part] = 0.0;
+    c->predits[part] = c->echecs[part] = 0;
+    c->evaluations[part] = 0;
+    for (f = debut; f < fin; f++) {
+        Complement cp;
+        LmResultat res;
+        double s[3];
+
+        cp.p = c->p;
+        bornes(c->p, f, &cp.debut, &cp.fin);
+        res = lm_minimiser(evaluer_complement, &cp, c->a, c->b, &opt);
+        c->evaluations[part] += res.evaluations;
+        if (res.raison != LM_ECHEC && isfinite(res.a) && isfinite(res.b)) {
+            expvec_sommes(c->p->x + cp.debut, c->p->y + cp.debut, cp.fin - cp.debut, res.a, res.b, s);
+            if (isfinite(s[0])) {
+                c->sse[part] += s[0];
+                c->predits[part] += cp.fin - cp.debut;
+                continue;
+            }
+        }
+        c->echecs[part]++;
+    }
+}
+
+int croisee_exponentiel(const Points *pts, double a, double b, size_t plis, uint64_t graine, CroiseeResultat *r) {
+    size_t n = pts->n, k = plis ? plis : n, parts, part;
+    double sse = 0.0, s[3];
+    ExpCtx *c;
+    Plis p;
+
+    memset(r, 0, sizeof(*r));
+    if (n < 3 || k < 2 || k > n) return -1;
+    r->plis = k;
+
+    c = (ExpCtx *)malloc(sizeof(ExpCtx));
+    if (!c || ranger(pts, k, graine, &p) != 0) {
+        free(c);
+        return -2;
+    }
+    c->p = &p;
+    c->a = a;
+    c->b = b;
+    expvec_sommes(p.x, p.y, n, a, b, s);
+    r->rmse_ajustement = sqrt(s[0] / (double)n);
+
+    /* peu de plis : en sequence, chaque evaluation repartie sur le pool */
+    parts = nombre_parts(k);
+    if (k >= (size_t)pool_threads(pool_defaut())) pool_executer(pool_defaut(), parts, tache_exp, c);
+    else for (part = 0; part < parts; part++) tache_exp(c, part);
+
+    for (part = 0; part < parts; part++) {
+        sse += c->sse[part];
+        r->predits += c->predits[part];
+        r->echecs += c->echecs[part];
+        r->evaluations += c->evaluations[part];
+    }
+    free(c);
+    liberer(&p);
+
+    if (r->predits == 0) return -1;
+    r->rmse = sqrt(sse / (double)r->predits);
+    return 0;
+}
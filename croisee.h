@@ -0,0 +1,57 @@
+/*
+ * croisee.h
+ * Validation croisee des deux modeles de la serie : droite des moindres
+ * carres (moinCarre.c) et a * exp(b x) (gradient.c). Chaque point est
+ * predit par le modele ajuste sans son pli ; l'erreur hors echantillon
+ * permet de choisir le modele sans decouper les fichiers a la main.
+ *
+ * k plis : chaque groupe de k points consecutifs donne un point a chaque
+ * pli, dans un ordre tire au hasard par groupe (alea.h, comme
+ * bootstrap.c) ; les plis ont n/k points a un pres et couvrent toute
+ * l'etendue d'un fichier trie selon x. Les points sont recopies une fois,
+ * ranges par pli. Leave-one-out : k = n, un point par pli.
+ *
+ * Droite : les moments de chaque pli (moments.h) sont accumules une fois,
+ * leur fusion donne ceux de toutes les donnees, et les moments
+ * d'apprentissage du pli f s'en deduisent par moments_retrait ; l'erreur
+ * sur le pli se lit sur ses moments (moments_cout). O(n + k) en tout,
+ * leave-one-out compris.
+ * Exponentielle : chaque pli est ajuste par Levenberg-Marquardt (lm.h)
+ * depuis la solution (a, b) sur toutes les donnees, proche de celle du
+ * pli ; chaque evaluation parcourt les donnees privees du pli sans les
+ * recopier. Les plis sont repartis sur le pool s'il y en a au moins
+ * autant que de threads, sinon chaque evaluation l'est. Le leave-one-out
+ * fait n ajustements : O(n²), pour de petits fichiers.
+ *
+ * Les resultats ne dependent pas du nombre de threads.
+ */
+
+#ifndef CROISEE_H
+#define CROISEE_H
+
+#include <stdint.h>
+#include "points.h"
+
+#define CROISEE_PLIS 10
+#define CROISEE_PARTS 64            /* parts fixes des plis sur le pool */
+
+typedef struct {
+    size_t plis;            /* k effectif (n pour leave-one-out) */
+    size_t echecs;          /* plis non ajustes (x constants, lm en echec), exclus du RMSE */
+    size_t predits;         /* points predits hors echantillon */
+    double rmse;            /* sqrt(Σ (y_i - ŷ_i)² / predits), ŷ_i ajuste sans le pli de i */
+    double rmse_ajustement; /* RMSE de l'ajustement sur toutes les donnees, pour comparer */
+    long evaluations;       /* passes sur les donnees d'apprentissage (exponentielle) */
+} CroiseeResultat;
+
+/*
+ * plis : 2 a n, ou 0 pour leave-one-out. Retournent 0 ; -1 si plis est
+ * hors limites, si les x sont tous egaux (droite) ou si aucun pli n'a pu
+ * etre ajuste ; -2 en cas d'allocation impossible.
+ */
+int croisee_droite(const Points *pts, size_t plis, uint64_t graine, CroiseeResultat *r);
+
+/* (a, b) ajuste sur toutes les donnees. Retourne comme croisee_droite. */
+int croisee_exponentiel(const Points *pts, double a, double b, size_t plis, uint64_t graine, CroiseeResultat *r);
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * departs.c
+ * Departs multiples en parallele pour a*exp(b x) (voir departs.h).
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "departs.h"
+#include "pool.h"
+#include "expvec.h"
+#include "alea.h"
+#include "ajuste.h"
+
+#define DEPARTS_BLOC 256
+#define MEME_MINIMUM 1e-2       /* ecart relatif en a et en b */
+
+typedef struct {
+    double a, b, cout;
+    int iterations, evaluations;
+    int initialise;
+    int actif;
+    int abandonne;
+} Depart;
+
+typedef struct {
+    const Points *pts;
+    const DepartsOptions *opt;
+    Depart *departs;
+} Lot;
+
+void departs_options_defaut(DepartsOptions *o, int k, int lm) {
+    o->k = k;
+    o->tirage = DEPARTS_GRILLE;
+    o->graine = 1;
+    o->b_max = 0.0;
+    o->lm = lm;
+    optim_options_defaut(&o->descente, OPTIM_FIXE, 0.01, 0.001, 200000);
+    lm_options_defaut(&o->options_lm);
+    o->tranche = lm ? 5 : 1000;
+    o->marge = 1.0;
+}
+
+/* a optimal a b fixe : Σ y e^{bx} / Σ e^{2bx} */
+static double a_optimal(const Points *pts, double b) {
+    double bx[DEPARTS_BLOC], e[DEPARTS_BLOC];
+    double sye = 0.0, see = 0.0, a;
+    size_t i, k;
+
+    for (i = 0; i < pts->n; i += DEPARTS_BLOC) {
+        size_t nb = pts->n - i < DEPARTS_BLOC ? pts->n - i : DEPARTS_BLOC;
+        for (k = 0; k < nb; k++) bx[k] = b * pts->xd[i + k];
+        expvec_exp(bx, e, nb);
+        for (k = 0; k < nb; k++) {
+            sye += pts->yd[i + k] * e[k];
+            see += e[k] * e[k];
+        }
+    }
+    a = sye / see;
+    return isfinite(a) ? a : 1.0;
+}
+
+/* Une tranche d'iterations du depart t */
+static void tache_depart(void *ctx, size_t t) {
+    const Lot *l = (const Lot *)ctx;
+    const DepartsOptions *o = l->opt;
+    Depart *d = &l->departs[t];
+
+    if (!d->actif) return;
+    if (!d->initialise) {
+        d->a = a_optimal(l->pts, d->b);
+        d->initialise = 1;
+    }
+
+    if (o->lm) {
+        LmOptions lo = o->options_lm;
+        LmResultat r;
+        int reste = lo.max_iterations - d->iterations;
+
+        lo.max_iterations = reste < o->tranche ? reste : o->tranche;
+        lo.trace = NULL;
+        r = ajuste_exp_lm(l->pts->xd, l->pts->yd, l->pts->n, d->a, d->b, &lo);
+        d->a = r.a;
+        d->b = r.b;
+        d->cout = r.cout;
+        d->iterations += r.iterations;
+        d->evaluations += r.evaluations;
+        if (r.raison != LM_MAX_ITERATIONS || d->iterations >= o->options_lm.max_iterations) d->actif = 0;
+    } else {
+        OptimOptions oo = o->descente;
+        OptimResultat r;
+        int reste = oo.max_iterations - d->iterations;
+
+        oo.max_iterations = reste < o->tranche ? reste : o->tranche;
+        oo.suivi = NULL;
+        oo.trace = NULL;
+        r = ajuste_exp_descente(l->pts->xd, l->pts->yd, l->pts->n, &d->a, &d->b, &oo);
+        d->cout = r.cout;
+        d->iterations += r.iterations;
+        d->evaluations += r.evaluations;
+        if (r.raison != OPTIM_MAX_ITERATIONS || d->iterations >= o->descente.max_iterations) d->actif = 0;
+    }
+    if (!isfinite(d->cout)) {
+        d->actif = 0;
+        d->abandonne = 1;
+    }
+}
+
+static int proche(double u, double v) {
+    return fabs(u - v) <= MEME_MINIMUM * (fabs(v) + MEME_MINIMUM);
+}
+
+static int par_cout(const void *p, const void *q) {
+    const Depart *u = (const Depart *)p, *v = (const Depart *)q;
+    if (u->abandonne != v->abandonne) return u->abandonne - v->abandonne;
+    return (u->cout > v->cout) - (u->cout < v->cout);
+}
+
+int departs_exponentiel(const Points *pts, const DepartsOptions *o, DepartsResultat *r) {
+    Lot lot;
+    Depart *d;
+    double xmin, xmax, b_max;
+    size_t i;
+    int k, actifs;
+
+    if (o->k < 1 || o->k > DEPARTS_MAX || pts->n == 0) return -1;
+    d = calloc((size_t)o->k, sizeof(*d));
+    if (!d) return -1;
+    memset(r, 0, sizeof(*r));
+
+    /* valeurs de b des departs */
+    xmin = xmax = pts->xd[0];
+    for (i = 1; i < pts->n; i++) {
+        if (pts->xd[i] < xmin) xmin = pts->xd[i];
+        if (pts->xd[i] > xmax) xmax = pts->xd[i];
+    }
+    b_max = o->b_max > 0.0 ? o->b_max : xmax > xmin ? 5.0 / (xmax - xmin) : 1.0;
+    for (k = 0; k < o->k; k++) {
+        double u = o->tirage == DEPARTS_GRILLE ? (k + 0.5) / o->k
+                 : alea_uniforme(alea_melange(o->graine ^ alea_melange((uint64_t)k)));
+        d[k].b = -b_max + 2.0 * b_max * u;
+        d[k].actif = 1;
+    }
+
+    lot.pts = pts;
+    lot.opt = o;
+    lot.departs = d;
+    do {
+        double meilleur = INFINITY;
+
+        pool_executer(pool_defaut(), (size_t)o->k, tache_depart, &lot);
+        r->controles++;
+
+        for (k = 0; k < o->k; k++)
+            if (!d[k].abandonne && d[k].cout < meilleur) meilleur = d[k].cout;
+        actifs = 0;
+        for (k = 0; k < o->k; k++) {
+            if (!d[k].actif) continue;
+            if (d[k].cout > (1.0 + o->marge) * meilleur) {
+                d[k].actif = 0;
+                d[k].abandonne = 1;
+            } else {
+                actifs++;
+            }
+        }
+    } while (actifs > 0);
+
+    for (k = 0; k < o->k; k++) {
+        r->evaluations += d[k].evaluations;
+        if (d[k].abandonne) r->abandonnes++;
+    }
+
+    /* minima distincts parmi les departs menes a terme, par cout croissant */
+    qsort(d, (size_t)o->k, sizeof(*d), par_cout);
+    r->a = d[0].a;
+    r->b = d[0].b;
+    r->cout = d[0].cout;
+    r->iterations = d[0].iterations;
+    for (k = 0; k < o->k && !d[k].abandonne; k++) {
+        int m;
+        for (m = 0; m < r->nminima; m++)
+            if (proche(d[k].a, r->minima[m].a) && proche(d[k].b, r->minima[m].b)) break;
+        if (m == r->nminima) {
+            r->minima[m].a = d[k].a;
+            r->minima[m].b = d[k].b;
+            r->minima[m].cout = d[k].cout;
+            r->nminima++;
+        }
+        r->minima[m].departs++;
+    }
+
+    free(d);
+    return 0;
+}
+
+int departs_nombre(const char *texte, int *k) {
+    char *fin;
+    long v;
+
+    errno = 0;
+    v = strtol(texte, &fin, 10);
+    if (fin == texte || *fin != '\0' || errno != 0 || v < 1 || v > DEPARTS_MAX) return -1;
+    *k = (int)v;
+    return 0;
+}
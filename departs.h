@@ -0,0 +1,70 @@
+/*
+ * departs.h
+ * Departs multiples pour f(x) = a * exp(b x). Le cout n'est pas convexe
+ * en b : un seul depart peut s'arreter dans un minimum local ou sur le
+ * plateau b -> -inf (f presque nulle). K ajustements partent de valeurs
+ * de b reparties (grille reguliere ou tirage pseudo-aleatoire) ; pour
+ * chaque b, a est la valeur optimale a b fixe, Σ y e^{bx} / Σ e^{2bx}
+ * (le cout est quadratique en a).
+ *
+ * Les departs avancent par tranches d'iterations, repartis sur le pool
+ * de threads (un depart par tache, calculs internes sequentiels). A chaque
+ * point de controle, un depart dont le cout depasse (1 + marge) fois le
+ * meilleur cout est abandonne. Avec K coeurs, le temps est donc voisin de
+ * celui d'un seul ajustement. L'etat interne du solveur (λ de LM, vitesse
+ * ou moments d'optim) repart de sa valeur initiale a chaque tranche.
+ * Avec la descente, le critere d'arret sur le deplacement peut arreter un
+ * depart loin d'un minimum : ses "minima" sont alors des points d'arret,
+ * et LM donne une image plus fidele des minima locaux.
+ */
+
+#ifndef DEPARTS_H
+#define DEPARTS_H
+
+#include <stdint.h>
+#include "points.h"
+#include "optim.h"
+#include "lm.h"
+
+#define DEPARTS_MAX 256
+
+typedef enum { DEPARTS_GRILLE, DEPARTS_ALEATOIRE } DepartsTirage;
+
+typedef struct {
+    int k;                  /* nombre de departs (<= DEPARTS_MAX) */
+    DepartsTirage tirage;
+    uint64_t graine;
+    double b_max;           /* b dans [-b_max, b_max] ; 0 : 5 / (xmax - xmin) */
+    int lm;                 /* 1 : Levenberg-Marquardt, 0 : descente du gradient */
+    OptimOptions descente;  /* methode, pas, seuil et budget total de la descente */
+    LmOptions options_lm;
+    int tranche;            /* iterations entre deux points de controle */
+    double marge;
+} DepartsOptions;
+
+/* Minimum atteint par un ou plusieurs departs */
+typedef struct {
+    double a, b, cout;
+    int departs;
+} DepartsMinimum;
+
+typedef struct {
+    double a, b, cout;      /* meilleur ajustement */
+    int iterations;         /* du meilleur depart */
+    int evaluations;        /* tous departs confondus */
+    int controles;          /* points de controle passes */
+    int abandonnes;
+    int nminima;            /* minima distincts, par cout croissant */
+    DepartsMinimum minima[DEPARTS_MAX];
+} DepartsResultat;
+
+/* k departs en grille ; descente a pas fixe de gauchy_exp.c si lm = 0 */
+void departs_options_defaut(DepartsOptions *o, int k, int lm);
+
+/* Points en double precision ; retourne -1 si o->k est hors de [1, DEPARTS_MAX] ou n = 0 */
+int departs_exponentiel(const Points *pts, const DepartsOptions *o, DepartsResultat *r);
+
+/* Lit le K de "multi=K" (entier decimal seul) ; retourne 0 si 1 <= K <= DEPARTS_MAX, -1 sinon */
+int departs_nombre(const char *texte, int *k);
+
+#endif
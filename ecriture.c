@@ -0,0 +1,380 @@
+/*
+ * ecriture.c
+ * Tampon d'ecriture et conversion des nombres en texte (voir ecriture.h).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ecriture.h"
+
+typedef unsigned __int128 u128;
+
+#define NOMBRE_MAX 64               /* caracteres d'un nombre converti */
+
+int ecriture_ouvrir(Ecriture *e, const char *fichier, int binaire) {
+    memset(e, 0, sizeof(*e));
+    e->tampon = malloc(ECRITURE_TAMPON);
+    if (!e->tampon) return -1;
+    e->binaire = binaire;
+    if (fichier) {
+        e->fd = open(fichier, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (e->fd < 0) {
+            free(e->tampon);
+            e->tampon = NULL;
+            return -1;
+        }
+    } else {
+        fflush(stdout);
+        e->fd = STDOUT_FILENO;
+    }
+    return 0;
+}
+
+int ecriture_env(void) {
+    const char *mode = getenv("REGRESSION_SORTIE");
+    return mode && strcmp(mode, "binaire") == 0;
+}
+
+void ecriture_vider(Ecriture *e) {
+    size_t fait = 0;
+
+    while (fait < e->utilise) {
+        ssize_t k = write(e->fd, e->tampon + fait, e->utilise - fait);
+        if (k < 0) {
+            if (errno == EINTR) continue;
+            e->erreur = 1;
+            break;
+        }
+        fait += (size_t)k;
+    }
+    e->utilise = 0;
+}
+
+int ecriture_fermer(Ecriture *e) {
+    int erreur;
+
+    ecriture_vider(e);
+    if (e->fd != STDOUT_FILENO && close(e->fd) != 0) e->erreur = 1;
+    erreur = e->erreur;
+    free(e->tampon);
+    memset(e, 0, sizeof(*e));
+    return erreur ? -1 : 0;
+}
+
+/* Place pour au moins k octets dans le tampon (k <= ECRITURE_TAMPON) */
+static char *reserver(Ecriture *e, size_t k) {
+    if (e->utilise + k > ECRITURE_TAMPON) ecriture_vider(e);
+    return e->tampon + e->utilise;
+}
+
+static void ajouter(Ecriture *e, const char *s, size_t k) {
+    while (k > 0) {
+        size_t bloc = k < ECRITURE_TAMPON ? k : ECRITURE_TAMPON;
+        memcpy(reserver(e, bloc), s, bloc);
+        e->utilise += bloc;
+        s += bloc;
+        k -= bloc;
+    }
+}
+
+void ecriture_texte(Ecriture *e, const char *s) {
+    ajouter(e, s, strlen(s));
+}
+
+void ecriture_format(Ecriture *e, const char *format, ...) {
+    char ligne[1024];
+    va_list args;
+    int k;
+
+    va_start(args, format);
+    k = vsnprintf(ligne, sizeof(ligne), format, args);
+    va_end(args);
+    if (k < 0) return;
+    if ((size_t)k < sizeof(ligne)) {
+        ajouter(e, ligne, (size_t)k);
+    } else {
+        char *long_texte = malloc((size_t)k + 1);
+        if (!long_texte) {
+            e->erreur = 1;
+            return;
+        }
+        va_start(args, format);
+        vsnprintf(long_texte, (size_t)k + 1, format, args);
+        va_end(args);
+        ajouter(e, long_texte, (size_t)k);
+        free(long_texte);
+    }
+}
+
+/* ===== Decimales fixes ===== */
+
+/* Chiffres de q < 10^36 dans s, au moins `largeur` (zeros a gauche) ; retourne leur nombre */
+static int entier(char *s, u128 q, int largeur) {
+    char tmp[40];
+    int n = 0, k;
+    uint64_t bas = (uint64_t)(q % 1000000000000000000ull);
+    uint64_t haut = (uint64_t)(q / 1000000000000000000ull);
+
+    /* deux moities de 18 chiffres : divisions sur 64 bits */
+    for (k = 0; k < 18 && (bas || haut || n < largeur); k++, n++) {
+        tmp[n] = (char)('0' + bas % 10);
+        bas /= 10;
+    }
+    while (haut || n < largeur) {
+        tmp[n++] = (char)('0' + haut % 10);
+        haut /= 10;
+    }
+    if (n == 0) tmp[n++] = '0';
+    for (k = 0; k < n; k++) s[k] = tmp[n - 1 - k];
+    return n;
+}
+
+/* Comme snprintf("%.*f", d, v) pour |v| < 1e17 et d <= 17 ; retourne -1 hors de cette plage */
+static int fixe(char *s, double v, int d) {
+    static const uint64_t puissances[18] = {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+        100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+        10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+        100000000000000000ull
+    };
+    u128 n, q;
+    uint64_t f;
+    int e, k = 0, chiffres;
+    char t[NOMBRE_MAX];
+
+    if (!isfinite(v) || d > 17 || fabs(v) >= 1e17) return -1;
+    if (signbit(v)) s[k++] = '-';
+    /* |v| = f 2^e exactement, f < 2^53 */
+    f = (uint64_t)ldexp(frexp(fabs(v), &e), 53);
+    e -= 53;
+    n = (u128)f * puissances[d];            /* < 2^110 */
+    if (e >= 0) {
+        q = n << e;                         /* |v| 10^d < 1e34 */
+    } else if (e < -120) {
+        q = 0;                              /* moins d'une demi-unite */
+    } else {
+        u128 reste = n & (((u128)1 << -e) - 1), moitie = (u128)1 << (-e - 1);
+        q = n >> -e;
+        if (reste > moitie || (reste == moitie && (q & 1))) q++;
+    }
+    chiffres = entier(t, q, d + 1);
+    memcpy(s + k, t, (size_t)(chiffres - d));
+    k += chiffres - d;
+    if (d > 0) {
+        s[k++] = '.';
+        memcpy(s + k, t + chiffres - d, (size_t)d);
+        k += d;
+    }
+    return k;
+}
+
+/* ===== Ecriture la plus courte ===== */
+
+/*
+ * Chiffres les plus courts de v = f 2^e > 0 (f < 2^p, e_min : exposant
+ * des denormaux) selon Burger et Dybvig : v = 0.c1c2... 10^*k. Retourne le
+ * nombre de chiffres, ou 0 si e sort de [-118, 60], plage ou tous les
+ * entiers du calcul tiennent sur 128 bits.
+ */
+static int chiffres_courts(uint64_t f, int e, int p, int e_min, char *c, int *k) {
+    u128 r, s, mp, mm, dix = 1;
+    int pair = (f & 1) == 0, n = 0, kk, j;
+    int limite = f == (1ull << (p - 1)) && e > e_min;   /* ecart inferieur moitie moindre */
+
+    if (e < -118 || e > 60) return 0;
+    if (e >= 0) {
+        r = (u128)f << (e + 1 + limite);
+        s = (u128)2 << limite;
+        mp = (u128)1 << (e + limite);
+        mm = (u128)1 << e;
+    } else {
+        r = (u128)f << (1 + limite);
+        s = (u128)1 << (1 + limite - e);
+        mp = (u128)1 << limite;
+        mm = 1;
+    }
+
+    /* estimation de k, corrigee dans les deux sens */
+    kk = (int)ceil(log10(ldexp((double)f, e)));
+    for (j = 0; j < (kk >= 0 ? kk : -kk); j++) dix *= 10;
+    if (kk >= 0) {
+        s *= dix;
+    } else {
+        r *= dix;
+        mp *= dix;
+        mm *= dix;
+    }
+    while (pair ? r + mp >= s : r + mp > s) {
+        s *= 10;
+        kk++;
+    }
+    while (pair ? (r + mp) * 10 < s : (r + mp) * 10 <= s) {
+        r *= 10;
+        mp *= 10;
+        mm *= 10;
+        kk--;
+    }
+
+    for (;;) {
+        int d, bas, haut;
+
+        r *= 10;
+        mp *= 10;
+        mm *= 10;
+        d = (int)(r / s);
+        r %= s;
+        bas = pair ? r <= mm : r < mm;
+        haut = pair ? r + mp >= s : r + mp > s;
+        if (bas && haut) {
+            /* les deux voisins conviennent : le plus proche, au pair a egalite */
+            if (2 * r > s || (2 * r == s && (d & 1))) d++;
+        } else if (haut) {
+            d++;
+        }
+        c[n++] = (char)('0' + d);
+        if (bas || haut) break;
+    }
+    *k = kk;
+    return n;
+}
+
+/* Mise en forme de 0.c1..cn 10^k : decimale si -4 <= k-1 < 17, scientifique sinon */
+static int mettre_en_forme(char *s, int negatif, const char *c, int n, int k) {
+    int i = 0, j, exposant = k - 1;
+
+    if (negatif) s[i++] = '-';
+    if (exposant >= -4 && exposant < 17) {
+        if (k <= 0) {
+            s[i++] = '0';
+            s[i++] = '.';
+            for (j = 0; j < -k; j++) s[i++] = '0';
+            for (j = 0; j < n; j++) s[i++] = c[j];
+        } else {
+            for (j = 0; j < k; j++) s[i++] = j < n ? c[j] : '0';
+            if (n > k) {
+                s[i++] = '.';
+                for (j = k; j < n; j++) s[i++] = c[j];
+            }
+        }
+    } else {
+        s[i++] = c[0];
+        if (n > 1) {
+            s[i++] = '.';
+            for (j = 1; j < n; j++) s[i++] = c[j];
+        }
+        i += snprintf(s + i, 8, "e%c%02d", exposant < 0 ? '-' : '+', exposant < 0 ? -exposant : exposant);
+    }
+    return i;
+}
+
+/* Repli : plus petite precision %.*g qui relit la meme valeur */
+static int court_repli(char *s, double v, int simple) {
+    int p, k = 0;
+
+    for (p = 1; p <= 17; p++) {
+        k = snprintf(s, NOMBRE_MAX, "%.*g", p, v);
+        if (simple ? (float)strtod(s, NULL) == (float)v : strtod(s, NULL) == v) break;
+    }
+    return k;
+}
+
+static int court(char *s, double v, int simple) {
+    char c[20];
+    uint64_t f;
+    int e, n, k;
+
+    if (simple) v = (float)v;               /* hors plage float : inf, arrondi vers 0 : 0 */
+    if (!isfinite(v)) return snprintf(s, NOMBRE_MAX, "%g", v);
+    if (v == 0.0) return snprintf(s, NOMBRE_MAX, signbit(v) ? "-0" : "0");
+    if (simple) {
+        float x = (float)fabs(v);
+        f = (uint64_t)ldexpf(frexpf(x, &e), 24);
+        e -= 24;
+        if (e < -149) {                     /* denormal : mantisse reduite */
+            f >>= -149 - e;
+            e = -149;
+        }
+        n = chiffres_courts(f, e, 24, -149, c, &k);
+    } else {
+        f = (uint64_t)ldexp(frexp(fabs(v), &e), 53);
+        e -= 53;
+        if (e < -1074) {
+            f >>= -1074 - e;
+            e = -1074;
+        }
+        n = chiffres_courts(f, e, 53, -1074, c, &k);
+    }
+    if (n == 0) return court_repli(s, v, simple);
+    return mettre_en_forme(s, signbit(v) != 0, c, n, k);
+}
+
+/* ===== Sortie ===== */
+
+void ecriture_nombre(Ecriture *e, double v, int decimales) {
+    char *s = reserver(e, NOMBRE_MAX);
+    int k;
+
+    if (decimales == ECRITURE_COURT) k = court(s, v, 0);
+    else if (decimales == ECRITURE_COURTF) k = court(s, v, 1);
+    else if ((k = fixe(s, v, decimales)) < 0) k = snprintf(s, NOMBRE_MAX, "%.*f", decimales, v);
+    /* snprintf tronque au-dela de NOMBRE_MAX : repli par un tampon temporaire */
+    if (k >= NOMBRE_MAX) {
+        char *long_texte = malloc((size_t)k + 1);
+        if (!long_texte) {
+            e->erreur = 1;
+            return;
+        }
+        snprintf(long_texte, (size_t)k + 1, "%.*f", decimales, v);
+        ajouter(e, long_texte, (size_t)k);
+        free(long_texte);
+        return;
+    }
+    e->utilise += (size_t)k;
+}
+
+void ecriture_ligne(Ecriture *e, const double *v, int k, const char *separateur, int decimales) {
+    int j;
+
+    if (e->binaire) {
+        ajouter(e, (const char *)v, (size_t)k * sizeof(double));
+        return;
+    }
+    for (j = 0; j < k; j++) {
+        if (j > 0) ecriture_texte(e, separateur);
+        ecriture_nombre(e, v[j], decimales);
+    }
+    ajouter(e, "\n", 1);
+}
+
+void ecriture_verification(const float *x, const float *y, size_t n, float a0, float a1) {
+    Ecriture sortie;
+    size_t i;
+
+    if (ecriture_ouvrir(&sortie, NULL, 0) != 0) return;
+    ecriture_texte(&sortie, "\nVerification avec les donnees:\n");
+    for (i = 0; i < n; i++) {
+        float prediction = a0 + a1 * x[i];
+        float erreur = prediction - y[i];
+        ecriture_texte(&sortie, "  Point ");
+        ecriture_nombre(&sortie, (double)(i + 1), 0);
+        ecriture_texte(&sortie, ": x=");
+        ecriture_nombre(&sortie, x[i], 3);
+        ecriture_texte(&sortie, ", y_reel=");
+        ecriture_nombre(&sortie, y[i], 3);
+        ecriture_texte(&sortie, ", y_pred=");
+        ecriture_nombre(&sortie, prediction, 3);
+        ecriture_texte(&sortie, ", erreur=");
+        ecriture_nombre(&sortie, erreur, 3);
+        ecriture_texte(&sortie, "\n");
+    }
+    ecriture_fermer(&sortie);
+}
@@ -0,0 +1,77 @@
+/*
+ * ecriture.h
+ * Sortie de valeurs numeriques en grand nombre (points, courbes,
+ * residus) : tampon de ECRITURE_TAMPON octets vide par write(2), et
+ * conversion des nombres sans printf.
+ *   - decimales >= 0 : memes caracteres que printf("%.*f") (arrondi exact
+ *     au plus proche, egalite au pair), par arithmetique entiere sur 128
+ *     bits ; les fichiers existants gardent leur format octet pour octet ;
+ *   - ECRITURE_COURT : plus courte ecriture qui relit le meme double
+ *     (generation des chiffres de Burger et Dybvig en entiers exacts) ;
+ *   - ECRITURE_COURTF : plus courte ecriture qui relit le meme float.
+ * Hors de la plage du calcul exact (|v| >= 1e17 en decimales fixes, tres
+ * grands ou tres petits exposants en ecriture courte), snprintf prend le
+ * relais avec le meme resultat.
+ *
+ * En mode binaire, chaque ligne est ecrite en doubles bruts dans l'ordre
+ * des octets de la machine : gnuplot les lit avec
+ *   binary format='%float64%float64...'
+ * Les programmes passent en mode binaire pour leurs fichiers de points
+ * avec REGRESSION_SORTIE=binaire.
+ */
+
+#ifndef ECRITURE_H
+#define ECRITURE_H
+
+#include <stddef.h>
+
+#define ECRITURE_TAMPON (1 << 20)
+#define ECRITURE_COURT (-1)
+#define ECRITURE_COURTF (-2)
+
+typedef struct {
+    int fd;
+    int binaire;
+    int erreur;             /* une ecriture a echoue */
+    size_t utilise;
+    char *tampon;
+} Ecriture;
+
+/*
+ * Ouvre fichier en ecriture (cree ou tronque), ou la sortie standard si
+ * fichier est NULL (stdout est vide d'abord pour garder l'ordre).
+ * Retourne 0, ou -1 (errno renseigne).
+ */
+int ecriture_ouvrir(Ecriture *e, const char *fichier, int binaire);
+
+/* 1 si REGRESSION_SORTIE vaut "binaire", 0 sinon */
+int ecriture_env(void);
+
+/* Vide le tampon et ferme le fichier. Retourne 0, ou -1 si une ecriture a echoue. */
+int ecriture_fermer(Ecriture *e);
+
+/* Vide le tampon sans fermer (sortie standard entre deux printf) */
+void ecriture_vider(Ecriture *e);
+
+void ecriture_texte(Ecriture *e, const char *s);
+
+/* Texte formate par vsnprintf (entetes ; pas pour les valeurs en nombre) */
+void ecriture_format(Ecriture *e, const char *format, ...);
+
+/* Un nombre : decimales >= 0, ECRITURE_COURT ou ECRITURE_COURTF */
+void ecriture_nombre(Ecriture *e, double v, int decimales);
+
+/*
+ * Une ligne de k valeurs separees par separateur, terminee par un retour
+ * a la ligne ; en mode binaire, k doubles bruts.
+ */
+void ecriture_ligne(Ecriture *e, const double *v, int k, const char *separateur, int decimales);
+
+/*
+ * Listing "Verification avec les donnees" de gauchy.c et moinCarre.c sur
+ * la sortie standard : x, y, prediction a0 + a1 x et erreur (3 decimales,
+ * calculs en float) pour chacun des n points.
+ */
+void ecriture_verification(const float *x, const float *y, size_t n, float a0, float a1);
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ * en_ligne.c
+ * Ajustement en ligne de f(x) = a * exp(b x) par gradient stochastique
+ * (sgd.h) : les points arrivent sur l'entree standard (tube, fichier en
+ * cours d'ecriture, capteur...) et les parametres sont mis a jour a chaque
+ * lot, sans attendre la fin des donnees ni les garder en memoire.
+ *
+ * Usage : producteur | ./en_ligne [-m taille_lot] [-p pas] [-t tau] [-a a0 b0]
+ *                                 [-k tampon] [-e lots] [-g graine]
+ *   -m    points par pas (defaut 256)
+ *   -p    pas initial η0 (defaut 0.01), decroissant en η0/(1 + t/τ)^0.6
+ *   -t    τ, en pas (defaut 1000) ; la moyenne de Polyak commence apres τ pas
+ *   -a    depart (defaut 1.0 0.1, comme gauchy_exp.c)
+ *   -k    tampon de melange en points (defaut 4096, 0 : ordre d'arrivee) :
+ *         chaque point recu remplace un point tire au hasard dans le tampon,
+ *         qui part dans le lot courant. Cela decorrele un flux localement
+ *         ordonne ; un flux entierement trie en x (comme donnees.txt) reste
+ *         biaise vers ses derniers points si le tampon n'en couvre qu'une
+ *         petite partie.
+ *   -e    affiche les parametres tous les e lots (defaut 100)
+ * Lignes acceptees : "x, y" ou "x y" ; les lignes d'un seul nombre (entete n),
+ * vides ou commencant par # sont ignorees, les autres comptees comme erronees.
+ *
+ * Compilation : gcc -O2 en_ligne.c sgd.c expvec.c lecture.c points.c -o en_ligne -lm
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lecture.h"
+#include "sgd.h"
+
+typedef struct {
+    Sgd sgd;
+    double *xs, *ys;        /* lot en cours */
+    size_t dans_lot;
+    double *tx, *ty;        /* tampon de melange */
+    size_t tampon, dans_tampon;
+    long lots, affichage;
+    size_t points;
+} EnLigne;
+
+static void error_and_exit(const char *msg) {
+    fprintf(stderr, "%s\n", msg);
+    exit(EXIT_FAILURE);
+}
+
+static void afficher(const EnLigne *e) {
+    double a, b;
+    sgd_parametres(&e->sgd, &a, &b);
+    printf("points=%zu lots=%ld a=%.6f b=%.6f\n", e->points, e->lots, a, b);
+    fflush(stdout);
+}
+
+/* Ajoute un point au lot et fait le pas quand il est plein */
+static void vers_lot(EnLigne *e, double x, double y) {
+    e->xs[e->dans_lot] = x;
+    e->ys[e->dans_lot] = y;
+    if (++e->dans_lot < e->sgd.opt.taille_lot) return;
+
+    sgd_lot(&e->sgd, e->xs, e->ys, e->dans_lot);
+    e->dans_lot = 0;
+    e->lots++;
+    if (e->sgd.pas_faits == (long)e->sgd.opt.tau) sgd_reprendre_moyenne(&e->sgd);
+    if (e->affichage > 0 && e->lots % e->affichage == 0) afficher(e);
+}
+
+static void recevoir(EnLigne *e, double x, double y) {
+    size_t j;
+
+    e->points++;
+    if (e->tampon == 0) {
+        vers_lot(e, x, y);
+        return;
+    }
+    if (e->dans_tampon < e->tampon) {
+        e->tx[e->dans_tampon] = x;
+        e->ty[e->dans_tampon] = y;
+        e->dans_tampon++;
+        return;
+    }
+    j = (size_t)(sgd_tirage(&e->sgd) % e->tampon);
+    vers_lot(e, e->tx[j], e->ty[j]);
+    e->tx[j] = x;
+    e->ty[j] = y;
+}
+
+/* Fin du flux : le tampon part dans un ordre aleatoire, puis le dernier lot partiel */
+static void vider(EnLigne *e) {
+    while (e->dans_tampon > 0) {
+        size_t j = (size_t)(sgd_tirage(&e->sgd) % e->dans_tampon);
+        vers_lot(e, e->tx[j], e->ty[j]);
+        e->dans_tampon--;
+        e->tx[j] = e->tx[e->dans_tampon];
+        e->ty[j] = e->ty[e->dans_tampon];
+    }
+    if (e->dans_lot > 0) {
+        sgd_lot(&e->sgd, e->xs, e->ys, e->dans_lot);
+        e->dans_lot = 0;
+        e->lots++;
+    }
+}
+
+/* 1 : point lu, 0 : ligne ignoree, -1 : ligne erronee */
+static int analyser(const char *ligne, size_t longueur, double *x, double *y) {
+    const char *fin = ligne + longueur, *p = ligne;
+
+    while (p < fin && (*p == ' ' || *p == '\t')) p++;
+    if (p == fin || *p == '\n' || *p == '\r' || *p == '#') return 0;
+    p = lecture_nombre(p, fin, x);
+    if (!p) return -1;
+    while (p < fin && (*p == ' ' || *p == '\t')) p++;
+    if (p < fin && *p == ',') p++;
+    else if (p == fin || *p == '\n' || *p == '\r') return 0;     /* entete n */
+    p = lecture_nombre(p, fin, y);
+    if (!p) return -1;
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    return p == fin ? 1 : -1;
+}
+
+int main(int argc, char **argv) {
+    SgdOptions opt;
+    EnLigne e;
+    double a = 1.0, b = 0.1;
+    char *ligne = NULL;
+    size_t taille = 0, numero = 0, erreurs = 0;
+    ssize_t lu;
+    int k;
+
+    memset(&e, 0, sizeof(e));
+    sgd_options_defaut(&opt);
+    e.tampon = 4096;
+    e.affichage = 100;
+    for (k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "-m") == 0 && k + 1 < argc) {
+            opt.taille_lot = (size_t)atol(argv[++k]);
+        } else if (strcmp(argv[k], "-p") == 0 && k + 1 < argc) {
+            opt.pas = atof(argv[++k]);
+        } else if (strcmp(argv[k], "-t") == 0 && k + 1 < argc) {
+            opt.tau = atof(argv[++k]);
+        } else if (strcmp(argv[k], "-a") == 0 && k + 2 < argc) {
+            a = atof(argv[++k]);
+            b = atof(argv[++k]);
+        } else if (strcmp(argv[k], "-k") == 0 && k + 1 < argc) {
+            e.tampon = (size_t)atol(argv[++k]);
+        } else if (strcmp(argv[k], "-e") == 0 && k + 1 < argc) {
+            e.affichage = atol(argv[++k]);
+        } else if (strcmp(argv[k], "-g") == 0 && k + 1 < argc) {
+            opt.graine = strtoull(argv[++k], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage : %s [-m taille_lot] [-p pas] [-t tau] [-a a0 b0] "
+                            "[-k tampon] [-e lots] [-g graine]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (opt.taille_lot == 0 || opt.pas <= 0.0 || opt.tau <= 0.0)
+        error_and_exit("Parametres de pas invalides");
+
+    sgd_init(&e.sgd, a, b, &opt);
+    e.xs = malloc(opt.taille_lot * sizeof(double));
+    e.ys = malloc(opt.taille_lot * sizeof(double));
+    e.tx = malloc((e.tampon + 1) * sizeof(double));
+    e.ty = malloc((e.tampon + 1) * sizeof(double));
+    if (!e.xs || !e.ys || !e.tx || !e.ty) error_and_exit("Memoire insuffisante pour les tampons");
+
+    while ((lu = getline(&ligne, &taille, stdin)) != -1) {
+        double x, y;
+        int r = analyser(ligne, (size_t)lu, &x, &y);
+
+        numero++;
+        if (r > 0) {
+            recevoir(&e, x, y);
+        } else if (r < 0) {
+            if (erreurs++ == 0) fprintf(stderr, "ligne %zu ignoree : format invalide\n", numero);
+        }
+    }
+    vider(&e);
+
+    afficher(&e);
+    if (erreurs) fprintf(stderr, "%zu lignes erronees ignorees\n", erreurs);
+    if (e.sgd.rejetes) fprintf(stderr, "%ld lots au gradient non fini ignores\n", e.sgd.rejetes);
+
+    free(ligne);
+    free(e.xs);
+    free(e.ys);
+    free(e.tx);
+    free(e.ty);
+    return e.points ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,571 @@
+/*
+ * expvec.c
+ * Noyau vectorise du modele a * exp(b x) (voir expvec.h).
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expvec.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EXPVEC_X86 1
+#endif
+
+/* ===== Constantes de l'exponentielle ===== */
+
+#define LOG2E    1.4426950408889634
+#define MAGIC    6755399441055744.0             /* 1.5 * 2^52 : arrondi a l'entier */
+#define LN2_HI   6.93147180369123816490e-01     /* ln2 = LN2_HI + LN2_LO (fdlibm) */
+#define LN2_LO   1.90821492927058770002e-10
+#define EXP_MIN  (-708.39)                      /* k >= -1022 */
+#define EXP_MAX  709.43                         /* k <= 1023 */
+
+#define LOG2EF   1.44269504f
+#define MAGICF   12582912.0f                    /* 1.5 * 2^23 */
+#define LN2_HIF  0.693359375f
+#define LN2_LOF  (-2.12194440e-4f)
+#define EXP_MINF (-87.33f)
+#define EXP_MAXF 88.37f
+
+/* 1/k! pour k = 0..13 */
+static const double coef[14] = {
+    1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0, 1.0 / 720.0,
+    1.0 / 5040.0, 1.0 / 40320.0, 1.0 / 362880.0, 1.0 / 3628800.0,
+    1.0 / 39916800.0, 1.0 / 479001600.0, 1.0 / 6227020800.0
+};
+
+static const float coeff[8] = {
+    1.0f, 1.0f, 1.0f / 2.0f, 1.0f / 6.0f, 1.0f / 24.0f, 1.0f / 120.0f,
+    1.0f / 720.0f, 1.0f / 5040.0f
+};
+
+/* ===== Version scalaire (reference et fin de tableau) ===== */
+
+static inline double exp_scalaire(double x) {
+    double kf, k, r, p, s;
+    uint64_t bits;
+    int j;
+
+    if (x < EXP_MIN) x = EXP_MIN;
+    if (x > EXP_MAX) x = EXP_MAX;
+    kf = x * LOG2E + MAGIC;
+    k = kf - MAGIC;
+    r = x - k * LN2_HI;
+    r = r - k * LN2_LO;
+    p = coef[13];
+    for (j = 12; j >= 0; j--) p = p * r + coef[j];
+
+    /* Les bits de kf contiennent k : 2^k = (k + 1023) << 52 */
+    memcpy(&bits, &kf, sizeof(bits));
+    bits = (bits + 1023) << 52;
+    memcpy(&s, &bits, sizeof(s));
+    return p * s;
+}
+
+static inline float exp_scalairef(float x) {
+    float kf, k, r, p, s;
+    uint32_t bits;
+    int j;
+
+    if (x < EXP_MINF) x = EXP_MINF;
+    if (x > EXP_MAXF) x = EXP_MAXF;
+    kf = x * LOG2EF + MAGICF;
+    k = kf - MAGICF;
+    r = x - k * LN2_HIF;
+    r = r - k * LN2_LOF;
+    p = coeff[7];
+    for (j = 6; j >= 0; j--) p = p * r + coeff[j];
+
+    memcpy(&bits, &kf, sizeof(bits));
+    bits = (bits + 127) << 23;
+    memcpy(&s, &bits, sizeof(s));
+    return p * s;
+}
+
+static void sommes_scalaire(const double *x, const double *y, size_t n, double a, double b, double *s) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        double e = exp_scalaire(b * x[i]);
+        double r = a * e - y[i];
+        s0 += r * r;
+        s1 += r * e;
+        s2 += r * a * x[i] * e;
+    }
+    s[0] += s0;
+    s[1] += s1;
+    s[2] += s2;
+}
+
+static void sommes_scalairef(const float *x, const float *y, size_t n, float a, float b, double *s) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        float e = exp_scalairef(b * x[i]);
+        float r = a * e - y[i];
+        s0 += r * r;
+        s1 += r * e;
+        s2 += r * a * x[i] * e;
+    }
+    s[0] += s0;
+    s[1] += s1;
+    s[2] += s2;
+}
+
+static void normales_scalaire(const double *x, const double *y, size_t n, double a, double b, double *s) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0, s5 = 0.0;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        double e = exp_scalaire(b * x[i]);
+        double r = a * e - y[i];
+        double jb = a * x[i] * e;
+        s0 += r * r;
+        s1 += r * e;
+        s2 += r * jb;
+        s3 += e * e;
+        s4 += e * jb;
+        s5 += jb * jb;
+    }
+    s[0] += s0;
+    s[1] += s1;
+    s[2] += s2;
+    s[3] += s3;
+    s[4] += s4;
+    s[5] += s5;
+}
+
+static void exp_tableau_scalaire(const double *x, double *e, size_t n) {
+    size_t i;
+    for (i = 0; i < n; i++) e[i] = exp_scalaire(x[i]);
+}
+
+#ifdef EXPVEC_X86
+
+/* ===== SSE2 : 2 doubles / 4 floats ===== */
+
+static inline __m128d exp_sse2(__m128d x) {
+    __m128d kf, k, r, p;
+    __m128i bits;
+    int j;
+
+    /* max et min rendent le second operande si l'un est NaN : x en second, NaN traverse la borne */
+    x = _mm_min_pd(_mm_set1_pd(EXP_MAX), _mm_max_pd(_mm_set1_pd(EXP_MIN), x));
+    kf = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(LOG2E)), _mm_set1_pd(MAGIC));
+    k = _mm_sub_pd(kf, _mm_set1_pd(MAGIC));
+    r = _mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(LN2_HI)));
+    r = _mm_sub_pd(r, _mm_mul_pd(k, _mm_set1_pd(LN2_LO)));
+    p = _mm_set1_pd(coef[13]);
+    for (j = 12; j >= 0; j--) p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(coef[j]));
+    bits = _mm_slli_epi64(_mm_add_epi64(_mm_castpd_si128(kf), _mm_set1_epi64x(1023)), 52);
+    return _mm_mul_pd(p, _mm_castsi128_pd(bits));
+}
+
+static inline __m128 exp_sse2f(__m128 x) {
+    __m128 kf, k, r, p;
+    __m128i bits;
+    int j;
+
+    x = _mm_min_ps(_mm_set1_ps(EXP_MAXF), _mm_max_ps(_mm_set1_ps(EXP_MINF), x));
+    kf = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(LOG2EF)), _mm_set1_ps(MAGICF));
+    k = _mm_sub_ps(kf, _mm_set1_ps(MAGICF));
+    r = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(LN2_HIF)));
+    r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(LN2_LOF)));
+    p = _mm_set1_ps(coeff[7]);
+    for (j = 6; j >= 0; j--) p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(coeff[j]));
+    bits = _mm_slli_epi32(_mm_add_epi32(_mm_castps_si128(kf), _mm_set1_epi32(127)), 23);
+    return _mm_mul_ps(p, _mm_castsi128_ps(bits));
+}
+
+static void sommes_sse2(const double *x, const double *y, size_t n, double a, double b, double *s) {
+    __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b);
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd();
+    double t[2];
+    size_t i;
+
+    for (i = 0; i + 2 <= n; i += 2) {
+        __m128d vx = _mm_loadu_pd(x + i);
+        __m128d e = exp_sse2(_mm_mul_pd(vb, vx));
+        __m128d r = _mm_sub_pd(_mm_mul_pd(va, e), _mm_loadu_pd(y + i));
+        __m128d re = _mm_mul_pd(r, e);
+        s0 = _mm_add_pd(s0, _mm_mul_pd(r, r));
+        s1 = _mm_add_pd(s1, re);
+        s2 = _mm_add_pd(s2, _mm_mul_pd(_mm_mul_pd(re, va), vx));
+    }
+    _mm_storeu_pd(t, s0); s[0] += t[0] + t[1];
+    _mm_storeu_pd(t, s1); s[1] += t[0] + t[1];
+    _mm_storeu_pd(t, s2); s[2] += t[0] + t[1];
+    sommes_scalaire(x + i, y + i, n - i, a, b, s);
+}
+
+static void sommes_sse2f(const float *x, const float *y, size_t n, float a, float b, double *s) {
+    __m128 va = _mm_set1_ps(a), vb = _mm_set1_ps(b);
+    __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps(), s2 = _mm_setzero_ps();
+    float t[4];
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 e = exp_sse2f(_mm_mul_ps(vb, vx));
+        __m128 r = _mm_sub_ps(_mm_mul_ps(va, e), _mm_loadu_ps(y + i));
+        __m128 re = _mm_mul_ps(r, e);
+        s0 = _mm_add_ps(s0, _mm_mul_ps(r, r));
+        s1 = _mm_add_ps(s1, re);
+        s2 = _mm_add_ps(s2, _mm_mul_ps(_mm_mul_ps(re, va), vx));
+    }
+    _mm_storeu_ps(t, s0); s[0] += (double)((t[0] + t[1]) + (t[2] + t[3]));
+    _mm_storeu_ps(t, s1); s[1] += (double)((t[0] + t[1]) + (t[2] + t[3]));
+    _mm_storeu_ps(t, s2); s[2] += (double)((t[0] + t[1]) + (t[2] + t[3]));
+    sommes_scalairef(x + i, y + i, n - i, a, b, s);
+}
+
+static void normales_sse2(const double *x, const double *y, size_t n, double a, double b, double *s) {
+    __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b);
+    __m128d v[6];
+    double t[2];
+    size_t i;
+    int j;
+
+    for (j = 0; j < 6; j++) v[j] = _mm_setzero_pd();
+    for (i = 0; i + 2 <= n; i += 2) {
+        __m128d vx = _mm_loadu_pd(x + i);
+        __m128d e = exp_sse2(_mm_mul_pd(vb, vx));
+        __m128d r = _mm_sub_pd(_mm_mul_pd(va, e), _mm_loadu_pd(y + i));
+        __m128d jb = _mm_mul_pd(_mm_mul_pd(va, vx), e);
+        v[0] = _mm_add_pd(v[0], _mm_mul_pd(r, r));
+        v[1] = _mm_add_pd(v[1], _mm_mul_pd(r, e));
+        v[2] = _mm_add_pd(v[2], _mm_mul_pd(r, jb));
+        v[3] = _mm_add_pd(v[3], _mm_mul_pd(e, e));
+        v[4] = _mm_add_pd(v[4], _mm_mul_pd(e, jb));
+        v[5] = _mm_add_pd(v[5], _mm_mul_pd(jb, jb));
+    }
+    for (j = 0; j < 6; j++) {
+        _mm_storeu_pd(t, v[j]);
+        s[j] += t[0] + t[1];
+    }
+    normales_scalaire(x + i, y + i, n - i, a, b, s);
+}
+
+static void exp_tableau_sse2(const double *x, double *e, size_t n) {
+    size_t i;
+    for (i = 0; i + 2 <= n; i += 2) _mm_storeu_pd(e + i, exp_sse2(_mm_loadu_pd(x + i)));
+    exp_tableau_scalaire(x + i, e + i, n - i);
+}
+
+/* ===== AVX2 + FMA : 4 doubles / 8 floats ===== */
+
+__attribute__((target("avx2,fma")))
+static inline __m256d exp_avx2(__m256d x) {
+    __m256d kf, k, r, p;
+    __m256i bits;
+    int j;
+
+    x = _mm256_min_pd(_mm256_set1_pd(EXP_MAX), _mm256_max_pd(_mm256_set1_pd(EXP_MIN), x));
+    kf = _mm256_fmadd_pd(x, _mm256_set1_pd(LOG2E), _mm256_set1_pd(MAGIC));
+    k = _mm256_sub_pd(kf, _mm256_set1_pd(MAGIC));
+    r = _mm256_fnmadd_pd(k, _mm256_set1_pd(LN2_HI), x);
+    r = _mm256_fnmadd_pd(k, _mm256_set1_pd(LN2_LO), r);
+    p = _mm256_set1_pd(coef[13]);
+    for (j = 12; j >= 0; j--) p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(coef[j]));
+    bits = _mm256_slli_epi64(_mm256_add_epi64(_mm256_castpd_si256(kf), _mm256_set1_epi64x(1023)), 52);
+    return _mm256_mul_pd(p, _mm256_castsi256_pd(bits));
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256 exp_avx2f(__m256 x) {
+    __m256 kf, k, r, p;
+    __m256i bits;
+    int j;
+
+    x = _mm256_min_ps(_mm256_set1_ps(EXP_MAXF), _mm256_max_ps(_mm256_set1_ps(EXP_MINF), x));
+    kf = _mm256_fmadd_ps(x, _mm256_set1_ps(LOG2EF), _mm256_set1_ps(MAGICF));
+    k = _mm256_sub_ps(kf, _mm256_set1_ps(MAGICF));
+    r = _mm256_fnmadd_ps(k, _mm256_set1_ps(LN2_HIF), x);
+    r = _mm256_fnmadd_ps(k, _mm256_set1_ps(LN2_LOF), r);
+    p = _mm256_set1_ps(coeff[7]);
+    for (j = 6; j >= 0; j--) p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(coeff[j]));
+    bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_castps_si256(kf), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(bits));
+}
+
+__attribute__((target("avx2,fma")))
+static void sommes_avx2(const double *x, const double *y, size_t n, double a, double b, double *s) {
+    __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd();
+    double t[4];
+    size_t i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m256d vx = _mm256_loadu_pd(x + i);
+        __m256d e = exp_avx2(_mm256_mul_pd(vb, vx));
+        __m256d r = _mm256_fmsub_pd(va, e, _mm256_loadu_pd(y + i));
+        __m256d re = _mm256_mul_pd(r, e);
+        s0 = _mm256_fmadd_pd(r, r, s0);
+        s1 = _mm256_add_pd(s1, re);
+        s2 = _mm256_fmadd_pd(_mm256_mul_pd(re, va), vx, s2);
+    }
+    _mm256_storeu_pd(t, s0); s[0] += (t[0] + t[1]) + (t[2] + t[3]);
+    _mm256_storeu_pd(t, s1); s[1] += (t[0] + t[1]) + (t[2] + t[3]);
+    _mm256_storeu_pd(t, s2); s[2] += (t[0] + t[1]) + (t[2] + t[3]);
+    sommes_scalaire(x + i, y + i, n - i, a, b, s);
+}
+
+__attribute__((target("avx2,fma")))
+static void sommes_avx2f(const float *x, const float *y, size_t n, float a, float b, double *s) {
+    __m256 va = _mm256_set1_ps(a), vb = _mm256_set1_ps(b);
+    __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps();
+    float t[8];
+    size_t i;
+    int j;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 e = exp_avx2f(_mm256_mul_ps(vb, vx));
+        __m256 r = _mm256_fmsub_ps(va, e, _mm256_loadu_ps(y + i));
+        __m256 re = _mm256_mul_ps(r, e);
+        s0 = _mm256_fmadd_ps(r, r, s0);
+        s1 = _mm256_add_ps(s1, re);
+        s2 = _mm256_fmadd_ps(_mm256_mul_ps(re, va), vx, s2);
+    }
+    _mm256_storeu_ps(t, s0); for (j = 0; j < 8; j++) s[0] += t[j];
+    _mm256_storeu_ps(t, s1); for (j = 0; j < 8; j++) s[1] += t[j];
+    _mm256_storeu_ps(t, s2); for (j = 0; j < 8; j++) s[2] += t[j];
+    sommes_scalairef(x + i, y + i, n - i, a, b, s);
+}
+
+__attribute__((target("avx2,fma")))
+static void normales_avx2(const double *x, const double *y, size_t n, double a, double b, double *s) {
+    __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+    __m256d v[6];
+    double t[4];
+    size_t i;
+    int j;
+
+    for (j = 0; j < 6; j++) v[j] = _mm256_setzero_pd();
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m256d vx = _mm256_loadu_pd(x + i);
+        __m256d e = exp_avx2(_mm256_mul_pd(vb, vx));
+        __m256d r = _mm256_fmsub_pd(va, e, _mm256_loadu_pd(y + i));
+        __m256d jb = _mm256_mul_pd(_mm256_mul_pd(va, vx), e);
+        v[0] = _mm256_fmadd_pd(r, r, v[0]);
+        v[1] = _mm256_fmadd_pd(r, e, v[1]);
+        v[2] = _mm256_fmadd_pd(r, jb, v[2]);
+        v[3] = _mm256_fmadd_pd(e, e, v[3]);
+        v[4] = _mm256_fmadd_pd(e, jb, v[4]);
+        v[5] = _mm256_fmadd_pd(jb, jb, v[5]);
+    }
+    for (j = 0; j < 6; j++) {
+        _mm256_storeu_pd(t, v[j]);
+        s[j] += (t[0] + t[1]) + (t[2] + t[3]);
+    }
+    normales_scalaire(x + i, y + i, n - i, a, b, s);
+}
+
+__attribute__((target("avx2,fma")))
+static void exp_tableau_avx2(const double *x, double *e, size_t n) {
+    size_t i;
+    for (i = 0; i + 4 <= n; i += 4) _mm256_storeu_pd(e + i, exp_avx2(_mm256_loadu_pd(x + i)));
+    exp_tableau_scalaire(x + i, e + i, n - i);
+}
+
+/* ===== AVX-512 : 8 doubles / 16 floats ===== */
+
+__attribute__((target("avx512f")))
+static inline __m512d exp_avx512(__m512d x) {
+    __m512d kf, k, r, p;
+    __m512i bits;
+    int j;
+
+    x = _mm512_min_pd(_mm512_set1_pd(EXP_MAX), _mm512_max_pd(_mm512_set1_pd(EXP_MIN), x));
+    kf = _mm512_fmadd_pd(x, _mm512_set1_pd(LOG2E), _mm512_set1_pd(MAGIC));
+    k = _mm512_sub_pd(kf, _mm512_set1_pd(MAGIC));
+    r = _mm512_fnmadd_pd(k, _mm512_set1_pd(LN2_HI), x);
+    r = _mm512_fnmadd_pd(k, _mm512_set1_pd(LN2_LO), r);
+    p = _mm512_set1_pd(coef[13]);
+    for (j = 12; j >= 0; j--) p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(coef[j]));
+    bits = _mm512_slli_epi64(_mm512_add_epi64(_mm512_castpd_si512(kf), _mm512_set1_epi64(1023)), 52);
+    return _mm512_mul_pd(p, _mm512_castsi512_pd(bits));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512 exp_avx512f(__m512 x) {
+    __m512 kf, k, r, p;
+    __m512i bits;
+    int j;
+
+    x = _mm512_min_ps(_mm512_set1_ps(EXP_MAXF), _mm512_max_ps(_mm512_set1_ps(EXP_MINF), x));
+    kf = _mm512_fmadd_ps(x, _mm512_set1_ps(LOG2EF), _mm512_set1_ps(MAGICF));
+    k = _mm512_sub_ps(kf, _mm512_set1_ps(MAGICF));
+    r = _mm512_fnmadd_ps(k, _mm512_set1_ps(LN2_HIF), x);
+    r = _mm512_fnmadd_ps(k, _mm512_set1_ps(LN2_LOF), r);
+    p = _mm512_set1_ps(coeff[7]);
+    for (j = 6; j >= 0; j--) p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(coeff[j]));
+    bits = _mm512_slli_epi32(_mm512_add_epi32(_mm512_castps_si512(kf), _mm512_set1_epi32(127)), 23);
+    return _mm512_mul_ps(p, _mm512_castsi512_ps(bits));
+}
+
+__attribute__((target("avx512f")))
+static void sommes_avx512(const double *x, const double *y, size_t n, double a, double b, double *s) {
+    __m512d va = _mm512_set1_pd(a), vb = _mm512_set1_pd(b);
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd();
+    double t[8];
+    size_t i;
+    int j;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m512d vx = _mm512_loadu_pd(x + i);
+        __m512d e = exp_avx512(_mm512_mul_pd(vb, vx));
+        __m512d r = _mm512_fmsub_pd(va, e, _mm512_loadu_pd(y + i));
+        __m512d re = _mm512_mul_pd(r, e);
+        s0 = _mm512_fmadd_pd(r, r, s0);
+        s1 = _mm512_add_pd(s1, re);
+        s2 = _mm512_fmadd_pd(_mm512_mul_pd(re, va), vx, s2);
+    }
+    _mm512_storeu_pd(t, s0); for (j = 0; j < 8; j++) s[0] += t[j];
+    _mm512_storeu_pd(t, s1); for (j = 0; j < 8; j++) s[1] += t[j];
+    _mm512_storeu_pd(t, s2); for (j = 0; j < 8; j++) s[2] += t[j];
+    sommes_scalaire(x + i, y + i, n - i, a, b, s);
+}
+
+__attribute__((target("avx512f")))
+static void sommes_avx512f(const float *x, const float *y, size_t n, float a, float b, double *s) {
+    __m512 va = _mm512_set1_ps(a), vb = _mm512_set1_ps(b);
+    __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps(), s2 = _mm512_setzero_ps();
+    float t[16];
+    size_t i;
+    int j;
+
+    for (i = 0; i + 16 <= n; i += 16) {
+        __m512 vx = _mm512_loadu_ps(x + i);
+        __m512 e = exp_avx512f(_mm512_mul_ps(vb, vx));
+        __m512 r = _mm512_fmsub_ps(va, e, _mm512_loadu_ps(y + i));
+        __m512 re = _mm512_mul_ps(r, e);
+        s0 = _mm512_fmadd_ps(r, r, s0);
+        s1 = _mm512_add_ps(s1, re);
+        s2 = _mm512_fmadd_ps(_mm512_mul_ps(re, va), vx, s2);
+    }
+    _mm512_storeu_ps(t, s0); for (j = 0; j < 16; j++) s[0] += t[j];
+    _mm512_storeu_ps(t, s1); for (j = 0; j < 16; j++) s[1] += t[j];
+    _mm512_storeu_ps(t, s2); for (j = 0; j < 16; j++) s[2] += t[j];
+    sommes_scalairef(x + i, y + i, n - i, a, b, s);
+}
+
+__attribute__((target("avx512f")))
+static void normales_avx512(const double *x, const double *y, size_t n, double a, double b, double *s) {
+    __m512d va = _mm512_set1_pd(a), vb = _mm512_set1_pd(b);
+    __m512d v[6];
+    double t[8];
+    size_t i;
+    int j, k;
+
+    for (j = 0; j < 6; j++) v[j] = _mm512_setzero_pd();
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m512d vx = _mm512_loadu_pd(x + i);
+        __m512d e = exp_avx512(_mm512_mul_pd(vb, vx));
+        __m512d r = _mm512_fmsub_pd(va, e, _mm512_loadu_pd(y + i));
+        __m512d jb = _mm512_mul_pd(_mm512_mul_pd(va, vx), e);
+        v[0] = _mm512_fmadd_pd(r, r, v[0]);
+        v[1] = _mm512_fmadd_pd(r, e, v[1]);
+        v[2] = _mm512_fmadd_pd(r, jb, v[2]);
+        v[3] = _mm512_fmadd_pd(e, e, v[3]);
+        v[4] = _mm512_fmadd_pd(e, jb, v[4]);
+        v[5] = _mm512_fmadd_pd(jb, jb, v[5]);
+    }
+    for (j = 0; j < 6; j++) {
+        _mm512_storeu_pd(t, v[j]);
+        for (k = 0; k < 8; k++) s[j] += t[k];
+    }
+    normales_scalaire(x + i, y + i, n - i, a, b, s);
+}
+
+__attribute__((target("avx512f")))
+static void exp_tableau_avx512(const double *x, double *e, size_t n) {
+    size_t i;
+    for (i = 0; i + 8 <= n; i += 8) _mm512_storeu_pd(e + i, exp_avx512(_mm512_loadu_pd(x + i)));
+    exp_tableau_scalaire(x + i, e + i, n - i);
+}
+
+#endif /* EXPVEC_X86 */
+
+/* ===== Choix du chemin a l'execution ===== */
+
+typedef struct {
+    const char *nom;
+    void (*sommes)(const double *, const double *, size_t, double, double, double *);
+    void (*sommesf)(const float *, const float *, size_t, float, float, double *);
+    void (*normales)(const double *, const double *, size_t, double, double, double *);
+    void (*exp_tableau)(const double *, double *, size_t);
+} Noyau;
+
+static const Noyau noyaux[] = {
+    { "scalaire", sommes_scalaire, sommes_scalairef, normales_scalaire, exp_tableau_scalaire },
+#ifdef EXPVEC_X86
+    { "sse2",     sommes_sse2,     sommes_sse2f,     normales_sse2,     exp_tableau_sse2 },
+    { "avx2",     sommes_avx2,     sommes_avx2f,     normales_avx2,     exp_tableau_avx2 },
+    { "avx512",   sommes_avx512,   sommes_avx512f,   normales_avx512,   exp_tableau_avx512 },
+#endif
+};
+
+static const Noyau *noyau = &noyaux[0];
+
+/* Nombre de chemins utilisables sur ce processeur, du plus lent au plus rapide */
+static size_t disponibles(void) {
+    size_t n = 1;
+
+#ifdef EXPVEC_X86
+    __builtin_cpu_init();
+    n = 2;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) n = 3;
+    if (__builtin_cpu_supports("avx512f")) n = 4;
+#endif
+    return n;
+}
+
+/* Execute au chargement du programme, avant tout thread */
+__attribute__((constructor))
+static void expvec_choisir(void) {
+    const char *force = getenv("EXPVEC_ISA");
+
+    noyau = &noyaux[disponibles() - 1];
+    if (force) expvec_forcer(force);
+}
+
+int expvec_forcer(const char *isa) {
+    size_t i, n = disponibles();
+
+    for (i = 0; i < n; i++) {
+        if (strcmp(isa, noyaux[i].nom) == 0) {
+            noyau = &noyaux[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void expvec_sommes(const double *x, const double *y, size_t n, double a, double b, double sommes[3]) {
+    sommes[0] = sommes[1] = sommes[2] = 0.0;
+    noyau->sommes(x, y, n, a, b, sommes);
+}
+
+void expvec_sommesf(const float *x, const float *y, size_t n, float a, float b, double sommes[3]) {
+    sommes[0] = sommes[1] = sommes[2] = 0.0;
+    noyau->sommesf(x, y, n, a, b, sommes);
+}
+
+void expvec_normales(const double *x, const double *y, size_t n, double a, double b, double sommes[6]) {
+    int j;
+    for (j = 0; j < 6; j++) sommes[j] = 0.0;
+    noyau->normales(x, y, n, a, b, sommes);
+}
+
+void expvec_exp(const double *x, double *e, size_t n) {
+    noyau->exp_tableau(x, e, n);
+}
+
+const char *expvec_isa(void) {
+    return noyau->nom;
+}
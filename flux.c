@@ -0,0 +1,362 @@
+/*
+ * flux.c
+ * Lecture par morceaux avec double tampon (voir flux.h).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "flux.h"
+#include "binaire.h"
+
+#define MORCEAU_MIN 1024
+#define BRUT_MIN (64u << 10)
+
+struct Flux {
+    int fd;
+    size_t n;
+    size_t capacite;                /* points par morceau */
+
+    /* fichier binaire */
+    int binaire;
+    PointsType type_fichier;
+    uint64_t offset_x, offset_y;
+    float *conversion;              /* colonnes float du fichier, avant passage en double */
+
+    /* fichier texte */
+    off_t debut_texte;              /* fin de la ligne d'entete */
+    char *brut;
+    size_t brut_taille;
+    size_t brut_debut, brut_fin;    /* octets non analyses dans brut */
+    off_t position;                 /* prochain octet a lire dans le fichier */
+    int fin_fichier;
+    size_t ligne;
+
+    /* double tampon, partage avec le thread lecteur */
+    Points tampons[2];
+    size_t remplis[2];              /* points valides ; 0 : fin de passe */
+    int pret[2];
+    int residant;                   /* fichier entier dans tampons[0] apres une passe */
+    LectureCode erreur;
+    pthread_mutex_t verrou;
+    pthread_cond_t signal;
+};
+
+/* ===== Lecture brute ===== */
+
+/* pread complet ; retourne 0, ou -1 si le fichier est plus court */
+static int lire_tout(int fd, void *tampon, size_t octets, off_t position) {
+    char *p = (char *)tampon;
+
+    while (octets > 0) {
+        ssize_t lu = pread(fd, p, octets, position);
+        if (lu < 0 && errno == EINTR) continue;
+        if (lu <= 0) return -1;
+        p += lu;
+        octets -= (size_t)lu;
+        position += lu;
+    }
+    return 0;
+}
+
+/* Recharge brut : garde les octets non analyses et complete depuis le fichier */
+static int recharger(Flux *f) {
+    size_t restant = f->brut_fin - f->brut_debut;
+    ssize_t lu;
+
+    if (f->fin_fichier) return 0;
+    memmove(f->brut, f->brut + f->brut_debut, restant);
+    f->brut_debut = 0;
+    f->brut_fin = restant;
+    if (restant == f->brut_taille) return -1;   /* ligne plus longue que le tampon */
+
+    do lu = pread(f->fd, f->brut + restant, f->brut_taille - restant, f->position);
+    while (lu < 0 && errno == EINTR);
+    if (lu < 0) return -1;
+    if (lu == 0) f->fin_fichier = 1;
+    f->position += lu;
+    f->brut_fin += (size_t)lu;
+    return 0;
+}
+
+/* ===== Remplissage d'un morceau ===== */
+
+static LectureCode remplir_binaire(Flux *f, Points *m, size_t debut, size_t nombre) {
+    size_t elt = f->type_fichier == POINTS_FLOAT ? sizeof(float) : sizeof(double);
+    size_t i;
+
+    if (f->type_fichier == POINTS_DOUBLE) {
+        if (lire_tout(f->fd, m->xd, nombre * elt, (off_t)(f->offset_x + debut * elt)) != 0 ||
+            lire_tout(f->fd, m->yd, nombre * elt, (off_t)(f->offset_y + debut * elt)) != 0)
+            return LECTURE_TRONQUE;
+        return LECTURE_OK;
+    }
+
+    if (lire_tout(f->fd, f->conversion, nombre * elt, (off_t)(f->offset_x + debut * elt)) != 0)
+        return LECTURE_TRONQUE;
+    for (i = 0; i < nombre; i++) m->xd[i] = f->conversion[i];
+    if (lire_tout(f->fd, f->conversion, nombre * elt, (off_t)(f->offset_y + debut * elt)) != 0)
+        return LECTURE_TRONQUE;
+    for (i = 0; i < nombre; i++) m->yd[i] = f->conversion[i];
+    return LECTURE_OK;
+}
+
+/* Lignes "x, y" comme lecture.c, la ligne devant tenir entiere dans brut */
+static LectureCode remplir_texte(Flux *f, Points *m, size_t nombre) {
+    size_t i = 0;
+
+    while (i < nombre) {
+        const char *p = f->brut + f->brut_debut;
+        const char *fin = f->brut + f->brut_fin;
+        const char *eol;
+        double x, y;
+
+        while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+            if (*p == '\n') f->ligne++;
+            p++;
+        }
+        f->brut_debut = (size_t)(p - f->brut);
+        eol = p < fin ? memchr(p, '\n', (size_t)(fin - p)) : NULL;
+        if (!eol && !f->fin_fichier) {
+            if (recharger(f) != 0) return LECTURE_FORMAT;
+            continue;
+        }
+        if (p >= fin) return LECTURE_TRONQUE;
+        if (!eol) eol = fin;
+
+        p = lecture_nombre(p, eol, &x);
+        if (!p) return LECTURE_FORMAT;
+        while (p < eol && (*p == ' ' || *p == '\t')) p++;
+        if (p >= eol || *p != ',') return LECTURE_FORMAT;
+        p = lecture_nombre(p + 1, eol, &y);
+        if (!p) return LECTURE_FORMAT;
+        while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        if (p < eol) return LECTURE_FORMAT;
+
+        m->xd[i] = x;
+        m->yd[i] = y;
+        i++;
+        f->brut_debut = (size_t)(eol - f->brut);
+    }
+    return LECTURE_OK;
+}
+
+/* ===== Thread lecteur ===== */
+
+static void *lecteur(void *arg) {
+    Flux *f = (Flux *)arg;
+    size_t lus = 0;
+    int k = 0;
+
+    for (;;) {
+        size_t nombre = f->n - lus < f->capacite ? f->n - lus : f->capacite;
+        LectureCode code = LECTURE_OK;
+
+        pthread_mutex_lock(&f->verrou);
+        while (f->pret[k]) pthread_cond_wait(&f->signal, &f->verrou);
+        pthread_mutex_unlock(&f->verrou);
+
+        if (nombre > 0) {
+            code = f->binaire ? remplir_binaire(f, &f->tampons[k], lus, nombre)
+                              : remplir_texte(f, &f->tampons[k], nombre);
+        }
+
+        pthread_mutex_lock(&f->verrou);
+        if (code != LECTURE_OK) {
+            f->erreur = code;
+            nombre = 0;
+        }
+        f->remplis[k] = nombre;
+        f->pret[k] = 1;
+        pthread_cond_broadcast(&f->signal);
+        pthread_mutex_unlock(&f->verrou);
+
+        if (nombre == 0) break;
+        lus += nombre;
+        k ^= 1;
+    }
+    return NULL;
+}
+
+LectureCode flux_parcourir(Flux *f, FluxMorceau traiter, void *ctx) {
+    pthread_t thread;
+    int k = 0;
+
+    /* tout tient dans un morceau : les passes suivantes ne relisent pas le fichier */
+    if (f->residant) {
+        traiter(ctx, &f->tampons[0]);
+        return LECTURE_OK;
+    }
+
+    f->pret[0] = f->pret[1] = 0;
+    f->erreur = LECTURE_OK;
+    f->brut_debut = f->brut_fin = 0;
+    f->position = f->debut_texte;
+    f->fin_fichier = 0;
+    f->ligne = 1;
+    if (pthread_create(&thread, NULL, lecteur, f) != 0) return LECTURE_ALLOCATION;
+
+    for (;;) {
+        Points morceau;
+        size_t nombre;
+
+        pthread_mutex_lock(&f->verrou);
+        while (!f->pret[k]) pthread_cond_wait(&f->signal, &f->verrou);
+        nombre = f->remplis[k];
+        pthread_mutex_unlock(&f->verrou);
+        if (nombre == 0) break;
+
+        morceau = f->tampons[k];
+        morceau.n = nombre;
+        traiter(ctx, &morceau);
+
+        pthread_mutex_lock(&f->verrou);
+        f->pret[k] = 0;
+        pthread_cond_broadcast(&f->signal);
+        pthread_mutex_unlock(&f->verrou);
+        k ^= 1;
+    }
+    pthread_join(thread, NULL);
+    if (f->erreur == LECTURE_OK && f->capacite == f->n) {
+        f->tampons[0].n = f->n;
+        f->residant = 1;
+    }
+    return f->erreur;
+}
+
+/* ===== Ouverture ===== */
+
+/* Entete : binaire (signature) ou premiere ligne du texte */
+static LectureCode lire_entete(Flux *f, size_t octets) {
+    char debut[4096];
+    size_t lu = octets < sizeof(debut) ? octets : sizeof(debut);
+    size_t i = 0, n = 0;
+
+    if (lire_tout(f->fd, debut, lu, 0) != 0) return LECTURE_OUVERTURE;
+
+    if (lu >= sizeof(BinaireEntete) && memcmp(debut, BINAIRE_MAGIE, 8) == 0) {
+        BinaireEntete e;
+        size_t elt;
+
+        memcpy(&e, debut, sizeof(e));
+        if (e.boutisme != BINAIRE_BOUTISME || e.type > POINTS_DOUBLE || e.n == 0) return LECTURE_ENTETE;
+        elt = e.type == POINTS_FLOAT ? sizeof(float) : sizeof(double);
+        if (e.n > ((size_t)-1) / 4 / elt) return LECTURE_ENTETE;
+        if (e.offset_x > octets || octets - e.offset_x < e.n * elt ||
+            e.offset_y > octets || octets - e.offset_y < e.n * elt)
+            return LECTURE_TRONQUE;
+        f->binaire = 1;
+        f->type_fichier = (PointsType)e.type;
+        f->n = (size_t)e.n;
+        f->offset_x = e.offset_x;
+        f->offset_y = e.offset_y;
+        return LECTURE_OK;
+    }
+
+    while (i < lu && (debut[i] == ' ' || debut[i] == '\t')) i++;
+    if (i >= lu || (unsigned)(debut[i] - '0') >= 10u) return LECTURE_ENTETE;
+    while (i < lu && (unsigned)(debut[i] - '0') < 10u) {
+        if (n > ((size_t)-1) / 10) return LECTURE_ENTETE;
+        n = n * 10 + (size_t)(debut[i] - '0');
+        i++;
+    }
+    while (i < lu && debut[i] != '\n') i++;
+    if (n == 0 || (i == lu && lu < octets)) return LECTURE_ENTETE;
+    f->n = n;
+    f->debut_texte = (off_t)i;
+    return LECTURE_OK;
+}
+
+LectureCode flux_ouvrir(const char *fichier, size_t budget, Flux **flux, LectureInfo *info) {
+    LectureInfo local;
+    LectureCode code;
+    struct stat st;
+    Flux *f;
+
+    if (!info) info = &local;
+    memset(info, 0, sizeof(*info));
+    info->ligne = 1;
+    *flux = NULL;
+    if (budget == 0) budget = FLUX_BUDGET_DEFAUT;
+
+    f = calloc(1, sizeof(*f));
+    if (!f) return LECTURE_ALLOCATION;
+    f->fd = open(fichier, O_RDONLY);
+    if (f->fd < 0 || fstat(f->fd, &st) != 0) {
+        if (f->fd >= 0) close(f->fd);
+        free(f);
+        return LECTURE_OUVERTURE;
+    }
+    info->octets = (size_t)st.st_size;
+    if (st.st_size == 0) code = LECTURE_ENTETE;
+    else code = lire_entete(f, info->octets);
+    if (code != LECTURE_OK) {
+        close(f->fd);
+        free(f);
+        return code;
+    }
+    posix_fadvise(f->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    /* moitie du budget pour les deux morceaux (16 octets par point), moitie pour le texte brut */
+    f->capacite = budget / 64;
+    if (f->capacite < MORCEAU_MIN) f->capacite = MORCEAU_MIN;
+    if (f->capacite > f->n) f->capacite = f->n;
+
+    code = LECTURE_ALLOCATION;
+    if (points_alloc(&f->tampons[0], f->capacite, POINTS_DOUBLE) != 0 ||
+        points_alloc(&f->tampons[1], f->capacite, POINTS_DOUBLE) != 0)
+        goto echec;
+    if (f->binaire && f->type_fichier == POINTS_FLOAT) {
+        f->conversion = malloc(f->capacite * sizeof(float));
+        if (!f->conversion) goto echec;
+    }
+    if (!f->binaire) {
+        f->brut_taille = budget / 2 < BRUT_MIN ? BRUT_MIN : budget / 2;
+        f->brut = malloc(f->brut_taille);
+        if (!f->brut) goto echec;
+    }
+    pthread_mutex_init(&f->verrou, NULL);
+    pthread_cond_init(&f->signal, NULL);
+    *flux = f;
+    return LECTURE_OK;
+
+echec:
+    points_free(&f->tampons[0]);
+    points_free(&f->tampons[1]);
+    free(f->conversion);
+    free(f->brut);
+    close(f->fd);
+    free(f);
+    return code;
+}
+
+size_t flux_n(const Flux *f) {
+    return f->n;
+}
+
+size_t flux_morceau(const Flux *f) {
+    return f->capacite;
+}
+
+size_t flux_ligne(const Flux *f) {
+    return f->ligne;
+}
+
+void flux_fermer(Flux *f) {
+    if (!f) return;
+    pthread_mutex_destroy(&f->verrou);
+    pthread_cond_destroy(&f->signal);
+    points_free(&f->tampons[0]);
+    points_free(&f->tampons[1]);
+    free(f->conversion);
+    free(f->brut);
+    close(f->fd);
+    free(f);
+}
@@ -0,0 +1,48 @@
+/*
+ * flux.h
+ * Parcours d'un fichier de points par morceaux, pour les jeux de donnees
+ * plus grands que la memoire.
+ *
+ * Le fichier (texte ou binaire en colonnes) est relu a chaque passe par
+ * morceaux de taille fixe. Un thread lecteur remplit un tampon pendant
+ * que l'appelant traite l'autre (double tampon) : la lecture et
+ * l'analyse du morceau suivant recouvrent le calcul sur le morceau
+ * courant. La memoire utilisee est bornee par le budget donne a
+ * l'ouverture, quel que soit n.
+ */
+
+#ifndef FLUX_H
+#define FLUX_H
+
+#include <stddef.h>
+#include "points.h"
+#include "lecture.h"
+
+#define FLUX_BUDGET_DEFAUT (64u << 20)     /* 64 Mo */
+
+typedef struct Flux Flux;
+
+/* Traitement d'un morceau (points en double, morceau->n > 0) */
+typedef void (*FluxMorceau)(void *ctx, const Points *morceau);
+
+/*
+ * Ouvre fichier et lit son entete. budget : octets de tampons (0 : defaut).
+ * info->ligne indique la ligne fautive en cas d'erreur.
+ */
+LectureCode flux_ouvrir(const char *fichier, size_t budget, Flux **flux, LectureInfo *info);
+
+/* Nombre de points annonce par l'entete */
+size_t flux_n(const Flux *f);
+
+/* Points par morceau */
+size_t flux_morceau(const Flux *f);
+
+/* Une passe complete, morceaux transmis dans l'ordre du fichier */
+LectureCode flux_parcourir(Flux *f, FluxMorceau traiter, void *ctx);
+
+/* Ligne fautive de la derniere erreur (fichier texte) */
+size_t flux_ligne(const Flux *f);
+
+void flux_fermer(Flux *f);
+
+#endif
@@ -1,28 +1,57 @@
+/*
+ * gauchy.c
+ * Regression lineaire y = a0 + a1 x par descente du gradient (menu interactif).
+ * Les sommes de chaque iteration sont reparties sur un pool de threads
+ * (REGRESSION_THREADS=k pour fixer leur nombre). En mode "moments", n, Σx, Σy,
+ * Σx², Σxy et Σy² sont calcules une fois et chaque iteration coute O(1).
+ * La methode de pas (fixe, armijo, momentum, nesterov, adam : voir optim.h)
+ * se choisit dans le menu ; un pas qui fait diverger est reduit.
+ * REGRESSION_TRACE=fichier (REGRESSION_TRACE_PAS=N) enregistre la convergence
+ * de chaque descente dans une trace binaire (trace.h, relue par trace_dump)
+ * au lieu du tableau periodique.
+ * Les graphiques passent par un gnuplot persistant (graphe.h) : fenetre si
+ * DISPLAY est defini, sinon regression_plot.png ; le menu n'attend pas le rendu.
+ * Le choix 6 donne des intervalles de confiance de a0 et a1 par bootstrap
+ * (bootstrap.h, REGRESSION_BOOTSTRAP=B repliques).
+ * Compilation : gcc gauchy.c points.c lecture.c pool.c moments.c optim.c trace.c graphe.c reduction.c ecriture.c bootstrap.c lm.c expvec.c -o gauchy -lm -pthread
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include "points.h"
+#include "lecture.h"
+#include "pool.h"
+#include "moments.h"
+#include "graphe.h"
+#include "ecriture.h"
+#include "optim.h"
+#include "ajuste.h"
+#include "trace.h"
+#include "bootstrap.h"
 
 /* ===== PROTOTYPES ===== */
 
 /* Fonctions de lecture et affichage */
-void getDataf(char *filename, float ***data, int *n, int *max_points);
-void displayPoints(float **data, int n);
+void getDataf(char *filename, Points *pts);
+void displayPoints(const Points *pts);
 void displayResults(float a0, float a1, float cost, int iterations_used);
+void displayBootstrap(const Points *pts);
 
 /* Fonctions de calcul */
-float computeCost(float **data, int n, float a0, float a1);
-int gradientDescent(float **data, int n, float *a0, float *a1, 
+float computeCost(const Points *pts, float a0, float a1);
+float evaluateCost(const Points *pts, const Moments *moments, float a0, float a1);
+int gradientDescent(const Points *pts, const Moments *moments, float *a0, float *a1, 
                      float learning_rate, int max_iterations, 
-                     float convergence_threshold);
+                     float convergence_threshold, OptimMethode methode,
+                     OptimResultat *resultat);
 
 /* Fonctions pour gnuplot */
-void generatePlotData(float **data, int n, float a0, float a1, char *datafile, char *fitfile);
-void plotWithGnuplot(float **data, int n, float a0, float a1, int iterations_used);
+void plotWithGnuplot(Graphe *graphe, const Points *pts, float a0, float a1, int iterations_used);
 
 /* Fonctions utilitaires */
-void freeMemory(float **data, int n);
-void error(char *message);
+void error(const char *message);
 void initParameters(int *max_points, float *learning_rate, 
                     int *max_iterations, float *convergence_threshold);
 
@@ -31,22 +60,30 @@ int main(void) {
     printf("Regression lineaire par descente du gradient\n");
     printf("===========================================\n\n");
 // donnees    
-    float **data = NULL;
-    int n = 0;
+    Points pts;
     float a0 = 0.0f, a1 = 0.0f;
     int iterations_used = 0;
     int regression_faite = 0;  // 0 = non, 1 = oui
+    Graphe *graphe = NULL;     // gnuplot lance au premier trace
     
 // Variables pour les paramètres (fixes)
-    int max_points = 1000;
     float learning_rate = 0.01f;
     int max_iterations = 10000;
     float convergence_threshold = 0.0001f;
+    int mode_moments = 1;  // 1 = moments precalcules, 0 = passe sur les donnees
+    OptimMethode methode = OPTIM_FIXE;
+    OptimResultat detail;
+    Moments moments;
     
 // Lecture des données depuis le fichier
-    getDataf("donnees.txt", &data, &n, &max_points);
+    getDataf("donnees.txt", &pts);
+    
+// Moments des données, calculés une seule fois
+    moments_init(&moments);
+    moments_ajouter_points(&moments, &pts);
     
-    printf("Nombre de points de donnees: %d\n\n", n);
+    printf("Nombre de points de donnees: %zu\n", pts.n);
+    printf("Threads de calcul: %d\n\n", pool_threads(pool_defaut()));
     
 // Menu de choix
     int choix;
@@ -55,6 +92,10 @@ int main(void) {
         printf("1. Effectuer la regression et afficher les resultats\n");
         printf("2. Generer un graphique avec gnuplot\n");
         printf("3. Quitter\n");
+        printf("4. Changer le mode de calcul (actuel: %s)\n", 
+               mode_moments ? "moments precalcules" : "passe sur les donnees");
+        printf("5. Changer la methode de pas (actuelle: %s)\n", optim_nom(methode));
+        printf("6. Intervalles de confiance (bootstrap)\n");
         printf("Votre choix: ");
         scanf("%d", &choix);
         
@@ -64,13 +105,16 @@ int main(void) {
                 
                 // Afficher les paramètres utilisés
                 printf("Parametres d'optimisation:\n");
-                printf("  Taux d'apprentissage: %f\n", learning_rate);
+                printf("  Taux d'apprentissage: %f (methode de pas: %s)\n", learning_rate, optim_nom(methode));
                 printf("  Nombre maximum d'iterations: %d\n", max_iterations);
                 printf("  Seuil de convergence: %f\n", convergence_threshold);
+                printf("  Mode de calcul: %s\n", mode_moments ? 
+                       "moments precalcules (O(1) par iteration)" : 
+                       "passe sur les donnees (O(n) par iteration)");
                 printf("\n");
                 
                 // Afficher les données
-                displayPoints(data, n);
+                displayPoints(&pts);
                 
                 // Initialisation des coefficients
                 a0 = 0.0f;
@@ -78,13 +122,13 @@ int main(void) {
                 
                 // Résolution par descente du gradient
                 printf("\n=== DESCENTE DU GRADIENT EN COURS ===\n");
-                iterations_used = gradientDescent(data, n, &a0, &a1, 
+                iterations_used = gradientDescent(&pts, mode_moments ? &moments : NULL, &a0, &a1, 
                                learning_rate, 
                                max_iterations, 
-                               convergence_threshold);
+                               convergence_threshold, methode, &detail);
                 
                 // Calcul du coût final
-                float final_cost = computeCost(data, n, a0, a1);
+                float final_cost = evaluateCost(&pts, mode_moments ? &moments : NULL, a0, a1);
                 
                 // Affichage détaillé des résultats
                 printf("\n=== RESULTATS DETAILLES ===\n");
@@ -94,24 +138,20 @@ int main(void) {
                 printf("  Pente (a1): %.6f\n", a1);
                 printf("\nMetriques d'erreur:\n");
                 printf("  Erreur quadratique moyenne: %.6f\n", final_cost);
-                printf("  Racine de l'erreur quadratique moyenne: %.6f\n", sqrtf(final_cost * 2.0f * n));
+                printf("  Racine de l'erreur quadratique moyenne: %.6f\n", sqrtf(final_cost * 2.0f * pts.n));
                 printf("\nPerformances d'optimisation:\n");
                 printf("  Iterations utilisees: %d\n", iterations_used);
                 printf("  Iterations maximum autorisees: %d\n", max_iterations);
+                printf("  Evaluations du cout et du gradient: %d\n", detail.evaluations);
+                printf("  Reculs sur divergence: %d (pas final: %g)\n", detail.reculs, detail.pas);
                 printf("  Pourcentage d'iterations utilisees: %.1f%%\n", 
                        (iterations_used * 100.0f) / max_iterations);
-                if (iterations_used < max_iterations) {
+                if (detail.raison == OPTIM_CONVERGE) {
                     printf("  Convergence: ATTEINTE\n");
                 } else {
-                    printf("  Convergence: NON ATTEINTE (maximum d'iterations)\n");
-                }
-                printf("\nVerification avec les donnees:\n");
-                for (int i = 0; i < n; i++) {
-                    float prediction = a0 + a1 * data[i][0];
-                    float erreur = prediction - data[i][1];
-                    printf("  Point %d: x=%.3f, y_reel=%.3f, y_pred=%.3f, erreur=%.3f\n", 
-                           i+1, data[i][0], data[i][1], prediction, erreur);
+                    printf("  Convergence: NON ATTEINTE (%s)\n", optim_raison(detail.raison));
                 }
+                ecriture_verification(pts.xf, pts.yf, pts.n, a0, a1);
                 printf("====================================\n");
                 
                 regression_faite = 1;
@@ -131,11 +171,11 @@ int main(void) {
                         printf("\n=== REGRESSION EN COURS ===\n");
                         a0 = 0.0f;
                         a1 = 0.0f;
-                        iterations_used = gradientDescent(data, n, &a0, &a1, 
+                        iterations_used = gradientDescent(&pts, mode_moments ? &moments : NULL, &a0, &a1, 
                                        learning_rate, 
                                        max_iterations, 
-                                       convergence_threshold);
-                        float final_cost = computeCost(data, n, a0, a1);
+                                       convergence_threshold, methode, &detail);
+                        float final_cost = evaluateCost(&pts, mode_moments ? &moments : NULL, a0, a1);
                         printf("\nRegression terminee:\n");
                         printf("  a0 = %.6f, a1 = %.6f\n", a0, a1);
                         printf("  Erreur = %.6f, Iterations = %d\n", final_cost, iterations_used);
@@ -147,7 +187,8 @@ int main(void) {
                 }
                 
                 printf("\nGeneration du graphique...\n");
-                plotWithGnuplot(data, n, a0, a1, iterations_used);
+                if (!graphe) graphe = graphe_ouvrir(getenv("DISPLAY") ? NULL : "regression_plot.png");
+                plotWithGnuplot(graphe, &pts, a0, a1, iterations_used);
                 break;
             }
             
@@ -155,13 +196,29 @@ int main(void) {
                 printf("\nAu revoir!\n");
                 break;
                 
+            case 4:
+                mode_moments = !mode_moments;
+                printf("\nMode de calcul: %s\n", 
+                       mode_moments ? "moments precalcules" : "passe sur les donnees");
+                break;
+                
+            case 5:
+                methode = (OptimMethode)((methode + 1) % OPTIM_NOMBRE);
+                printf("\nMethode de pas: %s\n", optim_nom(methode));
+                break;
+                
+            case 6:
+                displayBootstrap(&pts);
+                break;
+                
             default:
-                printf("Choix invalide! Veuillez choisir 1, 2 ou 3.\n");
+                printf("Choix invalide! Veuillez choisir 1, 2, 3, 4, 5 ou 6.\n");
         }
     } while (choix != 3);
     
-    // Libération de la mémoire
-    freeMemory(data, n);
+    // Libération de la mémoire (le dernier trace demande est termine)
+    graphe_fermer(graphe);
+    points_free(&pts);
     
     return 0;
 }
@@ -169,262 +226,137 @@ int main(void) {
 /* ===== DEFINITIONS DES FONCTIONS ===== */
 
 /* ===== Lecture des données depuis fichier ===== */
-void getDataf(char *filename, float ***data, int *n, int *max_points) {
-    FILE *pf = NULL;
-    int i;
-    char ligne[100];
-    char *token;
+void getDataf(char *filename, Points *pts) {
+    LectureInfo info;
+    LectureCode code = lecture_points(filename, pts, POINTS_FLOAT, &info);
     
-    if ((pf = fopen(filename, "r")) == NULL) {
-        error("Probleme a l'ouverture du fichier...");
+    if (code == LECTURE_FORMAT || code == LECTURE_TRONQUE) {
+        printf("Ligne %zu du fichier '%s'\n", info.ligne, filename);
     }
-    
-    // Lire le nombre de points (première ligne)
-    if (fgets(ligne, sizeof(ligne), pf) == NULL) {
-        error("Erreur de lecture de la premiere ligne...");
-    }
-    
-    *n = atoi(ligne);
-    if (*n <= 0 || *n > *max_points) {
-        error("Nombre de points invalide...");
-    }
-    
-    // Allocation de la matrice pour stocker les points
-    *data = (float **)malloc((*n) * sizeof(float *));
-    if (!(*data)) error("Probleme d'allocation memoire pour les donnees...");
-    
-    for (i = 0; i < *n; i++) {
-        (*data)[i] = (float *)malloc(2 * sizeof(float));
-        if (!(*data)[i]) error("Probleme d'allocation memoire pour les points...");
-    }
-    
-    // Lire chaque ligne de données
-    for (i = 0; i < *n; i++) {
-        if (fgets(ligne, sizeof(ligne), pf) == NULL) {
-            error("Erreur de lecture des donnees...");
-        }
-        
-        // Supprimer le retour à la ligne
-        ligne[strcspn(ligne, "\n")] = 0;
-        
-        // Parser la ligne: format "x, y"
-        token = strtok(ligne, ",");
-        if (token == NULL) {
-            error("Format de donnees invalide (x manquant)...");
-        }
-        (*data)[i][0] = atof(token);  // x
-        
-        token = strtok(NULL, ",");
-        if (token == NULL) {
-            error("Format de donnees invalide (y manquant)...");
-        }
-        (*data)[i][1] = atof(token);  // y
+    if (code != LECTURE_OK) {
+        error(lecture_message(code));
     }
     
-    fclose(pf);
+    printf("Lecture: %.3f Mo en %.3f s (%.1f Mo/s)\n", 
+           info.octets / (1024.0 * 1024.0), info.secondes, lecture_debit(&info));
 }
 
 /* ===== Descente du gradient ===== */
-int gradientDescent(float **data, int n, float *a0, float *a1, 
+
+// Affichage tous les 1000 itérations
+static void suiviDroite(int iteration, const double p[2], double cost) {
+    if (iteration % 1000 == 0) {
+        printf("%6d    %8.4f  %8.4f  %8.4f\n", iteration, p[0], p[1], cost);
+    }
+}
+
+// Descente de ajuste.h instanciee en float : a0 et a1 restent des float
+int gradientDescent(const Points *pts, const Moments *moments, float *a0, float *a1, 
                      float learning_rate, int max_iterations, 
-                     float convergence_threshold) {
-    float temp_a0, temp_a1;
-    float grad_a0, grad_a1;
-    int iteration;
-    int i;
+                     float convergence_threshold, OptimMethode methode,
+                     OptimResultat *resultat) {
+    OptimOptions options;
+    OptimResultat r;
+    Trace trace;
+    int tracee = trace_env(&trace, optim_nom(methode));
+    
+    // Arret quand chaque coefficient bouge de moins que le seuil
+    optim_options_defaut(&options, methode, learning_rate, convergence_threshold, max_iterations);
+    options.norme_max = 1;
+    if (tracee < 0) {
+        printf("Trace de convergence impossible (REGRESSION_TRACE)\n");
+    }
+    if (tracee > 0) {
+        // Trace binaire au lieu du tableau periodique
+        options.trace = &trace;
+        printf("Trace: %s, une iteration sur %lld\n", getenv("REGRESSION_TRACE"), (long long)trace.pas);
+    } else {
+        options.suivi = suiviDroite;
+    }
     
     printf("Iteration    a0        a1        Cout\n");
     printf("-------------------------------------\n");
     
-    for (iteration = 0; iteration < max_iterations; iteration++) {
-        // Initialisation des gradients
-        grad_a0 = 0.0f;
-        grad_a1 = 0.0f;
-        
-        // Calcul des gradients
-        for (i = 0; i < n; i++) {
-            float prediction = *a0 + *a1 * data[i][0];
-            float error = prediction - data[i][1];
-            
-            grad_a0 += error;
-            grad_a1 += error * data[i][0];
-        }
-        
-        // Moyenne des gradients
-        grad_a0 /= (float)n;
-        grad_a1 /= (float)n;
-        
-        // Mise à jour des paramètres
-        temp_a0 = *a0 - learning_rate * grad_a0;
-        temp_a1 = *a1 - learning_rate * grad_a1;
-        
-        // Vérification de la convergence
-        if (fabsf(temp_a0 - *a0) < convergence_threshold && 
-            fabsf(temp_a1 - *a1) < convergence_threshold) {
-            float cost = computeCost(data, n, *a0, *a1);
-            printf("%6d    %8.4f  %8.4f  %8.4f  (Convergence)\n", 
-                   iteration, *a0, *a1, cost);
-            *a0 = temp_a0;
-            *a1 = temp_a1;
-            return iteration + 1;
-        }
-        
-        *a0 = temp_a0;
-        *a1 = temp_a1;
-        
-        // Affichage tous les 1000 itérations
-        if (iteration % 1000 == 0) {
-            float cost = computeCost(data, n, *a0, *a1);
-            printf("%6d    %8.4f  %8.4f  %8.4f\n", 
-                   iteration, *a0, *a1, cost);
-        }
+    // Gradients moyens par les moments en O(1), ou par une passe sur les
+    // donnees repartie sur les threads du pool
+    if (moments) {
+        r = ajuste_droitef_descente_moments(moments, a0, a1, &options);
+    } else {
+        r = ajuste_droitef_descente(pts->xf, pts->yf, pts->n, a0, a1, &options);
+    }
+    if (tracee > 0 && trace_fermer(&trace) != 0) {
+        printf("Ecriture de la trace incomplete\n");
     }
     
-    // Dernier affichage
-    float final_cost = computeCost(data, n, *a0, *a1);
-    printf("%6d    %8.4f  %8.4f  %8.4f  (Maximum atteint)\n", 
-           max_iterations - 1, *a0, *a1, final_cost);
+    // Dernier affichage : a la convergence, le point d'avant le dernier pas
+    if (r.raison == OPTIM_CONVERGE) {
+        printf("%6d    %8.4f  %8.4f  %8.4f  (Convergence)\n", r.iterations - 1,
+               r.precedent[0], r.precedent[1], r.cout_precedent);
+    } else {
+        printf("%6d    %8.4f  %8.4f  %8.4f  (Maximum atteint)\n", r.iterations - 1, *a0, *a1, r.cout);
+    }
+    if (r.reculs > 0) {
+        printf("Divergence detectee %d fois, pas reduit a %g\n", r.reculs, r.pas);
+    }
     
-    return max_iterations;
+    if (resultat) *resultat = r;
+    return r.iterations;
 }
 
 /* ===== Calcul du coût ===== */
-float computeCost(float **data, int n, float a0, float a1) {
-    float cost = 0.0f;
-    int i;
-    
-    for (i = 0; i < n; i++) {
-        float prediction = a0 + a1 * data[i][0];
-        float error = prediction - data[i][1];
-        cost += error * error;
-    }
-    return cost / (2.0f * (float)n);
+float computeCost(const Points *pts, float a0, float a1) {
+    return (float)ajuste_droitef_cout(pts->xf, pts->yf, pts->n, a0, a1);
 }
 
-/* ===== Génération des fichiers pour gnuplot ===== */
-void generatePlotData(float **data, int n, float a0, float a1, char *datafile, char *fitfile) {
-    FILE *fdata = fopen(datafile, "w");
-    FILE *ffit = fopen(fitfile, "w");
-    int i;
-    
-    if (!fdata || !ffit) {
-        printf("Erreur lors de la creation des fichiers pour gnuplot.\n");
-        if (fdata) fclose(fdata);
-        if (ffit) fclose(ffit);
-        return;
-    }
-    
-    // Écrire les données dans le fichier
-    for (i = 0; i < n; i++) {
-        fprintf(fdata, "%.6f %.6f\n", data[i][0], data[i][1]);
-    }
-    
-    // Trouver les limites x
-    float xmin = data[0][0];
-    float xmax = data[0][0];
-    for (i = 1; i < n; i++) {
-        if (data[i][0] < xmin) xmin = data[i][0];
-        if (data[i][0] > xmax) xmax = data[i][0];
+/* Coût par les moments si disponibles, sinon par une passe sur les données */
+float evaluateCost(const Points *pts, const Moments *moments, float a0, float a1) {
+    if (moments) {
+        return (float)moments_cout(moments, a0, a1);
     }
-    
-    // Étendre un peu les limites
-    xmin = xmin - 0.1 * (xmax - xmin);
-    xmax = xmax + 0.1 * (xmax - xmin);
-    
-    // Générer la droite de régression
-    float step = (xmax - xmin) / 100.0f;
-    for (float x = xmin; x <= xmax; x += step) {
-        float y = a0 + a1 * x;
-        fprintf(ffit, "%.6f %.6f\n", x, y);
-    }
-    
-    fclose(fdata);
-    fclose(ffit);
+    return computeCost(pts, a0, a1);
 }
 
-/* ===== Fonction pour créer et exécuter un script gnuplot ===== */
-void plotWithGnuplot(float **data, int n, float a0, float a1, int iterations_used) {
-    // Générer les fichiers de données
-    generatePlotData(data, n, a0, a1, "donnees_plot.txt", "droite_plot.txt");
-    
-    // Créer le script gnuplot
-    FILE *gnuplot_script = fopen("regression.gnu", "w");
-    if (!gnuplot_script) {
-        printf("Erreur lors de la creation du script gnuplot.\n");
-        return;
-    }
-    
-    // Trouver les limites
-    float xmin = data[0][0];
-    float xmax = data[0][0];
-    float ymin = data[0][1];
-    float ymax = data[0][1];
-    
-    for (int i = 1; i < n; i++) {
-        if (data[i][0] < xmin) xmin = data[i][0];
-        if (data[i][0] > xmax) xmax = data[i][0];
-        if (data[i][1] < ymin) ymin = data[i][1];
-        if (data[i][1] > ymax) ymax = data[i][1];
+/* ===== Trace par le processus gnuplot persistant (graphe.h) ===== */
+void plotWithGnuplot(Graphe *graphe, const Points *pts, float a0, float a1, int iterations_used) {
+    const float *x = pts->xf;
+    float xd[2], yd[2];
+    char titre[GRAPHE_TEXTE];
+    
+    // Droite de regression sur l'etendue des x elargie de 10 %
+    float xmin = x[0];
+    float xmax = x[0];
+    for (size_t i = 1; i < pts->n; i++) {
+        if (x[i] < xmin) xmin = x[i];
+        if (x[i] > xmax) xmax = x[i];
     }
-    
-    // Ajouter des marges
     float xrange = xmax - xmin;
-    float yrange = ymax - ymin;
-    xmin -= 0.1 * xrange;
-    xmax += 0.1 * xrange;
-    ymin -= 0.1 * yrange;
-    ymax += 0.1 * yrange;
-    
-    fprintf(gnuplot_script, "# Script gnuplot pour la regression lineaire\n");
-    fprintf(gnuplot_script, "set terminal pngcairo enhanced font 'Arial,12' size 800,600\n");
-    fprintf(gnuplot_script, "set output 'regression_plot.png'\n");
-    fprintf(gnuplot_script, "set title 'Regression lineaire\\n");
-    fprintf(gnuplot_script, "y = %.4f + %.4f x (Iterations: %d)'\n", a0, a1, iterations_used);
-    fprintf(gnuplot_script, "set xlabel 'x'\n");
-    fprintf(gnuplot_script, "set ylabel 'y'\n");
-    fprintf(gnuplot_script, "set grid\n");
-    fprintf(gnuplot_script, "set key top left\n");
-    fprintf(gnuplot_script, "set xrange [%f:%f]\n", xmin, xmax);
-    fprintf(gnuplot_script, "set yrange [%f:%f]\n", ymin, ymax);
-    fprintf(gnuplot_script, "\n");
-    fprintf(gnuplot_script, "plot 'donnees_plot.txt' with points pt 7 ps 1.5 lc rgb 'blue' title 'Donnees', \\\n");
-    fprintf(gnuplot_script, "     'droite_plot.txt' with lines lw 2 lc rgb 'red' title 'Droite de regression'\n");
-    
-    fclose(gnuplot_script);
-    
-    // Exécuter gnuplot
-    printf("Execution de gnuplot...\n");
-    int result = system("gnuplot regression.gnu");
-    
-    if (result == 0) {
-        printf("\nGraphique genere avec succes!\n");
-        printf("Fichier cree: regression_plot.png\n");
-        
-        // Essayer d'afficher l'image
-        #ifdef _WIN32
-            system("start regression_plot.png");
-        #elif __APPLE__
-            system("open regression_plot.png");
-        #else
-            system("xdg-open regression_plot.png 2>/dev/null &");
-        #endif
-    } else {
-        printf("\nErreur: gnuplot non trouve ou erreur d'execution.\n");
-        printf("Installez gnuplot:\n");
-        printf("  Ubuntu: sudo apt install gnuplot\n");
-        printf("  Mac: brew install gnuplot\n");
-        printf("  Windows: telechargez depuis gnuplot.info\n");
+    xd[0] = xmin - 0.1f * xrange;
+    xd[1] = xmax + 0.1f * xrange;
+    yd[0] = ajuste_droitef_valeur(a0, a1, xd[0]);
+    yd[1] = ajuste_droitef_valeur(a0, a1, xd[1]);
+    
+    GrapheSerie series[2] = {
+        { pts->xf, pts->yf, pts->n, "points pt 7 ps 1.5 lc rgb 'blue'", "Donnees" },
+        { xd, yd, 2, "lines lw 2 lc rgb 'red'", "Droite de regression" },
+    };
+    snprintf(titre, sizeof(titre), "Regression lineaire\ny = %.4f + %.4f x (Iterations: %d)", a0, a1, iterations_used);
+    
+    // Les donnees sont copiees : le rendu se fait en arriere-plan
+    if (!graphe || graphe_tracer(graphe, titre, series, 2) != 0) {
+        printf("\nErreur: impossible de lancer le trace.\n");
+        return;
     }
+    printf("Trace envoye a gnuplot (%s).\n", getenv("DISPLAY") ? "fenetre" : "regression_plot.png");
 }
 
 /* ===== Fonctions d'affichage ===== */
-void displayPoints(float **data, int n) {
-    int i;
+void displayPoints(const Points *pts) {
+    size_t i;
     
-    printf("Donnees chargees (%d points):\n", n);
+    printf("Donnees chargees (%zu points):\n", pts->n);
     printf("-----------------------------\n");
-    for (i = 0; i < n; i++) {
-        printf("  [%d] x = %6.3f, y = %6.3f\n", i+1, data[i][0], data[i][1]);
+    for (i = 0; i < pts->n; i++) {
+        printf("  [%zu] x = %6.3f, y = %6.3f\n", i+1, pts->xf[i], pts->yf[i]);
     }
     printf("\n");
 }
@@ -437,21 +369,27 @@ void displayResults(float a0, float a1, float cost, int iterations_used) {
     printf("  Iterations = %d\n", iterations_used);
 }
 
-/* ===== Fonctions utilitaires ===== */
-void freeMemory(float **data, int n) {
-    int i;
-    
-    if (data) {
-        for (i = 0; i < n; i++) {
-            if (data[i]) {
-                free(data[i]);
-            }
-        }
-        free(data);
+/* ===== Intervalles de confiance par bootstrap (bootstrap.h) ===== */
+void displayBootstrap(const Points *pts) {
+    BootstrapOptions opt;
+    BootstrapResultat res;
+    const char *noms[2] = { "a0", "a1" };
+    int code;
+    
+    bootstrap_options_defaut(&opt);
+    printf("\n=== BOOTSTRAP (%d repliques sur %d threads, niveau %.0f%%) ===\n", opt.repliques,
+           pool_threads(pool_defaut()), 100.0 * opt.niveau);
+    code = bootstrap_droite(pts, &opt, &res);
+    if (code != 0) {
+        printf("Erreur: %s\n", code == -2 ? "memoire insuffisante" : "x constants ou trop peu de points");
+        return;
     }
+    printf("Chaque replique est resolue exactement (le minimum que la descente approche):\n");
+    bootstrap_afficher(&res, noms);
 }
 
-void error(char *message) {
+/* ===== Fonctions utilitaires ===== */
+void error(const char *message) {
     printf("\n=== ERREUR ===\n");
     printf("%s\n", message);
     printf("==============\n");
@@ -4,71 +4,95 @@
     première ligne : nombre de points n
     puis n lignes : x, y
 
-  Compilation : gcc gauchy_exp.c -o gauchy_exp -lm
+  Usage : ./gauchy_exp [lm|sgd|fixe|armijo|momentum|nesterov|adam] [init] [bootstrap[=B]]
+    lm   : Levenberg-Marquardt au lieu de la descente du gradient
+    sgd  : gradient stochastique en mini-lots (sgd.h), quelques epoques
+           au lieu de centaines de milliers de passes completes
+    fixe|armijo|momentum|nesterov|adam : méthode de pas de la descente du
+           gradient (optim.h, défaut fixe) ; un pas qui diverge est réduit
+    multi[=K] : K départs en parallèle (défaut 16, descente ou lm) répartis
+           en b, les départs sans espoir abandonnés en route (departs.h)
+    init : départ de la droite des moindres carrés de ln y (y > 0, poids y²) ;
+           le solveur tourne aussi depuis (1.0, 0.1) pour comparer les itérations
+    bootstrap[=B] : intervalles de confiance percentile et BCa de a et b
+           (bootstrap.h) sur B répliques (défaut REGRESSION_BOOTSTRAP ou
+           2000), chacune ajustée par lm depuis (a, b) trouvés
+  REGRESSION_TRACE=fichier [REGRESSION_TRACE_PAS=N] : trace binaire de la
+    convergence (trace.h, relue par trace_dump) au lieu de l'affichage
+    périodique ; descente et lm sans multi
+
+  Coût, descente et Levenberg-Marquardt sont ceux de ajuste.h (ajuste_exp),
+  sommes réparties sur le pool de threads.
+
+  Compilation : gcc -O2 gauchy_exp.c points.c lecture.c pool.c expvec.c lm.c sgd.c optim.c departs.c moments.c trace.c bootstrap.c -o gauchy_exp -lm -pthread
 */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include "points.h"
+#include "lecture.h"
+#include "pool.h"
+#include "expvec.h"
+#include "lm.h"
+#include "sgd.h"
+#include "optim.h"
+#include "departs.h"
+#include "moments.h"
+#include "ajuste.h"
+#include "trace.h"
+#include "bootstrap.h"
 
-void read_data(const char *filename, double **x, double **y, int *n) {
-    FILE *f = fopen(filename, "r");
-    if (!f) { perror("fopen"); exit(1); }
-    if (fscanf(f, "%d\n", n) != 1) { fprintf(stderr, "Format attendu : n en première ligne\n"); fclose(f); exit(1); }
-    *x = (double*)malloc((*n) * sizeof(double));
-    *y = (double*)malloc((*n) * sizeof(double));
-    for (int i = 0; i < *n; i++) {
-        double xi, yi;
-        if (fscanf(f, "%lf , %lf\n", &xi, &yi) != 2) {
-            // essayer sans espace après la virgule
-            fseek(f, 0, SEEK_SET);
-            // saut de la première ligne
-            char buffer[256]; fgets(buffer, sizeof(buffer), f);
-            for (int j = 0; j < *n; j++) {
-                if (fscanf(f, "%lf , %lf\n", &xi, &yi) != 2) {
-                    fprintf(stderr, "Erreur de lecture des données à la ligne %d\n", j+2);
-                    fclose(f); exit(1);
-                }
-                (*x)[j] = xi; (*y)[j] = yi;
-            }
-            break;
-        }
-        (*x)[i] = xi; (*y)[i] = yi;
+void read_data(const char *filename, Points *pts) {
+    LectureInfo info;
+    LectureCode code = lecture_points(filename, pts, POINTS_DOUBLE, &info);
+    if (code != LECTURE_OK) {
+        fprintf(stderr, "%s : %s (ligne %zu)\n", filename, lecture_message(code), info.ligne);
+        exit(1);
     }
-    fclose(f);
+    printf("Lecture: %.3f Mo en %.3f s (%.1f Mo/s)\n",
+           info.octets / (1024.0 * 1024.0), info.secondes, lecture_debit(&info));
 }
 
-double cost(const double *x, const double *y, int n, double a, double b) {
-    double s = 0.0;
-    for (int i = 0; i < n; i++) {
-        double pred = a * exp(b * x[i]);
-        double e = pred - y[i];
-        s += e * e;
+int main(int argc, char **argv) {
+    const char *filename = "donnees.txt";
+    int methode_lm = 0, methode_sgd = 0, init_log = 0, multi = 0, bootstrap = 0;
+    OptimMethode pas = OPTIM_FIXE;
+    BootstrapOptions bopt;
+    bootstrap_options_defaut(&bopt);
+    for (int k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "lm") == 0) methode_lm = 1;
+        else if (strcmp(argv[k], "sgd") == 0) methode_sgd = 1;
+        else if (strcmp(argv[k], "init") == 0) init_log = 1;
+        else if (strcmp(argv[k], "multi") == 0) multi = 16;
+        else if (strncmp(argv[k], "multi=", 6) == 0 && departs_nombre(argv[k] + 6, &multi) == 0) continue;
+        else if (strcmp(argv[k], "bootstrap") == 0) bootstrap = 1;
+        else if (strncmp(argv[k], "bootstrap=", 10) == 0) {
+            bootstrap = 1;
+            bopt.repliques = atoi(argv[k] + 10);
+        }
+        else if (optim_depuis_nom(argv[k], &pas) == 0) continue;
+        else {
+            fprintf(stderr, "Usage : %s [lm|sgd|fixe|armijo|momentum|nesterov|adam] [init|multi[=K]] [bootstrap[=B]]\n"
+                            "        K entre 1 et %d\n", argv[0], DEPARTS_MAX);
+            return 1;
+        }
     }
-    return s / (2.0 * n);
-}
-
-void gradient_step(const double *x, const double *y, int n, double a, double b, double *ga, double *gb) {
-    // Cost J = (1/(2n)) sum (a e^{b x_i} - y_i)^2
-    // dJ/da = (1/n) sum (a e^{b x_i} - y_i) * e^{b x_i}
-    // dJ/db = (1/n) sum (a e^{b x_i} - y_i) * a * x_i * e^{b x_i}
-    double sga = 0.0, sgb = 0.0;
-    for (int i = 0; i < n; i++) {
-        double ebx = exp(b * x[i]);
-        double pred = a * ebx;
-        double diff = pred - y[i];
-        sga += diff * ebx;            // = (a e^{b xi} - yi) e^{b xi}
-        sgb += diff * a * x[i] * ebx; // = (a e^{b xi} - yi) * a * xi * e^{b xi}
+    if (methode_lm && methode_sgd) {
+        fprintf(stderr, "Choisir lm ou sgd\n");
+        return 1;
     }
-    *ga = sga / (double)n;
-    *gb = sgb / (double)n;
-}
-
-int main(void) {
-    const char *filename = "donnees.txt";
-    double *x = NULL, *y = NULL; int n = 0;
-    read_data(filename, &x, &y, &n);
+    if (multi && (methode_sgd || init_log)) {
+        fprintf(stderr, "multi : sans sgd ni init\n");
+        return 1;
+    }
+    if (bootstrap && bopt.repliques < 2) {
+        fprintf(stderr, "bootstrap : au moins 2 repliques\n");
+        return 1;
+    }
+    Points pts;
+    read_data(filename, &pts);
 
     // Paramètres initiaux selon l'énoncé proposé
     double a = 1.0;
@@ -77,59 +101,175 @@ int main(void) {
     double eps = 0.001; // critère d'arrêt pour la norme des différences de paramètres
     int max_iter = 200000;
 
-    printf("Ajustement exponentiel f(x)=a*exp(b x) par descente du gradient\n");
-    printf("Points: %d\n", n);
-    printf("Init: a=%.6f, b=%.6f, lr=%.6f, eps=%.6f\n", a, b, learning_rate, eps);
-
-    double prev_a = a, prev_b = b;
-    int iter;
-    for (iter = 0; iter < max_iter; iter++) {
-        double ga, gb;
-        gradient_step(x, y, n, a, b, &ga, &gb);
-        // mise à jour
-        prev_a = a; prev_b = b;
-        a -= learning_rate * ga;
-        b -= learning_rate * gb;
-
-        double da = a - prev_a;
-        double db = b - prev_b;
-        if (sqrt(da*da + db*db) < eps) {
-            break;
+    const char *methode = methode_lm ? "Levenberg-Marquardt"
+                        : methode_sgd ? "gradient stochastique" : "descente du gradient";
+    printf("Ajustement exponentiel f(x)=a*exp(b x) par %s\n", methode);
+    printf("Points: %zu\n", pts.n);
+    printf("Noyau exponentiel: %s\n", expvec_isa());
+
+    int iterations, iterations_sans_init = 0;
+    LmResultat lm = { 0 };
+    LmOptions opt;
+    lm_options_defaut(&opt);
+    SgdResultat sgd = { 0 };
+    SgdOptions sopt;
+    sgd_options_defaut(&sopt);
+    OptimResultat gd = { 0 };
+    OptimOptions gopt;
+    optim_options_defaut(&gopt, pas, learning_rate, eps, max_iter);
+
+    if (init_log) {
+        // même solveur depuis le départ de l'énoncé, pour comparaison
+        double a0 = a, b0 = b;
+        if (methode_lm) iterations_sans_init = ajuste_exp_lm(pts.xd, pts.yd, pts.n, a0, b0, &opt).iterations;
+        else if (methode_sgd) iterations_sans_init = sgd_exponentiel(&pts, a0, b0, &sopt).epoques;
+        else iterations_sans_init = ajuste_exp_descente(pts.xd, pts.yd, pts.n, &a0, &b0, &gopt).iterations;
+
+        if (moments_exponentielle(&pts, &a, &b) != 0) {
+            printf("Depart log-lineaire impossible (moins de deux y > 0), depart par defaut\n");
+            init_log = 0;
         }
-        // affichage périodique
-        if (iter % 5000 == 0) {
-            double c = cost(x,y,n,a,b);
-            printf("it=%6d  a=%.6f  b=%.6f  cost=%.6f\n", iter, a, b, c);
+    }
+
+    DepartsOptions dopt;
+    DepartsResultat dep;
+    departs_options_defaut(&dopt, multi, methode_lm);
+    dopt.descente = gopt;
+
+    // trace binaire de la convergence (REGRESSION_TRACE) : remplace l'affichage périodique
+    Trace trace;
+    int tracee = multi || methode_sgd ? 0 : trace_env(&trace, methode_lm ? "lm" : optim_nom(pas));
+    if (tracee < 0) {
+        fprintf(stderr, "Trace de convergence impossible (REGRESSION_TRACE)\n");
+        return 1;
+    }
+    if (tracee) {
+        opt.trace = gopt.trace = &trace;
+        printf("Trace: %s, une iteration sur %lld\n", getenv("REGRESSION_TRACE"), (long long)trace.pas);
+    }
+
+    if (multi) {
+        printf("Departs: %d sur %d threads, a optimal pour chaque b de depart\n",
+               multi, pool_threads(pool_defaut()));
+        if (departs_exponentiel(&pts, &dopt, &dep) != 0) {
+            fprintf(stderr, "Departs multiples impossibles\n");
+            return 1;
         }
+        a = dep.a;
+        b = dep.b;
+        iterations = dep.iterations;
+    } else if (methode_lm) {
+        printf("Init: a=%.6f, b=%.6f, lambda=%g\n", a, b, opt.lambda);
+        lm = ajuste_exp_lm(pts.xd, pts.yd, pts.n, a, b, &opt);
+        a = lm.a;
+        b = lm.b;
+        iterations = lm.iterations;
+    } else if (methode_sgd) {
+        printf("Init: a=%.6f, b=%.6f, lot=%zu, lr=%g/(1+t/%g)^%g\n", a, b, sopt.taille_lot,
+               sopt.pas, sopt.tau, sopt.exposant);
+        sgd = sgd_exponentiel(&pts, a, b, &sopt);
+        a = sgd.a;
+        b = sgd.b;
+        iterations = sgd.epoques;
+    } else {
+        printf("Init: a=%.6f, b=%.6f, lr=%.6f, eps=%.6f, pas %s\n", a, b, learning_rate, eps, optim_nom(pas));
+        if (!tracee) gopt.suivi = ajuste_suivi;
+        gd = ajuste_exp_descente(pts.xd, pts.yd, pts.n, &a, &b, &gopt);
+        iterations = gd.iterations;
     }
+    if (tracee && trace_fermer(&trace) != 0) fprintf(stderr, "Ecriture de la trace incomplete\n");
 
-    double final_cost = cost(x,y,n,a,b);
-    printf("\nTermine: iterations=%d\n", iter+1);
+    double final_cost = ajuste_exp_cout(pts.xd, pts.yd, pts.n, a, b);
+    printf("\nTermine: iterations=%d\n", iterations);
+    if (multi) {
+        printf("Evaluations: %d sur %d departs, %d points de controle, %d abandonnes\n",
+               dep.evaluations, multi, dep.controles, dep.abandonnes);
+        printf("Minima distincts: %d\n", dep.nminima);
+        for (int m = 0; m < dep.nminima; m++)
+            printf("  a=%.6f  b=%.6f  cost=%.6f  (%d departs)\n", dep.minima[m].a, dep.minima[m].b,
+                   dep.minima[m].cout, dep.minima[m].departs);
+    } else if (methode_lm)
+        printf("Evaluations: %d, arret: %s\n", lm.evaluations, lm_raison(lm.raison));
+    if (methode_sgd)
+        printf("Epoques: %d (%ld pas de %zu points)%s\n", sgd.epoques, sgd.pas_faits, sopt.taille_lot,
+               sgd.converge ? "" : ", maximum d'epoques atteint");
+    if (!multi && !methode_lm && !methode_sgd)
+        printf("Evaluations: %d, reculs: %d, pas final: %g, arret: %s\n",
+               gd.evaluations, gd.reculs, gd.pas, optim_raison(gd.raison));
+    if (init_log)
+        printf("Iterations: %d depuis (1.0, 0.1), %d depuis le depart log-lineaire\n",
+               iterations_sans_init, iterations);
     printf("a = %.6f\n", a);
     printf("b = %.6f\n", b);
     printf("Cost = %.6f\n", final_cost);
 
+    BootstrapResultat bres;
+    int bcode = 0;
+    if (bootstrap) {
+        bcode = bootstrap_exponentiel(&pts, a, b, &bopt, &bres);
+        if (bcode != 0) {
+            fprintf(stderr, "Bootstrap impossible : %s\n",
+                    bcode == -2 ? "memoire insuffisante" : "trop peu de repliques ajustees");
+        } else {
+            const char *noms[2] = { "a", "b" };
+            printf("\nBootstrap: %d repliques, niveau %.0f%%\n", bopt.repliques, 100.0 * bopt.niveau);
+            bootstrap_afficher(&bres, noms);
+        }
+    }
+
     // Ecrire un fichier texte de sortie résumé
     FILE *out = fopen("reponse_exercice.txt", "w");
     if (out) {
-        fprintf(out, "Ajustement exponentiel par descente du gradient\n\n");
+        fprintf(out, "Ajustement exponentiel par %s\n\n", methode);
         fprintf(out, "Fichier de données : %s\n", filename);
-        fprintf(out, "Paramètres initiaux : a0=1.0, b0=0.1\n");
-        fprintf(out, "Méthode : descente du gradient (pas fixe lr=%.6f)\n\n", learning_rate);
+        if (init_log)
+            fprintf(out, "Paramètres initiaux : droite des moindres carrés de ln y (poids y²)\n");
+        else if (multi)
+            fprintf(out, "Paramètres initiaux : %d départs répartis en b (%d minima distincts, %d abandonnés)\n",
+                    multi, dep.nminima, dep.abandonnes);
+        else
+            fprintf(out, "Paramètres initiaux : a0=1.0, b0=0.1\n");
+        if (multi)
+            fprintf(out, "Méthode : %s depuis chaque départ (%d évaluations au total)\n\n",
+                    methode_lm ? "Levenberg-Marquardt" : "descente du gradient", dep.evaluations);
+        else if (methode_lm)
+            fprintf(out, "Méthode : Levenberg-Marquardt (Gauss-Newton amorti, %d évaluations)\n\n", lm.evaluations);
+        else if (methode_sgd)
+            fprintf(out, "Méthode : gradient stochastique (lots de %zu, moyenne de Polyak, %ld pas)\n\n",
+                    sopt.taille_lot, sgd.pas_faits);
+        else
+            fprintf(out, "Méthode : descente du gradient (pas %s, lr=%.6f, %d évaluations, %d reculs)\n\n",
+                    optim_nom(pas), learning_rate, gd.evaluations, gd.reculs);
         fprintf(out, "Résultat:\n");
         fprintf(out, "a = %.6f\n", a);
         fprintf(out, "b = %.6f\n", b);
         fprintf(out, "Cost = %.6f\n", final_cost);
-        fprintf(out, "Iterations = %d\n\n", iter+1);
+        fprintf(out, "Iterations = %d\n", iterations);
+        if (init_log)
+            fprintf(out, "Iterations depuis a0=1.0, b0=0.1 = %d\n", iterations_sans_init);
+        if (bootstrap && bcode == 0)
+            fprintf(out, "Intervalles BCa à %.0f %% (%d répliques) : a dans [%.6f, %.6f], b dans [%.6f, %.6f]\n",
+                    100.0 * bopt.niveau, bres.valides, bres.p[0].bca[0], bres.p[0].bca[1],
+                    bres.p[1].bca[0], bres.p[1].bca[1]);
+        fprintf(out, "\n");
 
         fprintf(out, "D(a,b) = (1/(2n)) * Σ_i (y_i - a e^{b x_i})^2\n");
         fprintf(out, "∂D/∂a = (1/n) Σ_i (a e^{b x_i} - y_i) e^{b x_i}\n");
         fprintf(out, "∂D/∂b = (1/n) Σ_i (a e^{b x_i} - y_i) * a * x_i * e^{b x_i}\n\n");
 
-        fprintf(out, "Critère d'arret utilisé : norme des changements de paramètres < %.6f\n", eps);
+        if (multi)
+            fprintf(out, "Critère d'abandon : coût supérieur à %g fois le meilleur à un point de contrôle\n",
+                    1.0 + dopt.marge);
+        else if (methode_lm)
+            fprintf(out, "Critère d'arret : %s\n", lm_raison(lm.raison));
+        else if (methode_sgd)
+            fprintf(out, "Critère d'arret : écart entre moyennes d'époques < %g\n", sopt.tol);
+        else
+            fprintf(out, "Critère d'arret utilisé : norme des changements de paramètres < %.6f (%s)\n",
+                    eps, optim_raison(gd.raison));
         fclose(out);
     }
 
-    free(x); free(y);
+    points_free(&pts);
     return 0;
 }
@@ -0,0 +1,62 @@
+/*
+ * generateur.c
+ * Ecrit un jeu de donnees synthetique au format de donnees.txt (voir synthese.h).
+ *
+ * Usage : ./generateur lin|exp n fichier [-g graine] [-b bruit] [-a proportion]
+ *                      [-A amplitude] [-p p0 p1] [-x xmin xmax] [-B]
+ * -B ecrit le format binaire en colonnes (binaire.h), rempli directement
+ * dans la projection du fichier.
+ * Les parametres vrais sont rappeles sur la sortie standard (une ligne cle=valeur).
+ *
+ * Compilation : gcc -O2 generateur.c synthese.c points.c binaire.c ecriture.c -o generateur -lm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "synthese.h"
+
+static void usage(const char *programme) {
+    fprintf(stderr, "Usage : %s lin|exp n fichier [-g graine] [-b bruit] [-a proportion] "
+                    "[-A amplitude] [-p p0 p1] [-x xmin xmax] [-B]\n", programme);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+    Synthese s;
+    size_t n;
+    const char *fichier;
+    int k, format_binaire = 0;
+
+    if (argc < 4) usage(argv[0]);
+    if (strcmp(argv[1], "lin") == 0) synthese_defaut(&s, SYNTHESE_LINEAIRE);
+    else if (strcmp(argv[1], "exp") == 0) synthese_defaut(&s, SYNTHESE_EXP);
+    else usage(argv[0]);
+    /* strtod accepte 1e8 comme taille */
+    n = (size_t)strtod(argv[2], NULL);
+    fichier = argv[3];
+
+    for (k = 4; k < argc; k++) {
+        if (strcmp(argv[k], "-g") == 0 && k + 1 < argc) s.graine = strtoull(argv[++k], NULL, 10);
+        else if (strcmp(argv[k], "-b") == 0 && k + 1 < argc) s.bruit = atof(argv[++k]);
+        else if (strcmp(argv[k], "-a") == 0 && k + 1 < argc) s.aberrants = atof(argv[++k]);
+        else if (strcmp(argv[k], "-A") == 0 && k + 1 < argc) s.amplitude = atof(argv[++k]);
+        else if (strcmp(argv[k], "-p") == 0 && k + 2 < argc) {
+            s.p0 = atof(argv[++k]);
+            s.p1 = atof(argv[++k]);
+        } else if (strcmp(argv[k], "-x") == 0 && k + 2 < argc) {
+            s.xmin = atof(argv[++k]);
+            s.xmax = atof(argv[++k]);
+        } else if (strcmp(argv[k], "-B") == 0) format_binaire = 1;
+        else usage(argv[0]);
+    }
+
+    if ((format_binaire ? synthese_ecrire_binaire(&s, n, fichier) : synthese_ecrire(&s, n, fichier)) != 0) {
+        perror(fichier);
+        return EXIT_FAILURE;
+    }
+    printf("modele=%s n=%zu p0=%.10g p1=%.10g xmin=%g xmax=%g bruit=%g aberrants=%g amplitude=%g graine=%llu\n",
+           argv[1], n, s.p0, s.p1, s.xmin, s.xmax, s.bruit, s.aberrants, s.amplitude,
+           (unsigned long long)s.graine);
+    return 0;
+}
@@ -5,13 +5,48 @@
  * Lecture de donnees.txt (première ligne = nombre de points), initialisation
  * a0 = 1.0, b0 = 0.1, eps = 0.001 (critère d'arrêt), pas fixe lr = 0.01.
  * Génère aussi des fichiers pour tracer la courbe : donnees_plot.txt et exp_plot.txt
+ * (donnees_plot.txt réduit au min et au max de y par colonne de pixels, reduction.h)
  * et crée un script `regression_exp.gnu` (optionnellement exécutable si gnuplot est installé).
+ *
+ * Les sommes sont réparties sur un pool de threads (REGRESSION_THREADS=k)
+ * et évaluées par le noyau vectorisé de expvec.c (coût et gradient en une passe) ;
+ * descente et Levenberg-Marquardt sont ceux de ajuste.h (ajuste_exp).
+ *
+ * Usage : ./gradient [lm | fixe|armijo|momentum|nesterov|adam] [init]
+ *   lm   : Levenberg-Marquardt au lieu de la descente du gradient (quelques
+ *          dizaines de passes sur les données au lieu de milliers)
+ *   fixe|armijo|momentum|nesterov|adam : méthode de pas de la descente
+ *          (optim.h, défaut fixe) ; un pas qui fait diverger est réduit
+ *   init : départ de la droite des moindres carrés de ln y (y > 0, poids y²),
+ *          avec comparaison du nombre d'itérations depuis (1.0, 0.1)
+ *   multi[=K] : K départs en parallèle (défaut 16) répartis en b, les départs
+ *          sans espoir abandonnés en route (departs.h) ; affiche le meilleur
+ *          ajustement et les minima locaux trouvés
+ * REGRESSION_TRACE=fichier [REGRESSION_TRACE_PAS=N] : trace binaire de la
+ *          convergence (trace.h, relue par trace_dump) au lieu de l'affichage
+ *          périodique ; sans effet avec multi
+ * REGRESSION_SORTIE=binaire : fichiers de tracé en doubles bruts
+ *          (donnees_plot.bin, exp_plot.bin), lus tels quels par regression_exp.gnu
+ *
+ * Compilation : gcc -O2 gradient.c points.c lecture.c pool.c expvec.c lm.c optim.c departs.c moments.c trace.c reduction.c ecriture.c -o gradient -lm -pthread
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include "points.h"
+#include "lecture.h"
+#include "pool.h"
+#include "expvec.h"
+#include "lm.h"
+#include "optim.h"
+#include "departs.h"
+#include "moments.h"
+#include "ajuste.h"
+#include "trace.h"
+#include "reduction.h"
+#include "ecriture.h"
 
 /* Fonctions utilitaires */
 static void error_and_exit(const char *msg) {
@@ -19,82 +54,36 @@ static void error_and_exit(const char *msg) {
 	exit(EXIT_FAILURE);
 }
 
-static void read_data(const char *filename, double **px, double **py, int *pn) {
-	FILE *f = fopen(filename, "r");
-	if (!f) error_and_exit("Impossible d'ouvrir le fichier de données");
-	if (fscanf(f, "%d", pn) != 1) {
-		fclose(f);
-		error_and_exit("Format attendu : première ligne = nombre de points");
+static void read_data(const char *filename, Points *pts) {
+	LectureInfo info;
+	LectureCode code = lecture_points(filename, pts, POINTS_DOUBLE, &info);
+	if (code != LECTURE_OK) {
+		fprintf(stderr, "%s (ligne %zu)\n", filename, info.ligne);
+		error_and_exit(lecture_message(code));
 	}
-	int n = *pn;
-	*px = (double*)malloc(n * sizeof(double));
-	*py = (double*)malloc(n * sizeof(double));
-	if (!*px || !*py) { fclose(f); error_and_exit("Allocation mémoire"); }
-
-	for (int i = 0; i < n; i++) {
-		double xi, yi;
-		if (fscanf(f, " %lf , %lf", &xi, &yi) != 2) {
-			fclose(f);
-			error_and_exit("Erreur de lecture des données (format x, y attendu)");
-		}
-		(*px)[i] = xi;
-		(*py)[i] = yi;
-	}
-	fclose(f);
-}
-
-/* Fonction coût : J(a,b) = (1/(2n)) Σ (a e^{b x_i} - y_i)^2 */
-static double compute_cost(const double *x, const double *y, int n, double a, double b) {
-	double s = 0.0;
-	for (int i = 0; i < n; i++) {
-		double pred = a * exp(b * x[i]);
-		double diff = pred - y[i];
-		s += diff * diff;
-	}
-	return s / (2.0 * n);
-}
-
-/* Calcul du gradient : partials ga = ∂J/∂a, gb = ∂J/∂b */
-static void compute_gradient(const double *x, const double *y, int n, double a, double b, double *ga, double *gb) {
-	double sga = 0.0, sgb = 0.0;
-	for (int i = 0; i < n; i++) {
-		double ebx = exp(b * x[i]);
-		double pred = a * ebx;
-		double diff = pred - y[i];
-		sga += diff * ebx;            /* dérivée partielle par rapport à a */
-		sgb += diff * a * x[i] * ebx; /* dérivée partielle par rapport à b */
-	}
-	*ga = sga / (double)n;
-	*gb = sgb / (double)n;
+	printf("Lecture: %zu points, %.3f Mo en %.3f s (%.1f Mo/s)\n", pts->n,
+	       info.octets / (1024.0 * 1024.0), info.secondes, lecture_debit(&info));
 }
 
-/* Génération des fichiers pour tracé */
-static void write_plot_files(const double *x, const double *y, int n, double a, double b) {
-	FILE *fd = fopen("donnees_plot.txt", "w");
-	if (fd) {
-		for (int i = 0; i < n; i++) fprintf(fd, "%.6f %.6f\n", x[i], y[i]);
-		fclose(fd);
+/* Génération des fichiers pour tracé (REGRESSION_SORTIE=binaire : doubles bruts en .bin) */
+static void write_plot_files(const Points *pts, double a, double b) {
+	/* au plus deux points (min et max de y) par colonne de pixels de l'image */
+	static double xs[2 * REDUCTION_COLONNES], ys[2 * REDUCTION_COLONNES];
+	size_t m = reduction_minmax(pts->xd, pts->yd, pts->n, REDUCTION_COLONNES, xs, ys);
+	int binaire = ecriture_env();
+	const char *points = binaire ? "donnees_plot.bin" : "donnees_plot.txt";
+	const char *courbe = binaire ? "exp_plot.bin" : "exp_plot.txt";
+	const char *lecture = binaire ? " binary format='%float64%float64'" : "";
+	Ecriture e;
+	if (ecriture_ouvrir(&e, points, binaire) == 0) {
+		ajuste_exp_ecrire_points(&e, xs, ys, m);
+		if (ecriture_fermer(&e) != 0) perror(points);
 	}
 
 	/* génération d'une courbe lisse pour l'exponentielle */
-	double xmin = x[0], xmax = x[0];
-	for (int i = 1; i < n; i++) {
-		if (x[i] < xmin) xmin = x[i];
-		if (x[i] > xmax) xmax = x[i];
-	}
-	double range = xmax - xmin;
-	if (range == 0.0) { xmin -= 1.0; xmax += 1.0; range = 2.0; }
-	double start = xmin - 0.1 * range;
-	double end = xmax + 0.1 * range;
-	FILE *fe = fopen("exp_plot.txt", "w");
-	if (fe) {
-		int steps = 200;
-		double step = (end - start) / steps;
-		for (double xv = start; xv <= end + 1e-12; xv += step) {
-			double yv = a * exp(b * xv);
-			fprintf(fe, "%.6f %.6f\n", xv, yv);
-		}
-		fclose(fe);
+	if (ecriture_ouvrir(&e, courbe, binaire) == 0) {
+		ajuste_exp_ecrire_courbe(&e, pts->xd, pts->n, a, b, 200);
+		if (ecriture_fermer(&e) != 0) perror(courbe);
 	}
 
 	/* script gnuplot minimal */
@@ -105,17 +94,33 @@ static void write_plot_files(const double *x, const double *y, int n, double a,
 		fprintf(g, "set grid\n");
 		fprintf(g, "set xlabel 'x'\n");
 		fprintf(g, "set ylabel 'y'\n");
-		fprintf(g, "plot 'donnees_plot.txt' with points pt 7 ps 1.5 title 'Données', \\\n");
-		fprintf(g, "     'exp_plot.txt' with lines lw 2 lc rgb 'red' title sprintf('a=%.6f b=%.6f', %.6f, %.6f)\n", a, b, a, b);
+		fprintf(g, "plot '%s'%s with points pt 7 ps 1.5 title 'Données', \\\n", points, lecture);
+		fprintf(g, "     '%s'%s with lines lw 2 lc rgb 'red' title sprintf('a=%.6f b=%.6f', %.6f, %.6f)\n",
+		        courbe, lecture, a, b, a, b);
 		fclose(g);
 	}
 }
 
-int main(void) {
+int main(int argc, char **argv) {
 	const char *fname = "donnees.txt";
-	double *x = NULL, *y = NULL;
-	int n = 0;
-	read_data(fname, &x, &y, &n);
+	int methode_lm = 0, init_log = 0, multi = 0;
+	OptimMethode pas = OPTIM_FIXE;
+	for (int k = 1; k < argc; k++) {
+		if (strcmp(argv[k], "lm") == 0) methode_lm = 1;
+		else if (strcmp(argv[k], "init") == 0) init_log = 1;
+		else if (strcmp(argv[k], "multi") == 0) multi = 16;
+		else if (strncmp(argv[k], "multi=", 6) == 0 && departs_nombre(argv[k] + 6, &multi) == 0) continue;
+		else if (optim_depuis_nom(argv[k], &pas) == 0) continue;
+		else {
+			fprintf(stderr, "Usage : %s [lm | fixe|armijo|momentum|nesterov|adam] [init | multi[=K]]\n"
+			                "        K entre 1 et %d\n", argv[0], DEPARTS_MAX);
+			return EXIT_FAILURE;
+		}
+	}
+	if (multi && init_log)
+		error_and_exit("multi : sans init");
+	Points pts;
+	read_data(fname, &pts);
 
 	/* Paramètres demandés par l'énoncé */
 	double a = 1.0;
@@ -124,30 +129,82 @@ int main(void) {
 	double eps = 0.001;   /* critère d'arrêt sur la norme des changements */
 	int max_iter = 200000;
 
-	printf("Descente du gradient pour f(x)=a*exp(b x)\n");
-	printf("Initial: a=%.6f, b=%.6f, lr=%.6f, eps=%.6f\n", a, b, lr, eps);
-
-	double prev_a = a, prev_b = b;
-	int iter;
-	for (iter = 0; iter < max_iter; iter++) {
-		double ga, gb;
-		compute_gradient(x, y, n, a, b, &ga, &gb);
-		prev_a = a; prev_b = b;
-		a -= lr * ga;
-		b -= lr * gb;
-
-		double da = a - prev_a;
-		double db = b - prev_b;
-		if (sqrt(da*da + db*db) < eps) break;
-
-		if (iter % 5000 == 0) {
-			double c = compute_cost(x, y, n, a, b);
-			printf("it=%6d  a=%.6f  b=%.6f  cost=%.6f\n", iter, a, b, c);
+	if (methode_lm) printf("Levenberg-Marquardt pour f(x)=a*exp(b x)\n");
+	else printf("Descente du gradient (pas %s) pour f(x)=a*exp(b x)\n", optim_nom(pas));
+	printf("Noyau exponentiel: %s\n", expvec_isa());
+
+	int iterations, iterations_sans_init = 0;
+	LmResultat lm = { 0 };
+	LmOptions opt;
+	lm_options_defaut(&opt);
+	OptimResultat gd = { 0 };
+	OptimOptions gopt;
+	optim_options_defaut(&gopt, pas, lr, eps, max_iter);
+
+	if (init_log) {
+		/* même solveur depuis le départ de l'énoncé, pour comparaison */
+		double a0 = a, b0 = b;
+		if (methode_lm) iterations_sans_init = ajuste_exp_lm(pts.xd, pts.yd, pts.n, a0, b0, &opt).iterations;
+		else iterations_sans_init = ajuste_exp_descente(pts.xd, pts.yd, pts.n, &a0, &b0, &gopt).iterations;
+
+		if (moments_exponentielle(&pts, &a, &b) != 0) {
+			printf("Depart log-lineaire impossible (moins de deux y > 0), depart par defaut\n");
+			init_log = 0;
 		}
 	}
 
-	double final_cost = compute_cost(x, y, n, a, b);
-	printf("\nTermine: iterations=%d\n", iter+1);
+	DepartsOptions dopt;
+	DepartsResultat dep;
+	departs_options_defaut(&dopt, multi, methode_lm);
+	dopt.descente = gopt;
+
+	/* trace binaire de la convergence (REGRESSION_TRACE) : remplace l'affichage périodique */
+	Trace trace;
+	int tracee = multi ? 0 : trace_env(&trace, methode_lm ? "lm" : optim_nom(pas));
+	if (tracee < 0) error_and_exit("Trace de convergence impossible (REGRESSION_TRACE)");
+	if (tracee) {
+		opt.trace = gopt.trace = &trace;
+		printf("Trace: %s, une iteration sur %lld\n", getenv("REGRESSION_TRACE"), (long long)trace.pas);
+	}
+
+	if (multi) {
+		printf("Departs: %d sur %d threads, b dans [-b_max, b_max], a optimal a b fixe\n",
+		       multi, pool_threads(pool_defaut()));
+		if (departs_exponentiel(&pts, &dopt, &dep) != 0) error_and_exit("Departs multiples impossibles");
+		a = dep.a;
+		b = dep.b;
+		iterations = dep.iterations;
+	} else if (methode_lm) {
+		printf("Initial: a=%.6f, b=%.6f, lambda=%g\n", a, b, opt.lambda);
+		lm = ajuste_exp_lm(pts.xd, pts.yd, pts.n, a, b, &opt);
+		a = lm.a;
+		b = lm.b;
+		iterations = lm.iterations;
+	} else {
+		printf("Initial: a=%.6f, b=%.6f, lr=%.6f, eps=%.6f\n", a, b, lr, eps);
+		if (!tracee) gopt.suivi = ajuste_suivi;
+		gd = ajuste_exp_descente(pts.xd, pts.yd, pts.n, &a, &b, &gopt);
+		iterations = gd.iterations;
+	}
+	if (tracee && trace_fermer(&trace) != 0) fprintf(stderr, "Ecriture de la trace incomplete\n");
+
+	double final_cost = ajuste_exp_cout(pts.xd, pts.yd, pts.n, a, b);
+	printf("\nTermine: iterations=%d\n", iterations);
+	if (multi) {
+		printf("Evaluations: %d sur %d departs, %d points de controle, %d abandonnes\n",
+		       dep.evaluations, multi, dep.controles, dep.abandonnes);
+		printf("Minima distincts: %d\n", dep.nminima);
+		for (int m = 0; m < dep.nminima; m++)
+			printf("  a=%.6f  b=%.6f  cost=%.6f  (%d departs)\n", dep.minima[m].a, dep.minima[m].b,
+			       dep.minima[m].cout, dep.minima[m].departs);
+	} else if (methode_lm)
+		printf("Evaluations: %d, arret: %s\n", lm.evaluations, lm_raison(lm.raison));
+	else
+		printf("Evaluations: %d, reculs: %d, pas final: %g, arret: %s\n",
+		       gd.evaluations, gd.reculs, gd.pas, optim_raison(gd.raison));
+	if (init_log)
+		printf("Iterations: %d depuis (1.0, 0.1), %d depuis le depart log-lineaire\n",
+		       iterations_sans_init, iterations);
 	printf("a = %.6f\n", a);
 	printf("b = %.6f\n", b);
 	printf("Cost = %.6f\n", final_cost);
@@ -159,14 +216,26 @@ int main(void) {
 		fprintf(out, "a = %.6f\n", a);
 		fprintf(out, "b = %.6f\n", b);
 		fprintf(out, "Cost = %.6f\n", final_cost);
-		fprintf(out, "Iterations = %d\n", iter+1);
+		fprintf(out, "Iterations = %d\n", iterations);
+		if (init_log)
+			fprintf(out, "Iterations sans depart log-lineaire = %d\n", iterations_sans_init);
+		if (multi)
+			fprintf(out, "Méthode = %s depuis %d départs (%d minima distincts, %d abandonnés, %d évaluations)\n",
+			        methode_lm ? "Levenberg-Marquardt" : "descente du gradient", multi,
+			        dep.nminima, dep.abandonnes, dep.evaluations);
+		else if (methode_lm)
+			fprintf(out, "Méthode = Levenberg-Marquardt (%d évaluations, arrêt : %s)\n",
+			        lm.evaluations, lm_raison(lm.raison));
+		else
+			fprintf(out, "Méthode = descente du gradient, pas %s (%d évaluations, %d reculs, arrêt : %s)\n",
+			        optim_nom(pas), gd.evaluations, gd.reculs, optim_raison(gd.raison));
 		fclose(out);
 	}
 
 	/* Générer fichiers pour tracé */
-	write_plot_files(x, y, n, a, b);
+	write_plot_files(&pts, a, b);
 
-	free(x); free(y);
+	points_free(&pts);
 	return 0;
 }
 
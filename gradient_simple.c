@@ -3,38 +3,78 @@
  * Initialise a0 = 0.2, b0 = 0.1 et alpha = 0.001
  * Modèle : f(x) = a * exp(b * x)
  * Lecture de donnees.txt : première ligne = n, puis n lignes "x, y"
+ * Option : ./gradient_simple init  part de la droite des moindres carrés de ln y
+ * (y > 0, poids y²) et compare le nombre d'itérations avec le départ (0.2, 0.1)
+ * Option : ./gradient_simple fixe|armijo|momentum|nesterov|adam  méthode de pas
+ * (optim.h, défaut fixe) ; les sommes restent calculées en float
+ * REGRESSION_TRACE=fichier (REGRESSION_TRACE_PAS=N) : trace binaire de la
+ * convergence (trace.h, relue par trace_dump) au lieu de l'affichage périodique
+ * Compilation : gcc -O2 gradient_simple.c points.c lecture.c expvec.c optim.c moments.c trace.c -o gradient_simple -lm
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
+#include "points.h"
+#include "lecture.h"
+#include "expvec.h"
+#include "moments.h"
+#include "optim.h"
+#include "trace.h"
 
-int main(void) {
-    const char *filename = "donnees.txt";
-    FILE *f = fopen(filename, "r");
-    if (!f) {
-        perror("Ouverture donnees.txt");
-        return 1;
-    }
+/* calcul gradient (noyau vectorisé en float) : s[1] et s[2] sont
+   les sommes des dérivées partielles par rapport à a et à b */
+static int evaluer(void *ctx, const double p[2], double *cost, double g[2]) {
+    const Points *pts = (const Points *)ctx;
+    double s[3];
+    expvec_sommesf(pts->xf, pts->yf, pts->n, (float)p[0], (float)p[1], s);
+    *cost = (float)(s[0] / (2.0 * pts->n));
+    g[0] = (float)(s[1] / pts->n);
+    g[1] = (float)(s[2] / pts->n);
+    return 0;
+}
 
-    int n;
-    if (fscanf(f, "%d", &n) != 1) {
-        fprintf(stderr, "Format: première ligne nombre de points\n");
-        fclose(f);
-        return 1;
-    }
+/* affichage simple toutes les 50000 itérations */
+static void suivi(int iter, const double p[2], double cost) {
+    if (iter % 50000 == 0) printf("it=%d a=%.6f b=%.6f cost=%.6f\n", iter, p[0], p[1], cost);
+}
 
-    float *xs = (float*)malloc(n * sizeof(float));
-    float *ys = (float*)malloc(n * sizeof(float));
-    if (!xs || !ys) { fclose(f); fprintf(stderr, "Erreur allocation\n"); return 1; }
+/* Descente depuis (*a, *b) ; retourne le nombre d'itérations */
+static int descente(const Points *pts, float *a, float *b, const OptimOptions *opt, int trace) {
+    double p[2] = { *a, *b };
+    OptimResultat r = optim_minimiser(evaluer, (void *)pts, p, opt);
+    *a = (float)r.p[0];
+    *b = (float)r.p[1];
+    if (trace) {
+        if (r.raison == OPTIM_CONVERGE) printf("Converge en %d iterations\n", r.iterations);
+        printf("Evaluations: %d, reculs: %d, pas final: %g, arret: %s\n",
+               r.evaluations, r.reculs, r.pas, optim_raison(r.raison));
+    }
+    return r.iterations;
+}
 
-    for (int i = 0; i < n; i++) {
-        if (fscanf(f, " %f , %f", &xs[i], &ys[i]) != 2) {
-            fprintf(stderr, "Erreur lecture ligne %d\n", i+2);
-            free(xs); free(ys); fclose(f); return 1;
+int main(int argc, char **argv) {
+    const char *filename = "donnees.txt";
+    int init_log = 0;
+    OptimMethode methode = OPTIM_FIXE;
+    for (int k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "init") == 0) init_log = 1;
+        else if (optim_depuis_nom(argv[k], &methode) != 0) {
+            fprintf(stderr, "Usage : %s [fixe|armijo|momentum|nesterov|adam] [init]\n", argv[0]);
+            return 1;
         }
     }
-    fclose(f);
+    Points pts;
+    LectureInfo info;
+    LectureCode code = lecture_points(filename, &pts, POINTS_FLOAT, &info);
+    if (code != LECTURE_OK) {
+        fprintf(stderr, "%s (ligne %zu)\n", lecture_message(code), info.ligne);
+        return 1;
+    }
+    float *xs = pts.xf, *ys = pts.yf;
+    size_t n = pts.n;
+    printf("Lecture: %zu points (%.1f Mo/s)\n", n, lecture_debit(&info));
 
     /* Paramètres demandés */
     float a = 0.2f;
@@ -42,60 +82,50 @@ int main(void) {
     float alpha = 0.001f; /* pas d'apprentissage */
     float eps = 0.0001f;
     int max_iter = 200000;
+    OptimOptions opt;
+    optim_options_defaut(&opt, methode, alpha, eps, max_iter);
 
-    for (int iter = 0; iter < max_iter; iter++) {
-        /* calcul gradient (utilisant float) */
-        float ga = 0.0f;
-        float gb = 0.0f;
-        for (int i = 0; i < n; i++) {
-            float ebx = expf(b * xs[i]);
-            float pred = a * ebx;
-            float diff = pred - ys[i];
-            ga += diff * ebx;           /* dérivée partielle par rapport à a */
-            gb += diff * a * xs[i] * ebx;/* dérivée partielle par rapport à b */
-        }
-        ga /= (float)n;
-        gb /= (float)n;
-
-        float prev_a = a;
-        float prev_b = b;
-
-        a -= alpha * ga;
-        b -= alpha * gb;
+    int iterations_sans_init = 0;
+    if (init_log) {
+        /* même descente depuis le départ par défaut, pour comparaison */
+        float a0 = a, b0 = b;
+        iterations_sans_init = descente(&pts, &a0, &b0, &opt, 0);
 
-        float da = a - prev_a;
-        float db = b - prev_b;
-        float norm = sqrtf(da*da + db*db);
-        if (norm < eps) {
-            printf("Converge en %d iterations\n", iter+1);
-            break;
-        }
-        /* affichage simple toutes les 50000 itérations */
-        if (iter % 50000 == 0) {
-            /* calcul coût pour suivre */
-            float cost = 0.0f;
-            for (int i = 0; i < n; i++) {
-                float pred = a * expf(b * xs[i]);
-                float e = pred - ys[i]; cost += e*e;
-            }
-            cost /= (2.0f * n);
-            printf("it=%d a=%.6f b=%.6f cost=%.6f\n", iter, a, b, cost);
+        double ai, bi;
+        if (moments_exponentielle(&pts, &ai, &bi) == 0) {
+            a = (float)ai;
+            b = (float)bi;
+            printf("Depart log-lineaire: a=%.6f b=%.6f\n", a, b);
+        } else {
+            printf("Depart log-lineaire impossible (moins de deux y > 0)\n");
+            init_log = 0;
         }
     }
 
-    /* coût final */
-    float final_cost = 0.0f;
-    for (int i = 0; i < n; i++) {
-        float pred = a * expf(b * xs[i]);
-        float e = pred - ys[i]; final_cost += e*e;
+    Trace trace;
+    int tracee = trace_env(&trace, optim_nom(methode));
+    if (tracee < 0) {
+        fprintf(stderr, "Trace de convergence impossible (REGRESSION_TRACE)\n");
+        return 1;
     }
-    final_cost /= (2.0f * n);
+    if (tracee) opt.trace = &trace;
+    else opt.suivi = suivi;
+    int iterations = descente(&pts, &a, &b, &opt, 1);
+    if (tracee && trace_fermer(&trace) != 0) fprintf(stderr, "Ecriture de la trace incomplete\n");
+    if (init_log)
+        printf("Iterations: %d depuis (0.2, 0.1), %d depuis le depart log-lineaire\n",
+               iterations_sans_init, iterations);
+
+    /* coût final */
+    double s[3];
+    expvec_sommesf(xs, ys, n, a, b, s);
+    float final_cost = (float)(s[0] / (2.0 * n));
 
     printf("Resultat final:\n");
     printf("a = %.6f\n", a);
     printf("b = %.6f\n", b);
     printf("cost = %.6f\n", final_cost);
 
-    free(xs); free(ys);
+    points_free(&pts);
     return 0;
 }
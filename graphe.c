@@ -0,0 +1,226 @@
+/*
+ * graphe.c
+ * Processus gnuplot persistant alimente par un thread de trace
+ * (voir graphe.h).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "graphe.h"
+#include "reduction.h"
+
+typedef struct {
+    char titre[GRAPHE_TEXTE];
+    int nseries;
+    size_t n[GRAPHE_SERIES];
+    char style[GRAPHE_SERIES][GRAPHE_TEXTE];
+    char legende[GRAPHE_SERIES][GRAPHE_TEXTE];
+    float *xy;                      /* series a la suite, x et y entrelaces */
+    size_t capacite;                /* en float */
+} Requete;
+
+struct Graphe {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t signal;
+    Requete attente;                /* dernier trace demande */
+    Requete courante;               /* trace en cours de rendu (thread seul) */
+    int nouvelle;
+    int arret;
+
+    char commande[256];
+    char sortie[256];               /* vide : fenetre */
+    FILE *gnuplot;                  /* NULL tant que le processus n'est pas lance */
+    int erreur_signalee;
+};
+
+/*
+ * Copie un texte destine a une chaine gnuplot entre guillemets doubles :
+ * retour a la ligne ecrit \n, guillemet double remplace par une apostrophe.
+ */
+static void copier_texte(char *dst, const char *src) {
+    size_t k = 0;
+
+    for (; src && *src && k + 2 < GRAPHE_TEXTE; src++) {
+        if (*src == '\n') {
+            dst[k++] = '\\';
+            dst[k++] = 'n';
+        } else {
+            dst[k++] = *src == '"' ? '\'' : *src;
+        }
+    }
+    dst[k] = '\0';
+}
+
+static int dessiner(Graphe *g, const Requete *r) {
+    FILE *f;
+    size_t debut = 0;
+    int k, premiere = 1;
+
+    if (!g->gnuplot) {
+        g->gnuplot = popen(g->commande, "w");
+        if (!g->gnuplot) return -1;
+    }
+    f = g->gnuplot;
+
+    if (g->sortie[0]) {
+        fprintf(f, "set terminal pngcairo enhanced font 'Arial,12' size 800,600\n");
+        fprintf(f, "set output '%s'\n", g->sortie);
+    }
+    fprintf(f, "set title \"%s\"\n", r->titre);
+    fprintf(f, "set xlabel 'x'\nset ylabel 'y'\nset grid\nset key top left\n");
+    fprintf(f, "set autoscale xfix\nset offsets 0, 0, graph 0.1, graph 0.1\n");
+
+    /* une source '-' binaire par serie, lues dans l'ordre de la commande plot */
+    fprintf(f, "plot");
+    for (k = 0; k < r->nseries; k++) {
+        if (r->n[k] == 0) continue;
+        fprintf(f, "%s '-' binary record=(%zu) format='%%float%%float' using 1:2 with %s title \"%s\"",
+                premiere ? "" : ",", r->n[k], r->style[k], r->legende[k]);
+        premiere = 0;
+    }
+    fprintf(f, "\n");
+    for (k = 0; k < r->nseries; k++) {
+        fwrite(r->xy + 2 * debut, sizeof(float), 2 * r->n[k], f);
+        debut += r->n[k];
+    }
+    if (g->sortie[0]) fprintf(f, "unset output\n");
+
+    if (fflush(f) != 0 || ferror(f)) {
+        pclose(f);
+        g->gnuplot = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static void signaler(Graphe *g) {
+    if (g->erreur_signalee) return;
+    fprintf(stderr, "\ngnuplot : trace impossible (commande \"%s\"). "
+                    "Installer gnuplot ou regler REGRESSION_GNUPLOT.\n", g->commande);
+    g->erreur_signalee = 1;
+}
+
+static void *boucle(void *arg) {
+    Graphe *g = (Graphe *)arg;
+    sigset_t masque;
+
+    /* gnuplot absent ou ferme : l'ecriture echoue avec EPIPE au lieu de tuer le programme */
+    sigemptyset(&masque);
+    sigaddset(&masque, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &masque, NULL);
+
+    pthread_mutex_lock(&g->mutex);
+    for (;;) {
+        Requete r;
+
+        while (!g->nouvelle && !g->arret) {
+            pthread_cond_wait(&g->signal, &g->mutex);
+        }
+        if (!g->nouvelle) break;
+        /* echange des tampons : la demande suivante remplit l'ancien */
+        r = g->courante;
+        g->courante = g->attente;
+        g->attente = r;
+        g->nouvelle = 0;
+        pthread_mutex_unlock(&g->mutex);
+
+        if (dessiner(g, &g->courante) != 0) signaler(g);
+        else g->erreur_signalee = 0;
+
+        pthread_mutex_lock(&g->mutex);
+    }
+    pthread_mutex_unlock(&g->mutex);
+
+    if (g->gnuplot && pclose(g->gnuplot) != 0) signaler(g);
+    g->gnuplot = NULL;
+    return NULL;
+}
+
+Graphe *graphe_ouvrir(const char *sortie) {
+    const char *env = getenv("REGRESSION_GNUPLOT");
+    Graphe *g = (Graphe *)calloc(1, sizeof(Graphe));
+
+    if (!g) return NULL;
+    /* en fenetre, -persist la laisse ouverte apres la fin du programme */
+    snprintf(g->commande, sizeof(g->commande), "%s", env && *env ? env : sortie ? "gnuplot" : "gnuplot -persist");
+    if (sortie) snprintf(g->sortie, sizeof(g->sortie), "%s", sortie);
+
+    pthread_mutex_init(&g->mutex, NULL);
+    pthread_cond_init(&g->signal, NULL);
+    if (pthread_create(&g->thread, NULL, boucle, g) != 0) {
+        pthread_mutex_destroy(&g->mutex);
+        pthread_cond_destroy(&g->signal);
+        free(g);
+        return NULL;
+    }
+    return g;
+}
+
+int graphe_tracer(Graphe *g, const char *titre, const GrapheSerie *series, int nseries) {
+    float xs[2 * REDUCTION_COLONNES], ys[2 * REDUCTION_COLONNES];  /* series reduites */
+    Requete *r = &g->attente;
+    size_t total = 0, debut = 0, i;
+    int k;
+
+    if (nseries < 1 || nseries > GRAPHE_SERIES) return -1;
+    for (k = 0; k < nseries; k++)
+        total += series[k].n < 2 * REDUCTION_COLONNES ? series[k].n : 2 * REDUCTION_COLONNES;
+
+    pthread_mutex_lock(&g->mutex);
+    if (2 * total > r->capacite) {
+        float *xy = (float *)realloc(r->xy, 2 * total * sizeof(float));
+        if (!xy) {
+            pthread_mutex_unlock(&g->mutex);
+            return -1;
+        }
+        r->xy = xy;
+        r->capacite = 2 * total;
+    }
+    copier_texte(r->titre, titre);
+    r->nseries = nseries;
+    for (k = 0; k < nseries; k++) {
+        const GrapheSerie *s = &series[k];
+        const float *x = s->x, *y = s->y;
+        size_t n = s->n;
+
+        /* au-dela de la largeur de l'image, min et max par colonne de pixels */
+        if (n > 2 * REDUCTION_COLONNES) {
+            n = reduction_minmaxf(x, y, n, REDUCTION_COLONNES, xs, ys);
+            x = xs;
+            y = ys;
+        }
+        r->n[k] = n;
+        copier_texte(r->style[k], s->style);
+        copier_texte(r->legende[k], s->titre);
+        for (i = 0; i < n; i++) {
+            r->xy[2 * (debut + i)] = x[i];
+            r->xy[2 * (debut + i) + 1] = y[i];
+        }
+        debut += n;
+    }
+    g->nouvelle = 1;
+    pthread_cond_signal(&g->signal);
+    pthread_mutex_unlock(&g->mutex);
+    return 0;
+}
+
+void graphe_fermer(Graphe *g) {
+    if (!g) return;
+    pthread_mutex_lock(&g->mutex);
+    g->arret = 1;
+    pthread_cond_signal(&g->signal);
+    pthread_mutex_unlock(&g->mutex);
+    pthread_join(g->thread, NULL);
+
+    pthread_mutex_destroy(&g->mutex);
+    pthread_cond_destroy(&g->signal);
+    free(g->attente.xy);
+    free(g->courante.xy);
+    free(g);
+}
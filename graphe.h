@@ -0,0 +1,57 @@
+/*
+ * graphe.h
+ * Traces gnuplot sans fichier intermediaire ni attente. Un seul processus
+ * gnuplot reste ouvert derriere un tube (popen) pendant toute la vie du
+ * programme ; un thread de trace lui envoie les commandes et les series au
+ * format binaire en ligne de gnuplot ('-' binary format='%float%float'),
+ * sans conversion en texte.
+ *
+ * graphe_tracer copie les series et rend la main aussitot : le menu et les
+ * solveurs n'attendent jamais le rendu. Si plusieurs traces sont demandes
+ * pendant un rendu, seul le dernier est dessine. Le processus est lance au
+ * premier trace, et relance au suivant s'il a disparu (gnuplot absent ou
+ * ferme) ; l'erreur est signalee une fois sur stderr.
+ *
+ * Une serie de plus de 2 * REDUCTION_COLONNES points est reduite au minimum
+ * et au maximum de chaque colonne de pixels (reduction.h) : le cout d'un
+ * trace est borne par la largeur de l'image et non par n.
+ *
+ * La commande est celle de REGRESSION_GNUPLOT (defaut : gnuplot).
+ */
+
+#ifndef GRAPHE_H
+#define GRAPHE_H
+
+#include <stddef.h>
+
+#define GRAPHE_SERIES 4
+#define GRAPHE_TEXTE 128
+
+typedef struct Graphe Graphe;
+
+typedef struct {
+    const float *x, *y;
+    size_t n;
+    const char *style;      /* apres "with", ex. "points pt 7 ps 1.5 lc rgb 'blue'" */
+    const char *titre;      /* legende */
+} GrapheSerie;
+
+/*
+ * Demarre le thread de trace. sortie : fichier PNG reecrit a chaque trace,
+ * ou NULL pour la fenetre du terminal par defaut de gnuplot (reutilisee
+ * d'un trace a l'autre). Retourne NULL en cas d'echec.
+ */
+Graphe *graphe_ouvrir(const char *sortie);
+
+/*
+ * Demande un trace de nseries (<= GRAPHE_SERIES) series : x couvre
+ * exactement les series, y avec une marge de 10 %. Les series et les
+ * textes sont copies : l'appelant peut les modifier des le retour.
+ * Retourne 0, ou -1 (allocation, nseries).
+ */
+int graphe_tracer(Graphe *g, const char *titre, const GrapheSerie *series, int nseries);
+
+/* Dessine le trace en attente, ferme gnuplot et arrete le thread */
+void graphe_fermer(Graphe *g);
+
+#endif
@@ -0,0 +1,388 @@
+/*
+ * lecture.c
+ * Chargement des fichiers de points par projection memoire (voir lecture.h).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lecture.h"
+#include "binaire.h"
+
+/* Puissances de 10 representables exactement en double */
+static const double puissances10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int est_chiffre(char c) {
+    return (unsigned)(c - '0') < 10u;
+}
+
+/* Cas rares (plus de 19 chiffres, grands exposants, inf, nan) : strtod sur une copie */
+static const char *nombre_lent(const char *debut, const char *fin, double *valeur) {
+    char tampon[128];
+    size_t len = (size_t)(fin - debut);
+    char *suite;
+
+    if (len > sizeof(tampon) - 1) len = sizeof(tampon) - 1;
+    memcpy(tampon, debut, len);
+    tampon[len] = '\0';
+    *valeur = strtod(tampon, &suite);
+    if (suite == tampon) return NULL;
+    return debut + (suite - tampon);
+}
+
+const char *lecture_nombre(const char *p, const char *fin, double *valeur) {
+    const char *debut;
+    uint64_t mantisse = 0;
+    int chiffres = 0;       /* chiffres significatifs retenus */
+    int exp10 = 0;
+    int negatif = 0, vu = 0, inexact = 0;
+
+    while (p < fin && (*p == ' ' || *p == '\t')) p++;
+    debut = p;
+
+    if (p < fin && (*p == '-' || *p == '+')) {
+        negatif = (*p == '-');
+        p++;
+    }
+
+    // Partie entiere
+    while (p < fin && est_chiffre(*p)) {
+        if (chiffres < 19) {
+            mantisse = mantisse * 10 + (uint64_t)(*p - '0');
+            if (mantisse) chiffres++;
+        } else {
+            exp10++;
+            inexact = 1;
+        }
+        p++;
+        vu = 1;
+    }
+
+    // Partie decimale
+    if (p < fin && *p == '.') {
+        p++;
+        while (p < fin && est_chiffre(*p)) {
+            if (chiffres < 19) {
+                mantisse = mantisse * 10 + (uint64_t)(*p - '0');
+                if (mantisse) chiffres++;
+                exp10--;
+            } else {
+                inexact = 1;
+            }
+            p++;
+            vu = 1;
+        }
+    }
+
+    if (!vu) return nombre_lent(debut, fin, valeur);
+
+    // Exposant
+    if (p < fin && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        int negexp = 0, e = 0;
+        if (q < fin && (*q == '-' || *q == '+')) {
+            negexp = (*q == '-');
+            q++;
+        }
+        if (q < fin && est_chiffre(*q)) {
+            while (q < fin && est_chiffre(*q)) {
+                if (e < 10000) e = e * 10 + (*q - '0');
+                q++;
+            }
+            exp10 += negexp ? -e : e;
+            p = q;
+        }
+    }
+
+    // Chemin rapide : mantisse et puissance de 10 exactes, un seul arrondi
+    if (!inexact && mantisse <= (UINT64_C(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+        double v = (double)mantisse;
+        v = (exp10 < 0) ? v / puissances10[-exp10] : v * puissances10[exp10];
+        *valeur = negatif ? -v : v;
+        return p;
+    }
+    if (mantisse == 0) {
+        *valeur = negatif ? -0.0 : 0.0;
+        return p;
+    }
+    return nombre_lent(debut, fin, valeur);
+}
+
+/* Saute blancs et fins de ligne en comptant les lignes */
+static const char *sauter_blancs(const char *p, const char *fin, size_t *ligne) {
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        if (*p == '\n') (*ligne)++;
+        p++;
+    }
+    return p;
+}
+
+static LectureCode analyser(const char *p, const char *fin, Points *pts, PointsType type, size_t *ligne) {
+    size_t n = 0, i;
+
+    // Premiere ligne : nombre de points
+    while (p < fin && (*p == ' ' || *p == '\t')) p++;
+    if (p >= fin || !est_chiffre(*p)) return LECTURE_ENTETE;
+    while (p < fin && est_chiffre(*p)) {
+        if (n > ((size_t)-1) / 10) return LECTURE_ENTETE;
+        n = n * 10 + (size_t)(*p - '0');
+        p++;
+    }
+    while (p < fin && *p != '\n') p++;
+    if (n == 0) return LECTURE_ENTETE;
+
+    if (points_alloc(pts, n, type) != 0) return LECTURE_ALLOCATION;
+
+    // Lignes "x, y"
+    for (i = 0; i < n; i++) {
+        double x, y;
+
+        p = sauter_blancs(p, fin, ligne);
+        if (p >= fin) return LECTURE_TRONQUE;
+
+        p = lecture_nombre(p, fin, &x);
+        if (!p) return LECTURE_FORMAT;
+        while (p < fin && (*p == ' ' || *p == '\t')) p++;
+        if (p >= fin || *p != ',') return LECTURE_FORMAT;
+        p = lecture_nombre(p + 1, fin, &y);
+        if (!p) return LECTURE_FORMAT;
+        while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        if (p < fin && *p != '\n') return LECTURE_FORMAT;
+
+        if (type == POINTS_FLOAT) {
+            pts->xf[i] = (float)x;
+            pts->yf[i] = (float)y;
+        } else {
+            pts->xd[i] = x;
+            pts->yd[i] = y;
+        }
+    }
+    return LECTURE_OK;
+}
+
+/* Entier positif de l'entete ; retourne la position suivante, ou NULL */
+static const char *entier_entete(const char *p, const char *fin, size_t *valeur) {
+    size_t v = 0;
+
+    while (p < fin && (*p == ' ' || *p == '\t')) p++;
+    if (p >= fin || !est_chiffre(*p)) return NULL;
+    while (p < fin && est_chiffre(*p)) {
+        if (v > ((size_t)-1) / 10) return NULL;
+        v = v * 10 + (size_t)(*p - '0');
+        p++;
+    }
+    *valeur = v;
+    return p;
+}
+
+static LectureCode analyser_tableau(const char *p, const char *fin, Tableau *t, size_t *ligne) {
+    size_t n, k = 1, i;
+    const char *q;
+    double *v;
+    int j;
+
+    // Premiere ligne : "n" ou "n k"
+    p = entier_entete(p, fin, &n);
+    if (!p || n == 0) return LECTURE_ENTETE;
+    q = entier_entete(p, fin, &k);
+    if (q) p = q;
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    if (p < fin && *p != '\n') return LECTURE_ENTETE;
+    if (k == 0 || k > LECTURE_COLONNES_MAX) return LECTURE_ENTETE;
+
+    if (tableau_alloc(t, n, (int)k) != 0) return LECTURE_ALLOCATION;
+
+    // Lignes "x1, ..., xk, y"
+    for (i = 0, v = t->v; i < n; i++) {
+        p = sauter_blancs(p, fin, ligne);
+        if (p >= fin) return LECTURE_TRONQUE;
+
+        for (j = 0; j <= t->k; j++) {
+            if (j > 0) {
+                while (p < fin && (*p == ' ' || *p == '\t')) p++;
+                if (p >= fin || *p != ',') return LECTURE_FORMAT;
+                p++;
+            }
+            p = lecture_nombre(p, fin, v++);
+            if (!p) return LECTURE_FORMAT;
+        }
+        while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        if (p < fin && *p != '\n') return LECTURE_FORMAT;
+    }
+    return LECTURE_OK;
+}
+
+/*
+ * Fichier binaire en colonnes (binaire.h). Meme precision : la projection
+ * devient le stockage des points (lecture seule). Sinon conversion dans
+ * un bloc alloue. Retourne 1 si la projection a ete confiee a pts.
+ */
+static int binaire(void *carte, size_t octets, Points *pts, PointsType type, LectureCode *code) {
+    const BinaireEntete *e = (const BinaireEntete *)carte;
+    size_t elt, colonne;
+    char *base = (char *)carte;
+    size_t i;
+
+    *code = LECTURE_ENTETE;
+    if (e->boutisme != BINAIRE_BOUTISME || e->type > POINTS_DOUBLE || e->n == 0) return 0;
+    elt = (e->type == POINTS_FLOAT) ? sizeof(float) : sizeof(double);
+    if (e->n > ((size_t)-1) / 4 / elt) return 0;
+    if (e->offset_x % POINTS_ALIGN != 0 || e->offset_y % POINTS_ALIGN != 0) return 0;
+    if (e->offset_x < sizeof(BinaireEntete) || e->offset_y < sizeof(BinaireEntete)) return 0;
+
+    colonne = (size_t)e->n * elt;
+    *code = LECTURE_TRONQUE;
+    if (e->offset_x > octets || octets - e->offset_x < colonne) return 0;
+    if (e->offset_y > octets || octets - e->offset_y < colonne) return 0;
+
+    *code = LECTURE_OK;
+    if ((PointsType)e->type == type) {
+        pts->n = (size_t)e->n;
+        pts->type = type;
+        pts->projection = carte;
+        pts->projection_octets = octets;
+        if (type == POINTS_FLOAT) {
+            pts->xf = (float *)(base + e->offset_x);
+            pts->yf = (float *)(base + e->offset_y);
+        } else {
+            pts->xd = (double *)(base + e->offset_x);
+            pts->yd = (double *)(base + e->offset_y);
+        }
+        return 1;
+    }
+
+    if (points_alloc(pts, (size_t)e->n, type) != 0) {
+        *code = LECTURE_ALLOCATION;
+        return 0;
+    }
+    if (type == POINTS_FLOAT) {
+        const double *x = (const double *)(base + e->offset_x);
+        const double *y = (const double *)(base + e->offset_y);
+        for (i = 0; i < pts->n; i++) {
+            pts->xf[i] = (float)x[i];
+            pts->yf[i] = (float)y[i];
+        }
+    } else {
+        const float *x = (const float *)(base + e->offset_x);
+        const float *y = (const float *)(base + e->offset_y);
+        for (i = 0; i < pts->n; i++) {
+            pts->xd[i] = x[i];
+            pts->yd[i] = y[i];
+        }
+    }
+    return 0;
+}
+
+LectureCode lecture_points(const char *filename, Points *pts, PointsType type, LectureInfo *info) {
+    LectureInfo local;
+    LectureCode code;
+    struct stat st;
+    void *carte;
+    int fd;
+
+    if (!info) info = &local;
+    memset(info, 0, sizeof(*info));
+    memset(pts, 0, sizeof(*pts));
+    info->ligne = 1;
+    info->secondes = maintenant();
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) return LECTURE_OUVERTURE;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return LECTURE_OUVERTURE;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return LECTURE_ENTETE;
+    }
+
+    info->octets = (size_t)st.st_size;
+    carte = mmap(NULL, info->octets, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (carte == MAP_FAILED) return LECTURE_OUVERTURE;
+    posix_madvise(carte, info->octets, POSIX_MADV_SEQUENTIAL);
+
+    if (info->octets >= sizeof(BinaireEntete) && memcmp(carte, BINAIRE_MAGIE, 8) == 0) {
+        if (!binaire(carte, info->octets, pts, type, &code)) munmap(carte, info->octets);
+    } else {
+        code = analyser((const char *)carte, (const char *)carte + info->octets, pts, type, &info->ligne);
+        munmap(carte, info->octets);
+    }
+
+    if (code != LECTURE_OK) points_free(pts);
+    info->secondes = maintenant() - info->secondes;
+    return code;
+}
+
+LectureCode lecture_tableau(const char *filename, Tableau *t, LectureInfo *info) {
+    LectureInfo local;
+    LectureCode code;
+    struct stat st;
+    void *carte;
+    int fd;
+
+    if (!info) info = &local;
+    memset(info, 0, sizeof(*info));
+    memset(t, 0, sizeof(*t));
+    info->ligne = 1;
+    info->secondes = maintenant();
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) return LECTURE_OUVERTURE;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return LECTURE_OUVERTURE;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return LECTURE_ENTETE;
+    }
+
+    info->octets = (size_t)st.st_size;
+    carte = mmap(NULL, info->octets, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (carte == MAP_FAILED) return LECTURE_OUVERTURE;
+    posix_madvise(carte, info->octets, POSIX_MADV_SEQUENTIAL);
+
+    code = analyser_tableau((const char *)carte, (const char *)carte + info->octets, t, &info->ligne);
+    munmap(carte, info->octets);
+
+    if (code != LECTURE_OK) tableau_free(t);
+    info->secondes = maintenant() - info->secondes;
+    return code;
+}
+
+const char *lecture_message(LectureCode code) {
+    switch (code) {
+        case LECTURE_OK:         return "Lecture reussie";
+        case LECTURE_OUVERTURE:  return "Probleme a l'ouverture du fichier...";
+        case LECTURE_ENTETE:     return "Nombre de points invalide...";
+        case LECTURE_ALLOCATION: return "Probleme d'allocation memoire pour les donnees...";
+        case LECTURE_FORMAT:     return "Format de donnees invalide (ligne attendue: x, y)...";
+        case LECTURE_TRONQUE:    return "Erreur de lecture des donnees (lignes manquantes)...";
+    }
+    return "Erreur inconnue";
+}
+
+double lecture_debit(const LectureInfo *info) {
+    if (info->secondes <= 0.0) return 0.0;
+    return (double)info->octets / (1024.0 * 1024.0) / info->secondes;
+}
@@ -0,0 +1,63 @@
+/*
+ * lecture.h
+ * Chargement d'un fichier de points au format texte :
+ *   premiere ligne : nombre de points n
+ *   puis n lignes  : x, y
+ * Le fichier est projete en memoire (mmap) et analyse sans allocation
+ * par un convertisseur de nombres dedie ; le seul bloc alloue est celui
+ * du stockage des points. Aucune limite sur n autre que la memoire.
+ *
+ * Un fichier au format binaire en colonnes (binaire.h) est reconnu a sa
+ * signature : s'il a la precision demandee, ses colonnes sont utilisees
+ * directement dans la projection (en lecture seule) et le chargement ne
+ * coute que les defauts de page des calculs qui suivent.
+ */
+
+#ifndef LECTURE_H
+#define LECTURE_H
+
+#include <stddef.h>
+#include "points.h"
+
+#define LECTURE_COLONNES_MAX 4096
+
+typedef enum {
+    LECTURE_OK = 0,
+    LECTURE_OUVERTURE,      /* fichier introuvable ou illisible */
+    LECTURE_ENTETE,         /* premiere ligne absente ou invalide */
+    LECTURE_ALLOCATION,     /* memoire insuffisante pour n points */
+    LECTURE_FORMAT,         /* ligne de donnees mal formee */
+    LECTURE_TRONQUE         /* moins de n lignes de donnees */
+} LectureCode;
+
+typedef struct {
+    size_t octets;          /* taille du fichier analyse */
+    double secondes;        /* duree de l'analyse (ouverture comprise) */
+    size_t ligne;           /* ligne fautive en cas d'erreur (1 = entete) */
+} LectureInfo;
+
+/* Charge filename dans pts avec la precision demandee. info peut etre NULL. */
+LectureCode lecture_points(const char *filename, Points *pts, PointsType type, LectureInfo *info);
+
+/*
+ * Charge un fichier a plusieurs variables explicatives :
+ *   premiere ligne : n k   (k = 1 si absent : le format de donnees.txt)
+ *   puis n lignes  : x1, x2, ..., xk, y
+ * k est au plus LECTURE_COLONNES_MAX. info peut etre NULL.
+ */
+LectureCode lecture_tableau(const char *filename, Tableau *t, LectureInfo *info);
+
+/* Message lisible associe a un code d'erreur */
+const char *lecture_message(LectureCode code);
+
+/* Debit d'analyse en Mo/s */
+double lecture_debit(const LectureInfo *info);
+
+/*
+ * Convertit le nombre decimal commencant en p (espaces initiaux ignores)
+ * sans depasser fin. Retourne la position qui suit le nombre, ou NULL si
+ * aucun nombre n'a pu etre lu.
+ */
+const char *lecture_nombre(const char *p, const char *fin, double *valeur);
+
+#endif
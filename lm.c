@@ -0,0 +1,49 @@
+/*
+ * lm.c
+ * Levenberg-Marquardt pour a * exp(b x) (voir lm.h).
+ */
+
+#include "lm.h"
+#include "ajuste.h"
+
+typedef struct {
+    LmEvaluer evaluer;
+    void *ctx;
+} Appel;
+
+static inline int appeler(void *ctx, double a, double b, double s[6]) {
+    const Appel *c = (const Appel *)ctx;
+    return c->evaluer(c->ctx, a, b, s);
+}
+
+LM_DEFINIR(minimiser, appeler)
+
+void lm_options_defaut(LmOptions *o) {
+    o->max_iterations = 200;
+    o->tol_gradient = 1e-12;
+    o->tol_pas = 1e-8;
+    o->tol_cout = 1e-12;
+    o->lambda = 1e-3;
+    o->trace = NULL;
+}
+
+LmResultat lm_exponentiel(const Points *pts, double a, double b, const LmOptions *o) {
+    return ajuste_exp_lm(pts->xd, pts->yd, pts->n, a, b, o);
+}
+
+LmResultat lm_minimiser(LmEvaluer evaluer, void *ctx, double a, double b, const LmOptions *o) {
+    Appel c = { evaluer, ctx };
+    return minimiser(&c, a, b, o);
+}
+
+const char *lm_raison(LmRaison r) {
+    switch (r) {
+        case LM_GRADIENT:       return "gradient nul (convergence)";
+        case LM_PAS:            return "pas negligeable (convergence)";
+        case LM_COUT:           return "cout stationnaire (convergence)";
+        case LM_MAX_ITERATIONS: return "maximum d'iterations atteint";
+        case LM_STAGNATION:     return "aucun pas ne fait baisser le cout";
+        case LM_ECHEC:          return "evaluation impossible (erreur de lecture)";
+    }
+    return "inconnue";
+}
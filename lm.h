@@ -0,0 +1,165 @@
+/*
+ * lm.h
+ * Ajustement de f(x) = a * exp(b x) par Levenberg-Marquardt
+ * (Gauss-Newton amorti). Chaque evaluation construit JᵀJ (2x2), Jᵀr et
+ * le cout en une seule passe sur les donnees (expvec_normales), repartie
+ * sur le pool de threads. Le pas resout (JᵀJ + λ diag(JᵀJ)) δ = -Jᵀr.
+ *
+ * La boucle est ecrite une fois, dans LM_DEFINIR, pour un evaluateur
+ * connu a la compilation (ajuste.h en tire un LM par modele et par type) ;
+ * lm_minimiser en est l'instance qui appelle un evaluateur quelconque.
+ */
+
+#ifndef LM_H
+#define LM_H
+
+#include <math.h>
+#include "points.h"
+#include "trace.h"
+
+typedef enum {
+    LM_GRADIENT,            /* max |∂J| sous le seuil */
+    LM_PAS,                 /* pas relatif sous le seuil */
+    LM_COUT,                /* baisse relative du cout sous le seuil */
+    LM_MAX_ITERATIONS,      /* budget d'iterations epuise */
+    LM_STAGNATION,          /* aucun pas n'ameliore le cout, meme tres amorti */
+    LM_ECHEC                /* l'evaluateur a signale une erreur */
+} LmRaison;
+
+typedef struct {
+    int max_iterations;
+    double tol_gradient;
+    double tol_pas;
+    double tol_cout;
+    double lambda;          /* amortissement initial */
+    Trace *trace;           /* depart, pas acceptes et arret (pas : λ) ; NULL : aucune */
+} LmOptions;
+
+typedef struct {
+    double a, b;
+    double cout;            /* J = (1/2n) Σ r² */
+    int iterations;         /* pas acceptes */
+    int evaluations;        /* passes sur les donnees */
+    LmRaison raison;
+} LmResultat;
+
+void lm_options_defaut(LmOptions *o);
+
+/* Points en double precision ; (a, b) est le point de depart */
+LmResultat lm_exponentiel(const Points *pts, double a, double b, const LmOptions *o);
+
+/*
+ * Meme algorithme sur des donnees quelconques : evaluer remplit les six
+ * sommes de expvec_normales divisees par n pour (a, b), et retourne 0
+ * (ou une valeur non nulle pour abandonner). Sert au parcours en flux.
+ */
+typedef int (*LmEvaluer)(void *ctx, double a, double b, double s[6]);
+LmResultat lm_minimiser(LmEvaluer evaluer, void *ctx, double a, double b, const LmOptions *o);
+
+const char *lm_raison(LmRaison r);
+
+/* ===== Boucle engendree ===== */
+
+#define LM_LAMBDA_MAX 1e16
+
+/* Point courant dans la trace : J = s0/2, ∇J = (s1, s2) */
+static inline void lm_tracer(const LmOptions *o, int iteration, double a, double b, const double s[6],
+                             double lambda, int final) {
+    double p[2] = { a, b };
+
+    if (!o->trace) return;
+    if (final) trace_terminer(o->trace, iteration, p, s[0] / 2.0, hypot(s[1], s[2]), lambda);
+    else trace_enregistrer(o->trace, iteration, p, s[0] / 2.0, hypot(s[1], s[2]), lambda);
+}
+
+/*
+ * LM_DEFINIR(nom, EVALUER) engendre
+ *   static inline LmResultat nom(void *ctx, double a, double b, const LmOptions *o)
+ * pour l'evaluateur int EVALUER(void *ctx, double a, double b, double s[6])
+ * (memes sommes que LmEvaluer), appele directement dans la boucle.
+ */
+#define LM_DEFINIR(nom, EVALUER)                                                \
+static inline LmResultat nom(void *ctx, double a, double b, const LmOptions *o) { \
+    LmResultat res;                                                             \
+    double s[6], t[6];                                                          \
+    double lambda = o->lambda;                                                  \
+                                                                                \
+    res.evaluations = 1;                                                        \
+    res.iterations = 0;                                                         \
+    res.raison = LM_MAX_ITERATIONS;                                             \
+    if (EVALUER(ctx, a, b, s) != 0) {                                           \
+        res.raison = LM_ECHEC;                                                  \
+        res.a = a;                                                              \
+        res.b = b;                                                              \
+        res.cout = 0.0;                                                         \
+        return res;                                                             \
+    }                                                                           \
+    lm_tracer(o, 0, a, b, s, lambda, 0);                                        \
+                                                                                \
+    while (res.iterations < o->max_iterations) {                                \
+        /* J = s0/2, ∇J = (s1, s2), JᵀJ/n = [s3 s4; s4 s5] */                   \
+        double g0 = s[1], g1 = s[2];                                            \
+                                                                                \
+        if (fabs(g0) <= o->tol_gradient && fabs(g1) <= o->tol_gradient) {       \
+            res.raison = LM_GRADIENT;                                           \
+            break;                                                              \
+        }                                                                       \
+                                                                                \
+        for (;;) {                                                              \
+            double h00 = s[3] + lambda * fmax(s[3], 1e-300);                    \
+            double h11 = s[5] + lambda * fmax(s[5], 1e-300);                    \
+            double h01 = s[4];                                                  \
+            double det = h00 * h11 - h01 * h01;                                 \
+            double da, db, norme_pas, norme_p;                                  \
+                                                                                \
+            if (!(det > 0.0) || !isfinite(det)) {                               \
+                lambda *= 10.0;                                                 \
+                if (lambda > LM_LAMBDA_MAX) break;                              \
+                continue;                                                       \
+            }                                                                   \
+            da = -(h11 * g0 - h01 * g1) / det;                                  \
+            db = -(h00 * g1 - h01 * g0) / det;                                  \
+                                                                                \
+            res.evaluations++;                                                  \
+            if (EVALUER(ctx, a + da, b + db, t) != 0) {                         \
+                res.raison = LM_ECHEC;                                          \
+                break;                                                          \
+            }                                                                   \
+                                                                                \
+            if (isfinite(t[0]) && t[0] <= s[0]) {                               \
+                double baisse = (s[0] - t[0]) / s[0];                           \
+                int j;                                                          \
+                                                                                \
+                a += da;                                                        \
+                b += db;                                                        \
+                for (j = 0; j < 6; j++) s[j] = t[j];                            \
+                res.iterations++;                                               \
+                lambda = fmax(lambda / 10.0, 1e-12);                            \
+                lm_tracer(o, res.iterations, a, b, s, lambda, 0);               \
+                                                                                \
+                norme_pas = sqrt(da * da + db * db);                            \
+                norme_p = sqrt(a * a + b * b);                                  \
+                if (norme_pas <= o->tol_pas * (norme_p + o->tol_pas)) res.raison = LM_PAS; \
+                else if (baisse <= o->tol_cout) res.raison = LM_COUT;           \
+                break;                                                          \
+            }                                                                   \
+            lambda *= 10.0;                                                     \
+            if (lambda > LM_LAMBDA_MAX) break;                                  \
+        }                                                                       \
+                                                                                \
+        if (res.raison == LM_ECHEC) break;                                      \
+        if (lambda > LM_LAMBDA_MAX) {                                           \
+            res.raison = LM_STAGNATION;                                         \
+            break;                                                              \
+        }                                                                       \
+        if (res.raison != LM_MAX_ITERATIONS) break;                             \
+    }                                                                           \
+                                                                                \
+    lm_tracer(o, res.iterations, a, b, s, lambda, 1);                           \
+    res.a = a;                                                                  \
+    res.b = b;                                                                  \
+    res.cout = s[0] / 2.0;                                                      \
+    return res;                                                                 \
+}
+
+#endif
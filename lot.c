@@ -0,0 +1,219 @@
+/*
+ * lot.c
+ * Traitement par lot : ajuste un modele sur de nombreux fichiers de points
+ * dans un seul processus et ecrit un tableau de resultats unique.
+ *
+ * Usage : ./lot [-s solveur] [-l manifeste] [-o sortie] [-j threads] [-i] [-c Mo] fichiers...
+ *   -s moindres   droite des moindres carres (defaut)
+ *      lineaire   droite par descente du gradient (sur les moments, comme gauchy.c)
+ *      exp        a*exp(b x) par descente du gradient (comme gauchy_exp.c)
+ *      lm         a*exp(b x) par Levenberg-Marquardt
+ *      sgd        a*exp(b x) par gradient stochastique en mini-lots
+ *      theilsen   droite de Theil-Sen (mediane des pentes)
+ *      siegel     droite de Siegel (mediane repetee des pentes)
+ *   -l fichier    liste de fichiers, un chemin ou motif par ligne ("-" : entree standard)
+ *   -o fichier    tableau de sortie (defaut : sortie standard)
+ *   -j k          nombre de threads (defaut : REGRESSION_THREADS ou nombre de coeurs)
+ *   -i            depart log-lineaire pour exp, lm et sgd (voir moments_exponentielle)
+ *   -c Mo         hors memoire : fichiers relus par morceaux (flux.h) avec ce
+ *                 budget de tampons par fichier, au lieu d'etre charges
+ * Les solveurs et leurs parametres sont ceux de solveurs.c.
+ * Les arguments et les lignes du manifeste sont developpes comme motifs (glob).
+ *
+ * Chaque fichier est une tache du pool : lecture puis ajustement dans le
+ * meme thread, pendant que les autres threads lisent ou ajustent d'autres
+ * fichiers. Les calculs internes d'une tache restent sequentiels, et le
+ * tableau est ecrit dans l'ordre des fichiers une fois le lot termine.
+ *
+ * Compilation : gcc -O2 lot.c solveurs.c flux.c points.c lecture.c pool.c moments.c expvec.c lm.c sgd.c optim.c trace.c robuste.c -o lot -lm -pthread
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glob.h>
+#include <time.h>
+#include "points.h"
+#include "lecture.h"
+#include "pool.h"
+#include "solveurs.h"
+
+typedef struct {
+    const char *fichier;
+    size_t n;
+    Ajustement aj;
+} Resultat;
+
+typedef struct {
+    Solveur solveur;
+    int init_log;
+    size_t budget;          /* > 0 : lecture par morceaux */
+    Resultat *resultats;
+} Lot;
+
+typedef struct {
+    char **noms;
+    size_t n, capacite;
+} Liste;
+
+static void error_and_exit(const char *msg) {
+    fprintf(stderr, "%s\n", msg);
+    exit(EXIT_FAILURE);
+}
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ===== Liste des fichiers ===== */
+
+static void liste_ajouter(Liste *l, const char *nom) {
+    if (l->n == l->capacite) {
+        l->capacite = l->capacite ? 2 * l->capacite : 64;
+        l->noms = realloc(l->noms, l->capacite * sizeof(*l->noms));
+        if (!l->noms) error_and_exit("Memoire insuffisante pour la liste de fichiers");
+    }
+    l->noms[l->n] = strdup(nom);
+    if (!l->noms[l->n]) error_and_exit("Memoire insuffisante pour la liste de fichiers");
+    l->n++;
+}
+
+/* Developpe un motif ; un nom sans correspondance est garde tel quel (erreur de lecture ensuite) */
+static void liste_motif(Liste *l, const char *motif) {
+    glob_t g;
+    size_t i;
+
+    if (glob(motif, GLOB_NOCHECK, NULL, &g) != 0) {
+        liste_ajouter(l, motif);
+        return;
+    }
+    for (i = 0; i < g.gl_pathc; i++) liste_ajouter(l, g.gl_pathv[i]);
+    globfree(&g);
+}
+
+static void liste_manifeste(Liste *l, const char *manifeste) {
+    FILE *f = strcmp(manifeste, "-") == 0 ? stdin : fopen(manifeste, "r");
+    char *ligne = NULL;
+    size_t taille = 0;
+    ssize_t lu;
+
+    if (!f) {
+        fprintf(stderr, "%s : ", manifeste);
+        error_and_exit("manifeste illisible");
+    }
+    while ((lu = getline(&ligne, &taille, f)) != -1) {
+        while (lu > 0 && (ligne[lu - 1] == '\n' || ligne[lu - 1] == '\r' || ligne[lu - 1] == ' '))
+            ligne[--lu] = '\0';
+        if (lu == 0 || ligne[0] == '#') continue;
+        liste_motif(l, ligne);
+    }
+    free(ligne);
+    if (f != stdin) fclose(f);
+}
+
+/* ===== Lot ===== */
+
+/* Tache t : lecture puis ajustement du fichier t */
+static void tache_fichier(void *ctx, size_t t) {
+    const Lot *lot = (const Lot *)ctx;
+    Resultat *r = &lot->resultats[t];
+    Points pts;
+    LectureCode code;
+
+    if (lot->budget > 0) {
+        Flux *flux;
+        code = flux_ouvrir(r->fichier, lot->budget, &flux, NULL);
+        if (code != LECTURE_OK) {
+            r->aj.statut = lecture_message(code);
+            return;
+        }
+        r->n = flux_n(flux);
+        r->aj = solveur_ajuster_flux(lot->solveur, flux, lot->init_log);
+        flux_fermer(flux);
+        return;
+    }
+
+    code = lecture_points(r->fichier, &pts, solveur_type(lot->solveur), NULL);
+    if (code != LECTURE_OK) {
+        r->aj.statut = lecture_message(code);
+        return;
+    }
+    r->n = pts.n;
+    r->aj = solveur_ajuster(lot->solveur, &pts, lot->init_log);
+    points_free(&pts);
+}
+
+/* ===== Programme principal ===== */
+
+int main(int argc, char **argv) {
+    Liste liste = { NULL, 0, 0 };
+    const char *sortie = NULL;
+    Lot lot = { SOLVEUR_MOINDRES, 0, 0, NULL };
+    Pool *pool;
+    FILE *out;
+    double debut;
+    size_t i, echecs = 0;
+    int k;
+
+    for (k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "-s") == 0 && k + 1 < argc) {
+            if (solveur_depuis_nom(argv[++k], &lot.solveur) != 0)
+                error_and_exit("Solveur inconnu (moindres, lineaire, exp, lm, sgd, theilsen, siegel)");
+        } else if (strcmp(argv[k], "-l") == 0 && k + 1 < argc) {
+            liste_manifeste(&liste, argv[++k]);
+        } else if (strcmp(argv[k], "-o") == 0 && k + 1 < argc) {
+            sortie = argv[++k];
+        } else if (strcmp(argv[k], "-j") == 0 && k + 1 < argc) {
+            /* avant la creation du pool par defaut, utilise aussi par les solveurs */
+            setenv("REGRESSION_THREADS", argv[++k], 1);
+        } else if (strcmp(argv[k], "-i") == 0) {
+            lot.init_log = 1;
+        } else if (strcmp(argv[k], "-c") == 0 && k + 1 < argc) {
+            lot.budget = (size_t)(atof(argv[++k]) * 1024 * 1024);
+            if (lot.budget == 0) error_and_exit("Budget de lecture invalide");
+        } else if (argv[k][0] == '-' && argv[k][1] != '\0') {
+            fprintf(stderr, "Usage : %s [-s moindres|lineaire|exp|lm|sgd|theilsen|siegel] [-l manifeste] "
+                            "[-o sortie] [-j threads] [-i] [-c Mo] fichiers...\n", argv[0]);
+            return EXIT_FAILURE;
+        } else {
+            liste_motif(&liste, argv[k]);
+        }
+    }
+    if (liste.n == 0) error_and_exit("Aucun fichier a traiter");
+
+    lot.resultats = calloc(liste.n, sizeof(*lot.resultats));
+    if (!lot.resultats) error_and_exit("Memoire insuffisante pour les resultats");
+    for (i = 0; i < liste.n; i++) {
+        lot.resultats[i].fichier = liste.noms[i];
+        lot.resultats[i].aj.statut = "non traite";
+    }
+
+    pool = pool_defaut();
+    if (!pool) error_and_exit("Creation du pool de threads impossible");
+
+    debut = maintenant();
+    pool_executer(pool, liste.n, tache_fichier, &lot);
+
+    out = sortie ? fopen(sortie, "w") : stdout;
+    if (!out) error_and_exit("Fichier de sortie impossible a creer");
+    fprintf(out, "# fichier\tn\tsolveur\tp0\tp1\tcout\titerations\tstatut\n");
+    for (i = 0; i < liste.n; i++) {
+        const Resultat *r = &lot.resultats[i];
+        fprintf(out, "%s\t%zu\t%s\t%.9g\t%.9g\t%.9g\t%d\t%s\n", r->fichier, r->n,
+                solveur_nom(lot.solveur), r->aj.p0, r->aj.p1, r->aj.cout, r->aj.iterations, r->aj.statut);
+        if (strcmp(r->aj.statut, "ok") != 0) echecs++;
+    }
+    if (out != stdout) fclose(out);
+
+    fprintf(stderr, "%zu fichiers (%zu en echec) en %.3f s sur %d threads\n",
+            liste.n, echecs, maintenant() - debut, pool_threads(pool));
+
+    for (i = 0; i < liste.n; i++) free(liste.noms[i]);
+    free(liste.noms);
+    free(lot.resultats);
+    return echecs ? 2 : 0;
+}
@@ -1,44 +1,62 @@
+/*
+ * moinCarre.c
+ * Regression lineaire y = a0 + a1 x par la methode des moindres carres (menu interactif).
+ * Les graphiques passent par un gnuplot persistant (graphe.h) : fenetre si
+ * DISPLAY est defini, sinon regression_plot.png ; le menu n'attend pas le rendu.
+ * Le choix 4 ajuste une droite resistante aux points aberrants (robuste.h),
+ * le choix 5 donne des intervalles de confiance de a0 et a1 par bootstrap
+ * (bootstrap.h, REGRESSION_BOOTSTRAP=B repliques).
+ * Compilation : gcc moinCarre.c points.c lecture.c moments.c pool.c graphe.c reduction.c ecriture.c robuste.c bootstrap.c lm.c expvec.c trace.c -o moinCarre -lm -pthread
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include "points.h"
+#include "lecture.h"
+#include "moments.h"
+#include "ajuste.h"
+#include "graphe.h"
+#include "ecriture.h"
+#include "robuste.h"
+#include "bootstrap.h"
+#include "pool.h"
 
 /* ===== PROTOTYPES ===== */
 
 /* Fonctions de lecture et affichage */
-void getDataf(char *filename, float ***data, int *n, int *max_points);
-void displayPoints(float **data, int n);
+void getDataf(char *filename, Points *pts);
+void displayPoints(const Points *pts);
 void displayResults(float a0, float a1, float cost);
+void displayBootstrap(const Points *pts);
 
 /* Fonctions de calcul - Méthode des moindres carrés */
-float computeCost(float **data, int n, float a0, float a1);
-void leastSquares(float **data, int n, float *a0, float *a1);
+float computeCost(const Points *pts, float a0, float a1);
+void leastSquares(const Points *pts, float *a0, float *a1);
+int robustLine(const Points *pts, int siegel, float *a0, float *a1);
 
 /* Fonctions pour gnuplot */
-void generatePlotData(float **data, int n, float a0, float a1, char *datafile, char *fitfile);
-void plotWithGnuplot(float **data, int n, float a0, float a1);
+void plotWithGnuplot(Graphe *graphe, const Points *pts, float a0, float a1, const char *methode);
 
 /* Fonctions utilitaires */
-void freeMemory(float **data, int n);
-void error(char *message);
+void error(const char *message);
 
 /* ===== PROGRAMME PRINCIPAL ===== */
 int main(void) {
     printf("Regression lineaire par methode des moindres carres\n");
     printf("===================================================\n\n");
 // donnees   
-    float **data = NULL;
-    int n = 0;
+    Points pts;
     float a0 = 0.0f, a1 = 0.0f;
     int regression_faite = 0;  // 0 = non, 1 = oui
-    
-// Variables pour les paramètres
-    int max_points = 1000;
+    const char *methode = "moindres carres";
+    Graphe *graphe = NULL;     // gnuplot lance au premier trace
     
 // Lecture des données depuis le fichier
-    getDataf("donnees.txt", &data, &n, &max_points);
+    getDataf("donnees.txt", &pts);
     
-    printf("Nombre de points de donnees: %d\n\n", n);
+    printf("Nombre de points de donnees: %zu\n\n", pts.n);
     
 // Menu de choix
     int choix;
@@ -47,6 +65,8 @@ int main(void) {
         printf("1. Effectuer la regression et afficher les resultats\n");
         printf("2. Generer un graphique avec gnuplot\n");
         printf("3. Quitter\n");
+        printf("4. Droite robuste (Theil-Sen ou Siegel)\n");
+        printf("5. Intervalles de confiance (bootstrap)\n");
         printf("Votre choix: ");
         scanf("%d", &choix);
         
@@ -55,15 +75,15 @@ int main(void) {
                 printf("\n=== REGRESSION LINEAIRE PAR MOINDRES CARRES ===\n");
                 
                 // Afficher les données
-                displayPoints(data, n);
+                displayPoints(&pts);
                 
                 // Résolution par méthode des moindres carrés
                 printf("\n=== CALCUL EN COURS ===\n");
                 printf("Calcul des sommes...\n");
-                leastSquares(data, n, &a0, &a1);
+                leastSquares(&pts, &a0, &a1);
                 
                 // Calcul du coût (erreur quadratique moyenne)
-                float final_cost = computeCost(data, n, a0, a1);
+                float final_cost = computeCost(&pts, a0, a1);
                 
                 // Affichage détaillé des résultats
                 printf("\n=== RESULTATS DETAILLES ===\n");
@@ -73,17 +93,12 @@ int main(void) {
                 printf("  Pente (a1): %.6f\n", a1);
                 printf("\nMetriques d'erreur:\n");
                 printf("  Erreur quadratique moyenne: %.6f\n", final_cost);
-                printf("  Racine de l'erreur quadratique moyenne: %.6f\n", sqrtf(final_cost * 2.0f * n));
-                printf("\nVerification avec les donnees:\n");
-                for (int i = 0; i < n; i++) {
-                    float prediction = a0 + a1 * data[i][0];
-                    float erreur = prediction - data[i][1];
-                    printf("  Point %d: x=%.3f, y_reel=%.3f, y_pred=%.3f, erreur=%.3f\n", 
-                           i+1, data[i][0], data[i][1], prediction, erreur);
-                }
+                printf("  Racine de l'erreur quadratique moyenne: %.6f\n", sqrtf(final_cost * 2.0f * pts.n));
+                ecriture_verification(pts.xf, pts.yf, pts.n, a0, a1);
                 printf("====================================\n");
                 
                 regression_faite = 1;
+                methode = "moindres carres";
                 break;
             }
             
@@ -98,12 +113,13 @@ int main(void) {
                     
                     if (effectuer_regression == 1) {
                         printf("\n=== CALCUL EN COURS ===\n");
-                        leastSquares(data, n, &a0, &a1);
-                        float final_cost = computeCost(data, n, a0, a1);
+                        leastSquares(&pts, &a0, &a1);
+                        float final_cost = computeCost(&pts, a0, a1);
                         printf("\nRegression terminee:\n");
                         printf("  a0 = %.6f, a1 = %.6f\n", a0, a1);
                         printf("  Erreur = %.6f\n", final_cost);
                         regression_faite = 1;
+                        methode = "moindres carres";
                     } else {
                         printf("Retour au menu principal.\n");
                         break;
@@ -111,7 +127,8 @@ int main(void) {
                 }
                 
                 printf("\nGeneration du graphique...\n");
-                plotWithGnuplot(data, n, a0, a1);
+                if (!graphe) graphe = graphe_ouvrir(getenv("DISPLAY") ? NULL : "regression_plot.png");
+                plotWithGnuplot(graphe, &pts, a0, a1, methode);
                 break;
             }
             
@@ -119,13 +136,37 @@ int main(void) {
                 printf("\nAu revoir!\n");
                 break;
                 
+            case 4: {
+                printf("\n=== DROITE ROBUSTE ===\n");
+                printf("Methode (1=Theil-Sen, 2=Siegel): ");
+                int siegel = 0;
+                scanf("%d", &siegel);
+                siegel = siegel == 2;
+                
+                if (robustLine(&pts, siegel, &a0, &a1) != 0) break;
+                float final_cost = computeCost(&pts, a0, a1);
+                printf("\nEquation de la droite ajustee: y = %.6f + %.6f * x\n", a0, a1);
+                printf("  Erreur quadratique moyenne: %.6f\n", final_cost);
+                ecriture_verification(pts.xf, pts.yf, pts.n, a0, a1);
+                printf("====================================\n");
+                
+                regression_faite = 1;
+                methode = siegel ? "mediane repetee de Siegel" : "Theil-Sen";
+                break;
+            }
+            
+            case 5:
+                displayBootstrap(&pts);
+                break;
+                
             default:
-                printf("Choix invalide! Veuillez choisir 1, 2 ou 3.\n");
+                printf("Choix invalide! Veuillez choisir 1, 2, 3, 4 ou 5.\n");
         }
     } while (choix != 3);
     
-    // Libération de la mémoire
-    freeMemory(data, n);
+    // Libération de la mémoire (le dernier trace demande est termine)
+    graphe_fermer(graphe);
+    points_free(&pts);
     
     return 0;
 }
@@ -133,252 +174,124 @@ int main(void) {
 /* ===== DEFINITIONS DES FONCTIONS ===== */
 
 /* ===== Lecture des données depuis fichier ===== */
-void getDataf(char *filename, float ***data, int *n, int *max_points) {
-    FILE *pf = NULL;
-    int i;
-    char ligne[100];
-    char *token;
-    
-    if ((pf = fopen(filename, "r")) == NULL) {
-        error("Probleme a l'ouverture du fichier...");
-    }
-    
-    // Lire le nombre de points (première ligne)
-    if (fgets(ligne, sizeof(ligne), pf) == NULL) {
-        error("Erreur de lecture de la premiere ligne...");
-    }
+void getDataf(char *filename, Points *pts) {
+    LectureInfo info;
+    LectureCode code = lecture_points(filename, pts, POINTS_FLOAT, &info);
     
-    *n = atoi(ligne);
-    if (*n <= 0 || *n > *max_points) {
-        error("Nombre de points invalide...");
+    if (code == LECTURE_FORMAT || code == LECTURE_TRONQUE) {
+        printf("Ligne %zu du fichier '%s'\n", info.ligne, filename);
     }
-    
-    // Allocation de la matrice pour stocker les points
-    *data = (float **)malloc((*n) * sizeof(float *));
-    if (!(*data)) error("Probleme d'allocation memoire pour les donnees...");
-    
-    for (i = 0; i < *n; i++) {
-        (*data)[i] = (float *)malloc(2 * sizeof(float));
-        if (!(*data)[i]) error("Probleme d'allocation memoire pour les points...");
+    if (code != LECTURE_OK) {
+        error(lecture_message(code));
     }
     
-    // Lire chaque ligne de données
-    for (i = 0; i < *n; i++) {
-        if (fgets(ligne, sizeof(ligne), pf) == NULL) {
-            error("Erreur de lecture des donnees...");
-        }
-        
-        // Supprimer le retour à la ligne
-        ligne[strcspn(ligne, "\n")] = 0;
-        
-        // Parser la ligne: format "x, y"
-        token = strtok(ligne, ",");
-        if (token == NULL) {
-            error("Format de donnees invalide (x manquant)...");
-        }
-        (*data)[i][0] = atof(token);  // x
-        
-        token = strtok(NULL, ",");
-        if (token == NULL) {
-            error("Format de donnees invalide (y manquant)...");
-        }
-        (*data)[i][1] = atof(token);  // y
-    }
-    
-    fclose(pf);
+    printf("Lecture: %.3f Mo en %.3f s (%.1f Mo/s)\n", 
+           info.octets / (1024.0 * 1024.0), info.secondes, lecture_debit(&info));
 }
 
 /* ===== Méthode des moindres carrés ===== */
-void leastSquares(float **data, int n, float *a0, float *a1) {
-    float sum_x = 0.0f, sum_y = 0.0f;
-    float sum_xy = 0.0f, sum_x2 = 0.0f;
-    float x_mean, y_mean;
-    int i;
-    
-    // Calcul des sommes
-    for (i = 0; i < n; i++) {
-        sum_x += data[i][0];
-        sum_y += data[i][1];
-        sum_xy += data[i][0] * data[i][1];
-        sum_x2 += data[i][0] * data[i][0];
-    }
-    
-    // Calcul des moyennes
-    x_mean = sum_x / n;
-    y_mean = sum_y / n;
-    
-    printf("Sommes calculees:\n");
-    printf("  Σx = %.6f\n", sum_x);
-    printf("  Σy = %.6f\n", sum_y);
-    printf("  Σxy = %.6f\n", sum_xy);
-    printf("  Σx² = %.6f\n", sum_x2);
-    printf("  Moyenne x = %.6f\n", x_mean);
-    printf("  Moyenne y = %.6f\n", y_mean);
-    
-    // Calcul des coefficients par la formule analytique
-    // a1 = (n*Σxy - Σx*Σy) / (n*Σx² - (Σx)²)
+void leastSquares(const Points *pts, float *a0, float *a1) {
+    Moments m;
+    double b0, b1;
+    
+    // Moyennes et co-moments centres en une passe (double precision)
+    moments_init(&m);
+    moments_ajouter_points(&m, pts);
+    
+    printf("Moments calcules:\n");
+    printf("  n = %.0f\n", m.n);
+    printf("  Moyenne x = %.6f\n", m.mx);
+    printf("  Moyenne y = %.6f\n", m.my);
+    printf("  Sxx = Σ(x-x̄)² = %.6f\n", m.sxx);
+    printf("  Sxy = Σ(x-x̄)(y-ȳ) = %.6f\n", m.sxy);
+    
+    // Calcul des coefficients sous forme centree
+    // a1 = Sxy / Sxx  (equivalent a (n*Σxy - Σx*Σy) / (n*Σx² - (Σx)²) sans annulation)
     // a0 = y_mean - a1*x_mean
     
-    float denom = n * sum_x2 - sum_x * sum_x;
-    
-    if (fabsf(denom) < 1e-10) {
+    if (moments_droite(&m, &b0, &b1) != 0) {
         printf("\nAttention: Matrice singuliere ou presque!\n");
         printf("Les points sont probablement alignes verticalement.\n");
-        *a1 = 0.0f;
-        *a0 = y_mean;
-    } else {
-        *a1 = (n * sum_xy - sum_x * sum_y) / denom;
-        *a0 = y_mean - (*a1) * x_mean;
     }
+    *a0 = (float)b0;
+    *a1 = (float)b1;
     
     printf("\nCoefficients calcules:\n");
-    printf("  a1 = (n*Σxy - Σx*Σy) / (n*Σx² - (Σx)²)\n");
-    printf("  a1 = (%d*%.6f - %.6f*%.6f) / (%d*%.6f - %.6f²)\n", 
-           n, sum_xy, sum_x, sum_y, n, sum_x2, sum_x);
-    printf("  a1 = %.6f / %.6f = %.6f\n", 
-           n*sum_xy - sum_x*sum_y, denom, *a1);
+    printf("  a1 = Sxy / Sxx\n");
+    printf("  a1 = %.6f / %.6f = %.6f\n", m.sxy, m.sxx, b1);
     printf("\n  a0 = ȳ - a1*x̄\n");
     printf("  a0 = %.6f - %.6f*%.6f = %.6f\n", 
-           y_mean, *a1, x_mean, *a0);
+           m.my, b1, m.mx, b0);
 }
 
-/* ===== Calcul du coût ===== */
-float computeCost(float **data, int n, float a0, float a1) {
-    float cost = 0.0f;
-    int i;
-    
-    for (i = 0; i < n; i++) {
-        float prediction = a0 + a1 * data[i][0];
-        float error = prediction - data[i][1];
-        cost += error * error;
+/* ===== Droite robuste : mediane des pentes (Theil-Sen) ou mediane repetee (Siegel) ===== */
+int robustLine(const Points *pts, int siegel, float *a0, float *a1) {
+    RobusteInfo info;
+    double b0, b1;
+    int code;
+    
+    printf("\n=== CALCUL EN COURS ===\n");
+    code = siegel ? robuste_siegel(pts, &b0, &b1, &info) : robuste_theil_sen(pts, &b0, &b1, &info);
+    if (code != 0) {
+        printf("Erreur: %s\n", code == -1 ? "les x sont tous egaux" : "memoire insuffisante");
+        return code;
     }
-    return cost / (2.0f * (float)n);
+    *a0 = (float)b0;
+    *a1 = (float)b1;
+    
+    printf("%s: %d tours de resserrement, %zu %s\n", siegel ? "Siegel" : "Theil-Sen", info.tours, info.calculs,
+           siegel ? "medianes interieures calculees" : "pentes enumerees");
+    printf("  a1 = mediane des pentes%s = %.6f\n", siegel ? " (mediane des medianes par point)" : "", b1);
+    printf("  a0 = mediane des (y - a1*x) = %.6f\n", b0);
+    return 0;
 }
 
-/* ===== Génération des fichiers pour gnuplot ===== */
-void generatePlotData(float **data, int n, float a0, float a1, char *datafile, char *fitfile) {
-    FILE *fdata = fopen(datafile, "w");
-    FILE *ffit = fopen(fitfile, "w");
-    int i;
-    
-    if (!fdata || !ffit) {
-        printf("Erreur lors de la creation des fichiers pour gnuplot.\n");
-        if (fdata) fclose(fdata);
-        if (ffit) fclose(ffit);
-        return;
-    }
-    
-    // Écrire les données dans le fichier
-    for (i = 0; i < n; i++) {
-        fprintf(fdata, "%.6f %.6f\n", data[i][0], data[i][1]);
-    }
-    
-    // Trouver les limites x
-    float xmin = data[0][0];
-    float xmax = data[0][0];
-    for (i = 1; i < n; i++) {
-        if (data[i][0] < xmin) xmin = data[i][0];
-        if (data[i][0] > xmax) xmax = data[i][0];
-    }
-    
-    // Étendre un peu les limites
-    xmin = xmin - 0.1 * (xmax - xmin);
-    xmax = xmax + 0.1 * (xmax - xmin);
-    
-    // Générer la droite de régression
-    float step = (xmax - xmin) / 100.0f;
-    for (float x = xmin; x <= xmax; x += step) {
-        float y = a0 + a1 * x;
-        fprintf(ffit, "%.6f %.6f\n", x, y);
-    }
-    
-    fclose(fdata);
-    fclose(ffit);
+/* ===== Calcul du coût ===== */
+float computeCost(const Points *pts, float a0, float a1) {
+    return (float)ajuste_droitef_cout(pts->xf, pts->yf, pts->n, a0, a1);
 }
 
-/* ===== Fonction pour créer et exécuter un script gnuplot ===== */
-void plotWithGnuplot(float **data, int n, float a0, float a1) {
-    // Générer les fichiers de données
-    generatePlotData(data, n, a0, a1, "donnees_plot.txt", "droite_plot.txt");
-    
-    // Créer le script gnuplot
-    FILE *gnuplot_script = fopen("regression.gnu", "w");
-    if (!gnuplot_script) {
-        printf("Erreur lors de la creation du script gnuplot.\n");
-        return;
+/* ===== Trace par le processus gnuplot persistant (graphe.h) ===== */
+void plotWithGnuplot(Graphe *graphe, const Points *pts, float a0, float a1, const char *methode) {
+    const float *x = pts->xf;
+    float xd[2], yd[2];
+    char titre[GRAPHE_TEXTE];
+    
+    // Droite de regression sur l'etendue des x elargie de 10 %
+    float xmin = x[0];
+    float xmax = x[0];
+    for (size_t i = 1; i < pts->n; i++) {
+        if (x[i] < xmin) xmin = x[i];
+        if (x[i] > xmax) xmax = x[i];
     }
-    
-    // Trouver les limites
-    float xmin = data[0][0];
-    float xmax = data[0][0];
-    float ymin = data[0][1];
-    float ymax = data[0][1];
-    
-    for (int i = 1; i < n; i++) {
-        if (data[i][0] < xmin) xmin = data[i][0];
-        if (data[i][0] > xmax) xmax = data[i][0];
-        if (data[i][1] < ymin) ymin = data[i][1];
-        if (data[i][1] > ymax) ymax = data[i][1];
-    }
-    
-    // Ajouter des marges
     float xrange = xmax - xmin;
-    float yrange = ymax - ymin;
-    xmin -= 0.1 * xrange;
-    xmax += 0.1 * xrange;
-    ymin -= 0.1 * yrange;
-    ymax += 0.1 * yrange;
-    
-    fprintf(gnuplot_script, "# Script gnuplot pour la regression lineaire\n");
-    fprintf(gnuplot_script, "set terminal pngcairo enhanced font 'Arial,12' size 800,600\n");
-    fprintf(gnuplot_script, "set output 'regression_plot.png'\n");
-    fprintf(gnuplot_script, "set title 'Regression lineaire par moindres carres\\n");
-    fprintf(gnuplot_script, "y = %.4f + %.4f x'\n", a0, a1);
-    fprintf(gnuplot_script, "set xlabel 'x'\n");
-    fprintf(gnuplot_script, "set ylabel 'y'\n");
-    fprintf(gnuplot_script, "set grid\n");
-    fprintf(gnuplot_script, "set key top left\n");
-    fprintf(gnuplot_script, "set xrange [%f:%f]\n", xmin, xmax);
-    fprintf(gnuplot_script, "set yrange [%f:%f]\n", ymin, ymax);
-    fprintf(gnuplot_script, "\n");
-    fprintf(gnuplot_script, "plot 'donnees_plot.txt' with points pt 7 ps 1.5 lc rgb 'blue' title 'Donnees', \\\n");
-    fprintf(gnuplot_script, "     'droite_plot.txt' with lines lw 2 lc rgb 'red' title 'Droite de regression'\n");
-    
-    fclose(gnuplot_script);
-    
-    // Exécuter gnuplot
-    printf("Execution de gnuplot...\n");
-    int result = system("gnuplot regression.gnu");
-    
-    if (result == 0) {
-        printf("\nGraphique genere avec succes!\n");
-        printf("Fichier cree: regression_plot.png\n");
-        
-        // Essayer d'afficher l'image
-        #ifdef _WIN32
-            system("start regression_plot.png");
-        #elif __APPLE__
-            system("open regression_plot.png");
-        #else
-            system("xdg-open regression_plot.png 2>/dev/null &");
-        #endif
-    } else {
-        printf("\nErreur: gnuplot non trouve ou erreur d'execution.\n");
-        printf("Installez gnuplot:\n");
-        printf("  Ubuntu: sudo apt install gnuplot\n");
-        printf("  Mac: brew install gnuplot\n");
-        printf("  Windows: telechargez depuis gnuplot.info\n");
+    xd[0] = xmin - 0.1f * xrange;
+    xd[1] = xmax + 0.1f * xrange;
+    yd[0] = ajuste_droitef_valeur(a0, a1, xd[0]);
+    yd[1] = ajuste_droitef_valeur(a0, a1, xd[1]);
+    
+    GrapheSerie series[2] = {
+        { pts->xf, pts->yf, pts->n, "points pt 7 ps 1.5 lc rgb 'blue'", "Donnees" },
+        { xd, yd, 2, "lines lw 2 lc rgb 'red'", "Droite de regression" },
+    };
+    snprintf(titre, sizeof(titre), "Regression lineaire par %s\ny = %.4f + %.4f x", methode, a0, a1);
+    
+    // Les donnees sont copiees : le rendu se fait en arriere-plan
+    if (!graphe || graphe_tracer(graphe, titre, series, 2) != 0) {
+        printf("\nErreur: impossible de lancer le trace.\n");
+        return;
     }
+    printf("Trace envoye a gnuplot (%s).\n", getenv("DISPLAY") ? "fenetre" : "regression_plot.png");
 }
 
 /* ===== Fonctions d'affichage ===== */
-void displayPoints(float **data, int n) {
-    int i;
+void displayPoints(const Points *pts) {
+    size_t i;
     
-    printf("Donnees chargees (%d points):\n", n);
+    printf("Donnees chargees (%zu points):\n", pts->n);
     printf("-----------------------------\n");
-    for (i = 0; i < n; i++) {
-        printf("  [%d] x = %6.3f, y = %6.3f\n", i+1, data[i][0], data[i][1]);
+    for (i = 0; i < pts->n; i++) {
+        printf("  [%zu] x = %6.3f, y = %6.3f\n", i+1, pts->xf[i], pts->yf[i]);
     }
     printf("\n");
 }
@@ -390,21 +303,27 @@ void displayResults(float a0, float a1, float cost) {
     printf("  Erreur = %.6f\n", cost);
 }
 
-/* ===== Fonctions utilitaires ===== */
-void freeMemory(float **data, int n) {
-    int i;
-    
-    if (data) {
-        for (i = 0; i < n; i++) {
-            if (data[i]) {
-                free(data[i]);
-            }
-        }
-        free(data);
+/* ===== Intervalles de confiance par bootstrap (bootstrap.h) ===== */
+void displayBootstrap(const Points *pts) {
+    BootstrapOptions opt;
+    BootstrapResultat res;
+    const char *noms[2] = { "a0", "a1" };
+    int code;
+    
+    bootstrap_options_defaut(&opt);
+    printf("\n=== BOOTSTRAP (%d repliques sur %d threads, niveau %.0f%%) ===\n", opt.repliques,
+           pool_threads(pool_defaut()), 100.0 * opt.niveau);
+    code = bootstrap_droite(pts, &opt, &res);
+    if (code != 0) {
+        printf("Erreur: %s\n", code == -2 ? "memoire insuffisante" : "x constants ou trop peu de points");
+        return;
     }
+    printf("Droite des moindres carres sur les donnees reechantillonnees:\n");
+    bootstrap_afficher(&res, noms);
 }
 
-void error(char *message) {
+/* ===== Fonctions utilitaires ===== */
+void error(const char *message) {
     printf("\n=== ERREUR ===\n");
     printf("%s\n", message);
     printf("==============\n");
@@ -0,0 +1,216 @@
+/*
+ * moments.c
+ * Accumulateur de moments pour la regression lineaire (voir moments.h).
+ */
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include "moments.h"
+
+/* Taille d'un bloc : tient en cache entre les deux passes */
+#define MOMENTS_BLOC 4096
+
+void moments_init(Moments *m) {
+    memset(m, 0, sizeof(*m));
+}
+
+void moments_ajouter(Moments *m, double x, double y) {
+    double dx, dy;
+
+    m->n += 1.0;
+    dx = x - m->mx;
+    dy = y - m->my;
+    m->mx += dx / m->n;
+    m->my += dy / m->n;
+    m->sxx += dx * (x - m->mx);
+    m->syy += dy * (y - m->my);
+    m->sxy += dx * (y - m->my);
+}
+
+void moments_ajouter_pondere(Moments *m, double x, double y, double w) {
+    double dx, dy;
+
+    m->n += w;
+    dx = x - m->mx;
+    dy = y - m->my;
+    m->mx += dx * (w / m->n);
+    m->my += dy * (w / m->n);
+    m->sxx += w * dx * (x - m->mx);
+    m->syy += w * dy * (y - m->my);
+    m->sxy += w * dx * (y - m->my);
+}
+
+void moments_fusion(Moments *m, const Moments *autre) {
+    double n, dx, dy, f;
+
+    if (autre->n == 0.0) return;
+    if (m->n == 0.0) {
+        *m = *autre;
+        return;
+    }
+
+    n = m->n + autre->n;
+    dx = autre->mx - m->mx;
+    dy = autre->my - m->my;
+    f = m->n * autre->n / n;
+
+    m->mx += dx * (autre->n / n);
+    m->my += dy * (autre->n / n);
+    m->sxx += autre->sxx + dx * dx * f;
+    m->syy += autre->syy + dy * dy * f;
+    m->sxy += autre->sxy + dx * dy * f;
+    m->n = n;
+}
+
+void moments_retrait(Moments *m, const Moments *partie) {
+    double n, mx, my, dx, dy, f;
+
+    if (partie->n == 0.0) return;
+    n = m->n - partie->n;
+    if (n <= 0.0) {
+        moments_init(m);
+        return;
+    }
+
+    /* moyennes du reste, puis m = reste ∪ partie resolu pour le reste */
+    mx = m->mx - (partie->mx - m->mx) * (partie->n / n);
+    my = m->my - (partie->my - m->my) * (partie->n / n);
+    dx = partie->mx - mx;
+    dy = partie->my - my;
+    f = n * partie->n / m->n;
+
+    m->sxx = fmax(m->sxx - partie->sxx - dx * dx * f, 0.0);
+    m->syy = fmax(m->syy - partie->syy - dy * dy * f, 0.0);
+    m->sxy -= partie->sxy + dx * dy * f;
+    m->mx = mx;
+    m->my = my;
+    m->n = n;
+}
+
+/* Moments exacts d'un bloc : moyennes puis co-moments centres (boucles vectorisables) */
+static void bloc_double(Moments *b, const double *x, const double *y, size_t n) {
+    double sx = 0.0, sy = 0.0, sxx = 0.0, syy = 0.0, sxy = 0.0;
+    double mx, my;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        sx += x[i];
+        sy += y[i];
+    }
+    mx = sx / (double)n;
+    my = sy / (double)n;
+    for (i = 0; i < n; i++) {
+        double dx = x[i] - mx;
+        double dy = y[i] - my;
+        sxx += dx * dx;
+        syy += dy * dy;
+        sxy += dx * dy;
+    }
+    b->n = (double)n;
+    b->mx = mx;
+    b->my = my;
+    b->sxx = sxx;
+    b->syy = syy;
+    b->sxy = sxy;
+}
+
+static void bloc_float(Moments *b, const float *x, const float *y, size_t n) {
+    double sx = 0.0, sy = 0.0, sxx = 0.0, syy = 0.0, sxy = 0.0;
+    double mx, my;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        sx += x[i];
+        sy += y[i];
+    }
+    mx = sx / (double)n;
+    my = sy / (double)n;
+    for (i = 0; i < n; i++) {
+        double dx = x[i] - mx;
+        double dy = y[i] - my;
+        sxx += dx * dx;
+        syy += dy * dy;
+        sxy += dx * dy;
+    }
+    b->n = (double)n;
+    b->mx = mx;
+    b->my = my;
+    b->sxx = sxx;
+    b->syy = syy;
+    b->sxy = sxy;
+}
+
+void moments_ajouter_points(Moments *m, const Points *pts) {
+    size_t debut;
+
+    for (debut = 0; debut < pts->n; debut += MOMENTS_BLOC) {
+        size_t taille = pts->n - debut;
+        Moments b;
+
+        if (taille > MOMENTS_BLOC) taille = MOMENTS_BLOC;
+        if (pts->type == POINTS_FLOAT) bloc_float(&b, pts->xf + debut, pts->yf + debut, taille);
+        else bloc_double(&b, pts->xd + debut, pts->yd + debut, taille);
+        moments_fusion(m, &b);
+    }
+}
+
+int moments_droite(const Moments *m, double *a0, double *a1) {
+    /* Σx² = Sxx + n x̄² : Sxx negligeable devant Σx² => x constants */
+    if (m->n == 0.0 || m->sxx <= DBL_EPSILON * (m->sxx + m->n * m->mx * m->mx)) {
+        *a1 = 0.0;
+        *a0 = m->my;
+        return -1;
+    }
+    *a1 = m->sxy / m->sxx;
+    *a0 = m->my - *a1 * m->mx;
+    return 0;
+}
+
+void moments_gradient(const Moments *m, double a0, double a1, double *g0, double *g1) {
+    double e = a0 + a1 * m->mx - m->my;
+
+    *g0 = e;
+    *g1 = m->mx * e + (a1 * m->sxx - m->sxy) / m->n;
+}
+
+double moments_cout(const Moments *m, double a0, double a1) {
+    double e = a0 + a1 * m->mx - m->my;
+    double dispersion = a1 * a1 * m->sxx - 2.0 * a1 * m->sxy + m->syy;
+
+    return 0.5 * (e * e + dispersion / m->n);
+}
+
+size_t moments_ajouter_log(Moments *m, const Points *pts) {
+    size_t i, utilises = 0;
+
+    for (i = 0; i < pts->n; i++) {
+        double x = pts->type == POINTS_FLOAT ? pts->xf[i] : pts->xd[i];
+        double y = pts->type == POINTS_FLOAT ? pts->yf[i] : pts->yd[i];
+        double w = y * y;
+
+        /* y <= 0 (pas de logarithme) ou poids hors de la plage des double */
+        if (!(y > 0.0) || !(w > 0.0) || !isfinite(w)) continue;
+        moments_ajouter_pondere(m, x, log(y), w);
+        utilises++;
+    }
+    return utilises;
+}
+
+int moments_vers_exponentielle(const Moments *m, size_t utilises, double *a, double *b) {
+    double ln_a, pente;
+
+    if (utilises < 2 || moments_droite(m, &ln_a, &pente) != 0) return -1;
+    *a = exp(ln_a);
+    *b = pente;
+    return 0;
+}
+
+int moments_exponentielle(const Points *pts, double *a, double *b) {
+    Moments m;
+    size_t utilises;
+
+    moments_init(&m);
+    utilises = moments_ajouter_log(&m, pts);
+    return moments_vers_exponentielle(&m, utilises, a, b);
+}
@@ -0,0 +1,73 @@
+/*
+ * moments.h
+ * Statistiques suffisantes de la regression lineaire y = a0 + a1 x,
+ * accumulees en une passe et en double : moyennes et co-moments centres
+ * (methode de Welford). La memoire est O(1) quel que soit le nombre de
+ * points, et deux accumulateurs remplis separement (blocs, fichiers,
+ * threads) se fusionnent exactement (formules de Chan et al.).
+ */
+
+#ifndef MOMENTS_H
+#define MOMENTS_H
+
+#include "points.h"
+
+typedef struct {
+    double n;               /* nombre de points */
+    double mx, my;          /* moyennes de x et de y */
+    double sxx, syy, sxy;   /* Σ(x-x̄)², Σ(y-ȳ)², Σ(x-x̄)(y-ȳ) */
+} Moments;
+
+void moments_init(Moments *m);
+
+/* Ajoute un point */
+void moments_ajouter(Moments *m, double x, double y);
+
+/* Ajoute un point de poids w > 0 (n devient la somme des poids) */
+void moments_ajouter_pondere(Moments *m, double x, double y, double w);
+
+/* Ajoute tous les points du stockage, par blocs traites en deux passes */
+void moments_ajouter_points(Moments *m, const Points *pts);
+
+/* m <- m ∪ autre */
+void moments_fusion(Moments *m, const Moments *autre);
+
+/*
+ * m <- m \ partie, partie etant une partie des points de m : la fusion a
+ * l'envers, en O(1). Sert a la validation croisee (moments des donnees
+ * d'apprentissage = tous les points moins le pli mis de cote).
+ */
+void moments_retrait(Moments *m, const Moments *partie);
+
+/* Droite des moindres carres. Retourne -1 si les x sont (presque) tous egaux. */
+int moments_droite(const Moments *m, double *a0, double *a1);
+
+/*
+ * Cout J(a0,a1) = (1/2n) Σ (a0 + a1 x - y)² et son gradient, en O(1) :
+ * avec e = a0 + a1 x̄ - ȳ (residu moyen),
+ *   ∂J/∂a0 = e
+ *   ∂J/∂a1 = x̄ e + (a1 Sxx - Sxy) / n
+ *   J      = (e² + (a1² Sxx - 2 a1 Sxy + Syy) / n) / 2
+ * Ce sont les memes quantites que la passe sur les donnees, ecrites avec
+ * Σx, Σy, Σx², Σxy, Σy² sous forme centree.
+ */
+void moments_gradient(const Moments *m, double a0, double a1, double *g0, double *g1);
+double moments_cout(const Moments *m, double a0, double a1);
+
+/*
+ * Point de depart pour y = a e^{b x} : droite des moindres carres de ln y
+ * en fonction de x, ponderee par y² (ln y a une erreur ~ δy / y) et
+ * restreinte aux y > 0. Retourne -1, sans toucher a (a, b), s'il reste
+ * moins de deux points ou si leurs x sont egaux.
+ */
+int moments_exponentielle(const Points *pts, double *a, double *b);
+
+/*
+ * Les deux moities de moments_exponentielle, pour des donnees lues par
+ * morceaux : accumulation de (x, ln y) avec le poids y² (retourne le
+ * nombre de points retenus), puis conversion de la droite en (a, b).
+ */
+size_t moments_ajouter_log(Moments *m, const Points *pts);
+int moments_vers_exponentielle(const Moments *m, size_t utilises, double *a, double *b);
+
+#endif
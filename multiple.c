@@ -0,0 +1,395 @@
+/*
+ * multiple.c
+ * Regression lineaire multiple : Gram par tuiles, Cholesky, QR de secours
+ * (voir multiple.h).
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "multiple.h"
+#include "pool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MULTIPLE_X86 1
+#endif
+
+typedef struct {
+    const Tableau *t;
+    const double *c;                /* ligne de reference (k + 1 valeurs) */
+    int q;                          /* k + 2 : 1, x1..xk, y */
+    int qp;                         /* q arrondi au multiple de 8 */
+    size_t parts;
+    double *tuiles;                 /* une tuile MULTIPLE_TUILE x qp par part */
+    double *partielles;             /* Gram (qp x qp) ou R (k + 1 x q) par part */
+    double *rss;                    /* QR : Σ residus² par part */
+} Lot;
+
+static void bornes(const Lot *l, size_t part, size_t *debut, size_t *fin) {
+    *debut = l->t->n * part / l->parts;
+    *fin = l->t->n * (part + 1) / l->parts;
+}
+
+/* Lignes [debut, debut + m) decalees dans z (pas qp), colonnes de bourrage a zero */
+static void charger(const Lot *l, size_t debut, size_t m, double *z) {
+    int k = l->t->k, j;
+    size_t r;
+
+    for (r = 0; r < m; r++) {
+        const double *v = l->t->v + (debut + r) * (size_t)(k + 1);
+        double *zr = z + r * (size_t)l->qp;
+        zr[0] = 1.0;
+        for (j = 0; j <= k; j++) zr[j + 1] = v[j] - l->c[j];
+        for (j = l->q; j < l->qp; j++) zr[j] = 0.0;
+    }
+}
+
+/* ===== Gram ===== */
+
+/*
+ * Triangle inferieur de g (qp x qp) += zᵀ z sur les m lignes de z : pour
+ * chaque bloc de IA lignes et JB colonnes de g qui touche le triangle, les
+ * IA x JB produits sont cumules sur toute la tuile dans des accumulateurs
+ * locaux, puis ajoutes (seulement j <= i) ; qp est multiple de 8.
+ */
+typedef void (*GramNoyau)(double *g, const double *z, size_t m, int qp);
+
+/* Bloc t (ia x jb) ajoute a g en (i0, j0), triangle inferieur seul */
+static void ajouter_bloc(double *g, int qp, int i0, int j0, int ia, int jb, const double *t) {
+    int a, b;
+
+    for (a = 0; a < ia; a++) {
+        double *gi = g + (size_t)(i0 + a) * qp;
+        for (b = 0; b < jb && j0 + b <= i0 + a; b++) gi[j0 + b] += t[a * jb + b];
+    }
+}
+
+/* Version portable : blocs 4 x 4, vectorisee par le compilateur */
+static void gram_generique(double *g, const double *z, size_t m, int qp) {
+    int i0, j0, a, b;
+    size_t r;
+
+    for (i0 = 0; i0 < qp; i0 += 4) {
+        for (j0 = 0; j0 <= i0 + 3; j0 += 4) {
+            double acc[4][4] = {{0.0}};
+            for (r = 0; r < m; r++) {
+                const double *zr = z + r * (size_t)qp;
+                for (a = 0; a < 4; a++) {
+                    double u = zr[i0 + a];
+                    for (b = 0; b < 4; b++) acc[a][b] += u * zr[j0 + b];
+                }
+            }
+            ajouter_bloc(g, qp, i0, j0, 4, 4, &acc[0][0]);
+        }
+    }
+}
+
+#ifdef MULTIPLE_X86
+/* AVX2 + FMA : blocs 4 x 8, huit registres d'accumulation */
+__attribute__((target("avx2,fma")))
+static void gram_avx2(double *g, const double *z, size_t m, int qp) {
+    int i0, j0;
+    size_t r;
+
+    for (i0 = 0; i0 < qp; i0 += 4) {
+        for (j0 = 0; j0 <= i0 + 3; j0 += 8) {
+            __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+            __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+            __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+            __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+            double t[4 * 8];
+            for (r = 0; r < m; r++) {
+                const double *zr = z + r * (size_t)qp;
+                __m256d z0 = _mm256_loadu_pd(zr + j0), z1 = _mm256_loadu_pd(zr + j0 + 4), u;
+                u = _mm256_broadcast_sd(zr + i0);
+                c00 = _mm256_fmadd_pd(u, z0, c00);
+                c01 = _mm256_fmadd_pd(u, z1, c01);
+                u = _mm256_broadcast_sd(zr + i0 + 1);
+                c10 = _mm256_fmadd_pd(u, z0, c10);
+                c11 = _mm256_fmadd_pd(u, z1, c11);
+                u = _mm256_broadcast_sd(zr + i0 + 2);
+                c20 = _mm256_fmadd_pd(u, z0, c20);
+                c21 = _mm256_fmadd_pd(u, z1, c21);
+                u = _mm256_broadcast_sd(zr + i0 + 3);
+                c30 = _mm256_fmadd_pd(u, z0, c30);
+                c31 = _mm256_fmadd_pd(u, z1, c31);
+            }
+            _mm256_storeu_pd(t, c00);
+            _mm256_storeu_pd(t + 4, c01);
+            _mm256_storeu_pd(t + 8, c10);
+            _mm256_storeu_pd(t + 12, c11);
+            _mm256_storeu_pd(t + 16, c20);
+            _mm256_storeu_pd(t + 20, c21);
+            _mm256_storeu_pd(t + 24, c30);
+            _mm256_storeu_pd(t + 28, c31);
+            ajouter_bloc(g, qp, i0, j0, 4, 8, t);
+        }
+    }
+}
+
+/* AVX-512 : blocs 8 x 8, un registre d'accumulation par ligne */
+__attribute__((target("avx512f")))
+static void gram_avx512(double *g, const double *z, size_t m, int qp) {
+    int i0, j0;
+    size_t r;
+
+    for (i0 = 0; i0 < qp; i0 += 8) {
+        for (j0 = 0; j0 <= i0 + 7; j0 += 8) {
+            __m512d c0 = _mm512_setzero_pd(), c1 = _mm512_setzero_pd();
+            __m512d c2 = _mm512_setzero_pd(), c3 = _mm512_setzero_pd();
+            __m512d c4 = _mm512_setzero_pd(), c5 = _mm512_setzero_pd();
+            __m512d c6 = _mm512_setzero_pd(), c7 = _mm512_setzero_pd();
+            double t[8 * 8];
+            for (r = 0; r < m; r++) {
+                const double *zr = z + r * (size_t)qp;
+                __m512d zj = _mm512_loadu_pd(zr + j0);
+                c0 = _mm512_fmadd_pd(_mm512_set1_pd(zr[i0]), zj, c0);
+                c1 = _mm512_fmadd_pd(_mm512_set1_pd(zr[i0 + 1]), zj, c1);
+                c2 = _mm512_fmadd_pd(_mm512_set1_pd(zr[i0 + 2]), zj, c2);
+                c3 = _mm512_fmadd_pd(_mm512_set1_pd(zr[i0 + 3]), zj, c3);
+                c4 = _mm512_fmadd_pd(_mm512_set1_pd(zr[i0 + 4]), zj, c4);
+                c5 = _mm512_fmadd_pd(_mm512_set1_pd(zr[i0 + 5]), zj, c5);
+                c6 = _mm512_fmadd_pd(_mm512_set1_pd(zr[i0 + 6]), zj, c6);
+                c7 = _mm512_fmadd_pd(_mm512_set1_pd(zr[i0 + 7]), zj, c7);
+            }
+            _mm512_storeu_pd(t, c0);
+            _mm512_storeu_pd(t + 8, c1);
+            _mm512_storeu_pd(t + 16, c2);
+            _mm512_storeu_pd(t + 24, c3);
+            _mm512_storeu_pd(t + 32, c4);
+            _mm512_storeu_pd(t + 40, c5);
+            _mm512_storeu_pd(t + 48, c6);
+            _mm512_storeu_pd(t + 56, c7);
+            ajouter_bloc(g, qp, i0, j0, 8, 8, t);
+        }
+    }
+}
+#endif
+
+static const struct {
+    const char *nom;
+    GramNoyau gram;
+} noyaux[] = {
+    { "generique", gram_generique },
+#ifdef MULTIPLE_X86
+    { "avx2",      gram_avx2 },
+    { "avx512",    gram_avx512 },
+#endif
+};
+
+static size_t noyau = 0;
+
+/* Execute au chargement du programme, avant tout thread (comme expvec.c) */
+__attribute__((constructor))
+static void multiple_choisir(void) {
+    const char *force = getenv("MULTIPLE_ISA");
+    size_t i, choix = 0, meilleur;
+
+#ifdef MULTIPLE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) choix = 1;
+    if (__builtin_cpu_supports("avx512f")) choix = 2;
+#endif
+    meilleur = choix;
+    if (force) {
+        for (i = 0; i <= meilleur; i++) {
+            if (strcmp(force, noyaux[i].nom) == 0) choix = i;
+        }
+    }
+    noyau = choix;
+}
+
+const char *multiple_isa(void) {
+    return noyaux[noyau].nom;
+}
+
+static void tache_gram(void *ctx, size_t part) {
+    Lot *l = (Lot *)ctx;
+    size_t qp = (size_t)l->qp, debut, fin, i;
+    double *g = l->partielles + part * qp * qp;
+    double *z = l->tuiles + part * MULTIPLE_TUILE * qp;
+
+    memset(g, 0, qp * qp * sizeof(double));
+    bornes(l, part, &debut, &fin);
+    for (i = debut; i < fin; i += MULTIPLE_TUILE) {
+        size_t m = fin - i < MULTIPLE_TUILE ? fin - i : MULTIPLE_TUILE;
+        charger(l, i, m, z);
+        noyaux[noyau].gram(g, z, m, l->qp);
+    }
+}
+
+/* ===== Cholesky ===== */
+
+/*
+ * L Lᵀ = G (p x p, pas ld) dans lc (p x p). Retourne -1 des qu'un pivot
+ * relatif d / Gjj passe sous MULTIPLE_SEUIL ; *pivot_min recoit le plus
+ * petit pivot relatif rencontre.
+ */
+static int cholesky(const double *g, int ld, int p, double *lc, double *pivot_min) {
+    int i, j, m;
+
+    *pivot_min = 1.0;
+    for (j = 0; j < p; j++) {
+        double gjj = g[(size_t)j * ld + j], d = gjj;
+        for (m = 0; m < j; m++) d -= lc[j * p + m] * lc[j * p + m];
+        if (!(gjj > 0.0)) {
+            *pivot_min = 0.0;
+            return -1;
+        }
+        if (d / gjj < *pivot_min) *pivot_min = d / gjj;
+        if (d <= MULTIPLE_SEUIL * gjj) return -1;
+        lc[j * p + j] = sqrt(d);
+        for (i = j + 1; i < p; i++) {
+            double s = g[(size_t)i * ld + j];
+            for (m = 0; m < j; m++) s -= lc[i * p + m] * lc[j * p + m];
+            lc[i * p + j] = s / lc[j * p + j];
+        }
+    }
+    return 0;
+}
+
+/* ===== QR ===== */
+
+/*
+ * [R ; z] -> [R' ; 0] par reflexions de Householder sur les colonnes
+ * 0..q-2 ; R (q - 1 lignes, pas q) porte Qᵀy dans sa derniere colonne, et
+ * ce qui reste de y dans z (hors de l'espace des colonnes) s'ajoute a *rss.
+ */
+static void qr_ajouter(double *r, int q, double *z, size_t m, int ldz, double *rss) {
+    int p = q - 1, j, c;
+    size_t i;
+
+    for (j = 0; j < p; j++) {
+        double alpha = r[j * q + j], sigma = 0.0, norme, beta, v0, tau;
+
+        for (i = 0; i < m; i++) sigma += z[i * ldz + j] * z[i * ldz + j];
+        if (sigma == 0.0) continue;
+        norme = sqrt(alpha * alpha + sigma);
+        beta = alpha > 0.0 ? -norme : norme;
+        v0 = alpha - beta;
+        tau = (beta - alpha) / beta;
+        for (i = 0; i < m; i++) z[i * ldz + j] /= v0;     /* v = (1, z./v0) */
+        for (c = j + 1; c < q; c++) {
+            double w = r[j * q + c];
+            for (i = 0; i < m; i++) w += z[i * ldz + c] * z[i * ldz + j];
+            w *= tau;
+            r[j * q + c] -= w;
+            for (i = 0; i < m; i++) z[i * ldz + c] -= w * z[i * ldz + j];
+        }
+        r[j * q + j] = beta;
+    }
+    for (i = 0; i < m; i++) *rss += z[i * ldz + p] * z[i * ldz + p];
+}
+
+static void tache_qr(void *ctx, size_t part) {
+    Lot *l = (Lot *)ctx;
+    size_t qp = (size_t)l->qp, q = (size_t)l->q, debut, fin, i;
+    double *r = l->partielles + part * (q - 1) * q;
+    double *z = l->tuiles + part * MULTIPLE_TUILE * qp;
+
+    memset(r, 0, (q - 1) * q * sizeof(double));
+    l->rss[part] = 0.0;
+    bornes(l, part, &debut, &fin);
+    for (i = debut; i < fin; i += MULTIPLE_TUILE) {
+        size_t m = fin - i < MULTIPLE_TUILE ? fin - i : MULTIPLE_TUILE;
+        charger(l, i, m, z);
+        qr_ajouter(r, l->q, z, m, l->qp, &l->rss[part]);
+    }
+}
+
+/* ===== Ajustement ===== */
+
+int multiple_ajuster(const Tableau *t, int forcer_qr, double *beta, MultipleInfo *info) {
+    MultipleInfo local;
+    Lot l;
+    int p = t->k + 1, q = t->k + 2, qp = (q + 7) / 8 * 8, i, j, code = 0;
+    size_t part, bloc = (size_t)qp * qp > (size_t)(q - 1) * q ? (size_t)qp * qp : (size_t)(q - 1) * q;
+    double *g, *lc, *w, sy, tss;
+
+    if (!info) info = &local;
+    memset(info, 0, sizeof(*info));
+    if (t->n < (size_t)p) return -1;
+
+    memset(&l, 0, sizeof(l));
+    l.t = t;
+    l.c = t->v;
+    l.q = q;
+    l.qp = qp;
+    l.parts = (t->n + POOL_BLOC - 1) / POOL_BLOC;
+    if (l.parts > MULTIPLE_PARTS) l.parts = MULTIPLE_PARTS;
+
+    l.tuiles = (double *)malloc(l.parts * MULTIPLE_TUILE * (size_t)qp * sizeof(double));
+    l.partielles = (double *)malloc(l.parts * bloc * sizeof(double));
+    l.rss = (double *)malloc(l.parts * sizeof(double));
+    g = (double *)calloc((size_t)qp * qp, sizeof(double));
+    lc = (double *)calloc((size_t)q * q, sizeof(double));
+    w = (double *)malloc((size_t)q * sizeof(double));
+    if (!l.tuiles || !l.partielles || !l.rss || !g || !lc || !w) {
+        code = -2;
+        goto fin;
+    }
+
+    /* Gram : sommes partielles par part, additionnees dans l'ordre */
+    pool_executer(pool_defaut(), l.parts, tache_gram, &l);
+    for (part = 0; part < l.parts; part++) {
+        const double *gp = l.partielles + part * (size_t)qp * qp;
+        for (i = 0; i < q; i++)
+            for (j = 0; j <= i; j++) g[(size_t)i * qp + j] += gp[(size_t)i * qp + j];
+    }
+    sy = g[(size_t)(q - 1) * qp];                   /* Σ (y - cy) */
+    tss = g[(size_t)(q - 1) * qp + q - 1] - sy * sy / g[0];
+
+    if (!forcer_qr && cholesky(g, qp, p, lc, &info->pivot_min) == 0) {
+        /* L w = Xᵀy, Lᵀ beta = w ; rss = yᵀy - wᵀw */
+        info->methode = MULTIPLE_CHOLESKY;
+        info->rss = g[(size_t)(q - 1) * qp + q - 1];
+        for (i = 0; i < p; i++) {
+            double s = g[(size_t)(q - 1) * qp + i];
+            for (j = 0; j < i; j++) s -= lc[i * p + j] * w[j];
+            w[i] = s / lc[i * p + i];
+            info->rss -= w[i] * w[i];
+        }
+        if (info->rss < 0.0) info->rss = 0.0;
+        for (i = p - 1; i >= 0; i--) {
+            double s = w[i];
+            for (j = i + 1; j < p; j++) s -= lc[j * p + i] * beta[j];
+            beta[i] = s / lc[i * p + i];
+        }
+    } else {
+        /* QR par parts, puis les R des parts empilees dans le R global */
+        double *r = lc;
+        info->methode = MULTIPLE_QR;
+        pool_executer(pool_defaut(), l.parts, tache_qr, &l);
+        memset(r, 0, (size_t)p * q * sizeof(double));
+        for (part = 0; part < l.parts; part++) {
+            info->rss += l.rss[part];
+            qr_ajouter(r, q, l.partielles + part * (size_t)p * q, (size_t)p, q, &info->rss);
+        }
+        for (i = 0; i < p; i++) {
+            if (!(fabs(r[i * q + i]) > MULTIPLE_RANG * sqrt(g[(size_t)i * qp + i]))) {
+                code = -1;
+                goto fin;
+            }
+        }
+        for (i = p - 1; i >= 0; i--) {
+            double s = r[i * q + p];
+            for (j = i + 1; j < p; j++) s -= r[i * q + j] * beta[j];
+            beta[i] = s / r[i * q + i];
+        }
+    }
+
+    /* retour aux variables d'origine : seule la constante change */
+    beta[0] += l.c[t->k];
+    for (j = 1; j < p; j++) beta[0] -= beta[j] * l.c[j - 1];
+    info->r2 = tss > 0.0 ? 1.0 - info->rss / tss : 1.0;
+
+fin:
+    free(l.tuiles);
+    free(l.partielles);
+    free(l.rss);
+    free(g);
+    free(lc);
+    free(w);
+    return code;
+}
@@ -0,0 +1,57 @@
+/*
+ * multiple.h
+ * Regression lineaire multiple y = b0 + b1 x1 + ... + bk xk par moindres
+ * carres, sur un Tableau (points.h) : generalisation de leastSquares.
+ *
+ * Une passe sur les donnees accumule la matrice de Gram du vecteur
+ * z = (1, x1 - c1, ..., xk - ck, y - cy), ou c est la premiere ligne : le
+ * decalage evite les grandes sommes qui s'annulent (comme les moments
+ * centres de moments.h). Ses blocs donnent XᵀX, Xᵀy et yᵀy.
+ * L'accumulation est une mise a jour symetrique de rang MULTIPLE_TUILE par
+ * tuile de lignes : la tuile est recopiee dans un tampon, et chaque bloc
+ * du triangle inferieur est cumule dans des accumulateurs locaux sur toute
+ * la tuile (registres vectoriels) avant d'etre ajoute a la matrice.
+ * Les lignes sont decoupees en au plus MULTIPLE_PARTS parts fixes
+ * reparties sur le pool (pool.h) puis additionnees dans l'ordre : le
+ * resultat ne depend pas du nombre de threads. Noyaux AVX-512 (blocs 8 x 8),
+ * AVX2+FMA (4 x 8) et portable (4 x 4) choisis a l'execution selon le
+ * processeur ; MULTIPLE_ISA=generique|avx2|avx512 force un noyau.
+ *
+ * Resolution par Cholesky de XᵀX. Si un pivot relatif descend sous
+ * MULTIPLE_SEUIL (colonne presque combinaison des precedentes : les
+ * equations normales perdent deux fois plus de chiffres que le probleme),
+ * une seconde passe factorise X par reflexions de Householder, tuile par
+ * tuile, et travaille sur le conditionnement de X au lieu de son carre.
+ */
+
+#ifndef MULTIPLE_H
+#define MULTIPLE_H
+
+#include "points.h"
+
+#define MULTIPLE_TUILE 64           /* lignes par tuile */
+#define MULTIPLE_PARTS 32
+#define MULTIPLE_SEUIL 1e-8         /* pivot relatif minimal de Cholesky */
+#define MULTIPLE_RANG 1e-10         /* |Rjj| relatif minimal de QR */
+
+typedef enum { MULTIPLE_CHOLESKY, MULTIPLE_QR } MultipleMethode;
+
+typedef struct {
+    MultipleMethode methode;        /* factorisation qui a donne beta */
+    double pivot_min;               /* plus petit pivot relatif de Cholesky (1 - R² de la colonne sur les precedentes) */
+    double rss;                     /* Σ residus² */
+    double r2;                      /* coefficient de determination */
+} MultipleInfo;
+
+/*
+ * Ajuste les k + 1 coefficients beta (constante puis pentes). forcer_qr :
+ * QR sans essayer Cholesky. info peut etre NULL.
+ * Retourne 0 ; -1 si n < k + 1 ou si des colonnes sont colineaires (meme
+ * par QR) ; -2 en cas d'allocation impossible.
+ */
+int multiple_ajuster(const Tableau *t, int forcer_qr, double *beta, MultipleInfo *info);
+
+/* Noyau de Gram utilise : "generique", "avx2" ou "avx512" */
+const char *multiple_isa(void);
+
+#endif
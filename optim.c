@@ -0,0 +1,70 @@
+/*
+ * optim.c
+ * Methodes de pas du premier ordre (voir optim.h).
+ */
+
+#include <math.h>
+#include <string.h>
+#include "optim.h"
+
+static const char *noms[OPTIM_NOMBRE] = { "fixe", "armijo", "momentum", "nesterov", "adam" };
+
+void optim_options_defaut(OptimOptions *o, OptimMethode m, double pas, double eps, int max_iterations) {
+    o->methode = m;
+    o->pas = pas;
+    o->eps = eps;
+    o->norme_max = 0;
+    o->max_iterations = max_iterations;
+    o->mu = 0.9;
+    o->beta1 = 0.9;
+    o->beta2 = 0.999;
+    o->armijo_c = 1e-4;
+    o->hausse_max = 1.0;
+    o->max_reculs = 30;
+    o->suivi = NULL;
+    o->trace = NULL;
+}
+
+/* Evaluateur connu a l'execution seulement : l'instance double passe par le pointeur */
+typedef struct {
+    OptimEvaluer evaluer;
+    void *ctx;
+} Appel;
+
+static inline int appeler(void *ctx, const double p[2], double *cout, double g[2]) {
+    const Appel *a = (const Appel *)ctx;
+    return a->evaluer(a->ctx, p, cout, g);
+}
+
+OPTIM_DEFINIR(minimiser, double, appeler)
+
+OptimResultat optim_minimiser(OptimEvaluer evaluer, void *ctx, const double p0[2], const OptimOptions *o) {
+    Appel a = { evaluer, ctx };
+    return minimiser(&a, p0, o);
+}
+
+const char *optim_nom(OptimMethode m) {
+    return noms[m];
+}
+
+int optim_depuis_nom(const char *nom, OptimMethode *m) {
+    int k;
+
+    for (k = 0; k < OPTIM_NOMBRE; k++) {
+        if (strcmp(nom, noms[k]) == 0) {
+            *m = (OptimMethode)k;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *optim_raison(OptimRaison r) {
+    switch (r) {
+        case OPTIM_CONVERGE:        return "deplacement sous le seuil (convergence)";
+        case OPTIM_MAX_ITERATIONS:  return "maximum d'iterations atteint";
+        case OPTIM_DIVERGENCE:      return "divergence malgre la reduction du pas";
+        case OPTIM_ECHEC:           return "evaluation impossible (erreur de lecture)";
+    }
+    return "inconnue";
+}
@@ -0,0 +1,275 @@
+/*
+ * optim.h
+ * Minimisation du premier ordre a deux parametres, commune aux descentes
+ * du gradient de la serie (droite de gauchy.c, exponentielles). Le
+ * probleme est decrit par un evaluateur qui donne le cout et le gradient
+ * en un point ; la methode de pas est au choix :
+ *   fixe       p -= η ∇J (comportement historique des programmes)
+ *   armijo     recherche lineaire par rebroussement : η divise par 2 jusqu'a
+ *              J(p - η∇J) <= J(p) - c η |∇J|², puis double au pas suivant
+ *   momentum   boule pesante : v = μ v - η ∇J(p), p += v
+ *   nesterov   gradient pris au point anticipe p + μ v
+ *   adam       moments du premier et du second ordre corriges du biais
+ *
+ * Divergence : si le cout devient non fini ou depasse le meilleur cout
+ * rencontre de plus de hausse_max (en relatif), les parametres reviennent
+ * au meilleur point, η est divise par 2 et la vitesse (ou les moments
+ * d'Adam) est remise a zero. Par defaut (hausse_max = 1), toutes les
+ * methodes tolerent que le cout remonte jusqu'au double du meilleur : les
+ * methodes a inertie le font temporairement, et le pas fixe garde ainsi la
+ * trajectoire des programmes d'origine tant qu'il ne diverge pas vraiment.
+ * hausse_max = 0 impose une baisse a chaque iteration.
+ * L'arret a lieu quand la norme du deplacement, ramenee au pas d'avant
+ * les reculs (multipliee par 2^reculs), passe sous eps.
+ *
+ * La boucle est ecrite une fois, dans OPTIM_DEFINIR, pour un type de
+ * parametres et un evaluateur connus a la compilation ; optim_minimiser
+ * en est l'instance double qui appelle un evaluateur quelconque.
+ */
+
+#ifndef OPTIM_H
+#define OPTIM_H
+
+#include <math.h>
+#include <string.h>
+#include "trace.h"
+
+typedef enum { OPTIM_FIXE, OPTIM_ARMIJO, OPTIM_MOMENTUM, OPTIM_NESTEROV, OPTIM_ADAM } OptimMethode;
+
+#define OPTIM_NOMBRE 5
+
+typedef enum {
+    OPTIM_CONVERGE,         /* deplacement sous eps */
+    OPTIM_MAX_ITERATIONS,
+    OPTIM_DIVERGENCE,       /* trop de reculs sur divergence */
+    OPTIM_ECHEC             /* l'evaluateur a signale une erreur */
+} OptimRaison;
+
+/*
+ * Remplit le cout J et le gradient g de J en p ; retourne 0, ou une
+ * valeur non nulle pour abandonner (erreur de lecture...).
+ */
+typedef int (*OptimEvaluer)(void *ctx, const double p[2], double *cout, double g[2]);
+
+/* Appele apres chaque iteration non finale avec le point courant et son cout (affichage) */
+typedef void (*OptimSuivi)(int iteration, const double p[2], double cout);
+
+typedef struct {
+    OptimMethode methode;
+    double pas;             /* η (pas initial pour armijo) */
+    double eps;             /* arret sur la norme du deplacement */
+    int norme_max;          /* 1 : max des composantes, 0 : norme euclidienne */
+    int max_iterations;
+    double mu;              /* inertie de momentum et nesterov */
+    double beta1, beta2;    /* adam */
+    double armijo_c;
+    double hausse_max;      /* hausse relative du cout toleree avant recul */
+    int max_reculs;         /* divergences tolerees avant abandon */
+    OptimSuivi suivi;       /* NULL : aucun */
+    Trace *trace;           /* depart, iterations acceptees et arret ; NULL : aucune */
+} OptimOptions;
+
+typedef struct {
+    double p[2];
+    double cout;            /* au point retourne */
+    int iterations;
+    int evaluations;        /* appels de l'evaluateur (passes sur les donnees) */
+    int reculs;             /* divergences detectees */
+    double pas;             /* η en fin d'optimisation */
+    OptimRaison raison;
+    double precedent[2];    /* point avant le dernier pas accepte, et son cout */
+    double cout_precedent;
+} OptimResultat;
+
+/* Options par defaut de la methode, avec le pas, le seuil et le budget du programme */
+void optim_options_defaut(OptimOptions *o, OptimMethode m, double pas, double eps, int max_iterations);
+
+OptimResultat optim_minimiser(OptimEvaluer evaluer, void *ctx, const double p0[2], const OptimOptions *o);
+
+const char *optim_nom(OptimMethode m);
+
+/* Retourne 0 et remplit *m si nom designe une methode, -1 sinon */
+int optim_depuis_nom(const char *nom, OptimMethode *m);
+
+const char *optim_raison(OptimRaison r);
+
+/* ===== Boucle engendree ===== */
+
+#define OPTIM_ARMIJO_DIVISIONS 60
+#define OPTIM_ADAM_EPSILON 1e-8
+
+static inline double optim_norme(double d0, double d1, int norme_max) {
+    if (norme_max) return fmax(fabs(d0), fabs(d1));
+    return sqrt(d0 * d0 + d1 * d1);
+}
+
+/* Point courant dans la trace, avec la norme du gradient ; rien si t est NULL */
+static inline void optim_tracer(Trace *t, long iteration, double p0, double p1, double cout,
+                                double g0, double g1, double pas, int final) {
+    double p[2] = { p0, p1 };
+
+    if (!t) return;
+    if (final) trace_terminer(t, iteration, p, cout, optim_norme(g0, g1, 0), pas);
+    else trace_enregistrer(t, iteration, p, cout, optim_norme(g0, g1, 0), pas);
+}
+
+/*
+ * OPTIM_DEFINIR(nom, T, EVALUER) engendre
+ *   static inline OptimResultat nom(void *ctx, const double p0[2], const OptimOptions *o)
+ * pour l'evaluateur int EVALUER(void *ctx, const T p[2], double *cout, T g[2]),
+ * appele directement dans la boucle. Parametres, gradient, pas et vitesse
+ * sont dans le type T (float ou double) : en float, le pas fixe refait
+ * exactement les operations d'une descente ecrite en float. Le cout et
+ * les tests d'arret sont en double ; le deplacement teste est celui des
+ * parametres arrondis dans T.
+ */
+#define OPTIM_DEFINIR(nom, T, EVALUER)                                          \
+static inline OptimResultat nom(void *ctx, const double p0[2], const OptimOptions *o) { \
+    OptimResultat r;                                                            \
+    T p[2], g[2] = { 0, 0 };                                                    \
+    T v[2] = { 0, 0 };                  /* vitesse, ou premier moment d'adam */ \
+    T s[2] = { 0, 0 };                  /* second moment d'adam */              \
+    T pm[2], gm[2];                     /* meilleur point rencontre */          \
+    double j = 0.0, jm;                                                         \
+    double b1t = 1.0, b2t = 1.0;        /* beta1^t, beta2^t */                  \
+    double eta = o->pas;                                                        \
+    int k;                                                                      \
+                                                                                \
+    memset(&r, 0, sizeof(r));                                                   \
+    p[0] = (T)p0[0];                                                            \
+    p[1] = (T)p0[1];                                                            \
+    r.raison = OPTIM_MAX_ITERATIONS;                                            \
+    r.evaluations = 1;                                                          \
+    if (EVALUER(ctx, p, &j, g) != 0) r.raison = OPTIM_ECHEC;                    \
+    else if (!isfinite(j)) r.raison = OPTIM_DIVERGENCE;                         \
+    memcpy(pm, p, sizeof(p));                                                   \
+    memcpy(gm, g, sizeof(g));                                                   \
+    jm = j;                                                                     \
+    r.precedent[0] = p[0];                                                      \
+    r.precedent[1] = p[1];                                                      \
+    r.cout_precedent = j;                                                       \
+    optim_tracer(o->trace, 0, p[0], p[1], j, g[0], g[1], eta, 0);               \
+                                                                                \
+    while (r.raison == OPTIM_MAX_ITERATIONS && r.iterations < o->max_iterations) { \
+        T d[2] = { 0, 0 }, q[2], gq[2], pas = (T)eta;                           \
+        double jq;                                                              \
+                                                                                \
+        switch (o->methode) {                                                   \
+            case OPTIM_FIXE:                                                    \
+            case OPTIM_ARMIJO:                                                  \
+                d[0] = -pas * g[0];                                             \
+                d[1] = -pas * g[1];                                             \
+                break;                                                          \
+            case OPTIM_MOMENTUM:                                                \
+                v[0] = (T)o->mu * v[0] - pas * g[0];                            \
+                v[1] = (T)o->mu * v[1] - pas * g[1];                            \
+                d[0] = v[0];                                                    \
+                d[1] = v[1];                                                    \
+                break;                                                          \
+            case OPTIM_NESTEROV:                                                \
+                /* forme de Sutskever : p est le point anticipe, un seul gradient par pas */ \
+                v[0] = (T)o->mu * v[0] - pas * g[0];                            \
+                v[1] = (T)o->mu * v[1] - pas * g[1];                            \
+                d[0] = (T)o->mu * v[0] - pas * g[0];                            \
+                d[1] = (T)o->mu * v[1] - pas * g[1];                            \
+                break;                                                          \
+            case OPTIM_ADAM:                                                    \
+                b1t *= o->beta1;                                                \
+                b2t *= o->beta2;                                                \
+                for (k = 0; k < 2; k++) {                                       \
+                    v[k] = (T)(o->beta1 * v[k] + (1.0 - o->beta1) * g[k]);      \
+                    s[k] = (T)(o->beta2 * s[k] + (1.0 - o->beta2) * g[k] * g[k]); \
+                    d[k] = (T)(-eta * (v[k] / (1.0 - b1t)) /                    \
+                               (sqrt(s[k] / (1.0 - b2t)) + OPTIM_ADAM_EPSILON)); \
+                }                                                               \
+                break;                                                          \
+        }                                                                       \
+                                                                                \
+        q[0] = p[0] + d[0];                                                     \
+        q[1] = p[1] + d[1];                                                     \
+        r.evaluations++;                                                        \
+        if (EVALUER(ctx, q, &jq, gq) != 0) {                                    \
+            r.raison = OPTIM_ECHEC;                                             \
+            break;                                                              \
+        }                                                                       \
+                                                                                \
+        if (o->methode == OPTIM_ARMIJO) {                                       \
+            /* rebroussement jusqu'a la condition de decroissance suffisante */ \
+            double g2 = (double)g[0] * g[0] + (double)g[1] * g[1];              \
+            int divisions = 0, erreur = 0;                                      \
+                                                                                \
+            while (!(jq <= j - o->armijo_c * eta * g2) && divisions < OPTIM_ARMIJO_DIVISIONS) { \
+                eta *= 0.5;                                                     \
+                pas = (T)eta;                                                   \
+                divisions++;                                                    \
+                q[0] = p[0] - pas * g[0];                                       \
+                q[1] = p[1] - pas * g[1];                                       \
+                r.evaluations++;                                                \
+                if (EVALUER(ctx, q, &jq, gq) != 0) {                            \
+                    erreur = 1;                                                 \
+                    break;                                                      \
+                }                                                               \
+            }                                                                   \
+            if (erreur) {                                                       \
+                r.raison = OPTIM_ECHEC;                                         \
+                break;                                                          \
+            }                                                                   \
+            if (divisions == OPTIM_ARMIJO_DIVISIONS) {                          \
+                /* plus aucune descente representable : point stationnaire */  \
+                r.raison = OPTIM_CONVERGE;                                      \
+                break;                                                          \
+            }                                                                   \
+        } else if (!(jq <= (1.0 + o->hausse_max) * jm + 1e-300)) {             \
+            /* divergence : retour au meilleur point avec un pas deux fois plus petit */ \
+            r.reculs++;                                                         \
+            r.iterations++;                                                     \
+            if (r.reculs > o->max_reculs) {                                     \
+                r.raison = OPTIM_DIVERGENCE;                                    \
+                break;                                                          \
+            }                                                                   \
+            eta *= 0.5;                                                         \
+            memcpy(p, pm, sizeof(p));                                           \
+            memcpy(g, gm, sizeof(g));                                           \
+            j = jm;                                                             \
+            v[0] = v[1] = s[0] = s[1] = 0;                                      \
+            b1t = b2t = 1.0;                                                    \
+            continue;                                                           \
+        }                                                                       \
+                                                                                \
+        /* deplacement effectif, apres arrondi des parametres dans T */        \
+        d[0] = q[0] - p[0];                                                     \
+        d[1] = q[1] - p[1];                                                     \
+        r.precedent[0] = p[0];                                                  \
+        r.precedent[1] = p[1];                                                  \
+        r.cout_precedent = j;                                                   \
+        memcpy(p, q, sizeof(p));                                                \
+        memcpy(g, gq, sizeof(g));                                               \
+        j = jq;                                                                 \
+        if (j < jm) {                                                           \
+            memcpy(pm, p, sizeof(p));                                           \
+            memcpy(gm, g, sizeof(g));                                           \
+            jm = j;                                                             \
+        }                                                                       \
+        r.iterations++;                                                         \
+        optim_tracer(o->trace, r.iterations, p[0], p[1], j, g[0], g[1], eta, 0); \
+        /* deplacement ramene au pas d'avant les reculs : un recul ne provoque pas d'arret premature */ \
+        if (ldexp(optim_norme(d[0], d[1], o->norme_max), r.reculs) < o->eps) {  \
+            r.raison = OPTIM_CONVERGE;                                          \
+            break;                                                              \
+        }                                                                       \
+        if (o->suivi) {                                                         \
+            double pd[2] = { p[0], p[1] };                                      \
+            o->suivi(r.iterations - 1, pd, j);                                  \
+        }                                                                       \
+        if (o->methode == OPTIM_ARMIJO) eta *= 2.0;                             \
+    }                                                                           \
+                                                                                \
+    optim_tracer(o->trace, r.iterations, p[0], p[1], j, g[0], g[1], eta, 1);    \
+    r.p[0] = p[0];                                                              \
+    r.p[1] = p[1];                                                              \
+    r.cout = j;                                                                 \
+    r.pas = eta;                                                                \
+    return r;                                                                   \
+}
+
+#endif
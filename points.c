@@ -0,0 +1,65 @@
+/*
+ * points.c
+ * Allocation du stockage contigu des points (voir points.h).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "points.h"
+
+/* Taille d'une colonne arrondie au multiple de l'alignement */
+static size_t column_bytes(size_t n, size_t elt) {
+    size_t bytes = n * elt;
+    return (bytes + POINTS_ALIGN - 1) / POINTS_ALIGN * POINTS_ALIGN;
+}
+
+int points_alloc(Points *p, size_t n, PointsType type) {
+    size_t elt = (type == POINTS_FLOAT) ? sizeof(float) : sizeof(double);
+    size_t stride = column_bytes(n, elt);
+    char *bloc;
+
+    memset(p, 0, sizeof(*p));
+    if (n == 0 || n > ((size_t)-1) / 2 / elt) return -1;
+
+    /* x et y dans le meme bloc, y commence a la frontiere alignee suivante */
+    bloc = (char *)aligned_alloc(POINTS_ALIGN, 2 * stride);
+    if (!bloc) return -1;
+
+    p->n = n;
+    p->type = type;
+    if (type == POINTS_FLOAT) {
+        p->xf = (float *)bloc;
+        p->yf = (float *)(bloc + stride);
+    } else {
+        p->xd = (double *)bloc;
+        p->yd = (double *)(bloc + stride);
+    }
+    return 0;
+}
+
+void points_free(Points *p) {
+    if (p->projection) munmap(p->projection, p->projection_octets);
+    else if (p->type == POINTS_FLOAT) free(p->xf);
+    else free(p->xd);
+    memset(p, 0, sizeof(*p));
+}
+
+int tableau_alloc(Tableau *t, size_t n, int k) {
+    size_t largeur = (size_t)k + 1;
+
+    memset(t, 0, sizeof(*t));
+    if (n == 0 || k < 1 || n > ((size_t)-1) / sizeof(double) / largeur) return -1;
+    t->v = (double *)aligned_alloc(POINTS_ALIGN, column_bytes(n * largeur, sizeof(double)));
+    if (!t->v) return -1;
+    t->n = n;
+    t->k = k;
+    return 0;
+}
+
+void tableau_free(Tableau *t) {
+    free(t->v);
+    memset(t, 0, sizeof(*t));
+}
@@ -0,0 +1,47 @@
+/*
+ * points.h
+ * Stockage contigu des points (x, y) en structure de tableaux.
+ * Les colonnes x[] et y[] sont alignees sur POINTS_ALIGN octets et tiennent
+ * dans une seule allocation : les boucles de calcul parcourent la memoire
+ * a pas unitaire et peuvent etre vectorisees par le compilateur.
+ */
+
+#ifndef POINTS_H
+#define POINTS_H
+
+#include <stddef.h>
+
+#define POINTS_ALIGN 64
+
+typedef enum { POINTS_FLOAT, POINTS_DOUBLE } PointsType;
+
+typedef struct {
+    size_t n;                           /* nombre de points */
+    PointsType type;                    /* precision des colonnes */
+    union { float *xf; double *xd; };   /* colonne x */
+    union { float *yf; double *yd; };   /* colonne y */
+    void *projection;                   /* fichier projete contenant les colonnes, ou NULL */
+    size_t projection_octets;
+} Points;
+
+/* Alloue les deux colonnes pour n points. Retourne 0, ou -1 en cas d'echec. */
+int points_alloc(Points *p, size_t n, PointsType type);
+
+/* Libere le bloc (ou la projection) et remet la structure a zero. */
+void points_free(Points *p);
+
+/*
+ * Donnees a plusieurs variables explicatives : n lignes (x1, ..., xk, y)
+ * rangees a la suite, en double. La ligne i commence a v[i * (k + 1)].
+ */
+typedef struct {
+    size_t n;               /* nombre de lignes */
+    int k;                  /* nombre de variables explicatives */
+    double *v;
+} Tableau;
+
+/* Alloue n lignes de k + 1 valeurs. Retourne 0, ou -1 en cas d'echec. */
+int tableau_alloc(Tableau *t, size_t n, int k);
+void tableau_free(Tableau *t);
+
+#endif
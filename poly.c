@@ -0,0 +1,144 @@
+/*
+ * poly.c
+ * Regression polynomiale y = a0 + a1 x + ... + ad x^d (polynome.h) : une
+ * passe sur les donnees accumule 3d + 3 moments, le systeme (d+1) x (d+1)
+ * est resolu dans la base de Chebyshev ; aucune matrice n x (d+1).
+ *
+ * Usage : ./poly [degre] [fichier] [trace]
+ *   degre   : 0 a POLYNOME_DEGRE_MAX, defaut 3
+ *   fichier : defaut donnees.txt
+ *   trace   : nuage et courbe par le gnuplot persistant (graphe.h), en
+ *             fenetre si DISPLAY est defini, sinon regression_poly.png
+ *
+ * Compilation : gcc -O2 poly.c polynome.c points.c lecture.c graphe.c reduction.c -o poly -lm -pthread
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "points.h"
+#include "lecture.h"
+#include "polynome.h"
+#include "graphe.h"
+#include "reduction.h"
+
+#define POLY_COURBE 200             /* echantillons de la courbe tracee */
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Nuage reduit a la largeur de l'image et courbe sur l'etendue des x */
+static int tracer(const Points *pts, const Polynome *p) {
+    double *xs, *ys;
+    float *xf, *yf, courbe_x[POLY_COURBE], courbe_y[POLY_COURBE];
+    char titre[GRAPHE_TEXTE];
+    size_t m, i;
+    Graphe *g;
+    int code = -1;
+
+    xs = (double *)malloc(4 * REDUCTION_COLONNES * sizeof(double));
+    xf = (float *)malloc(4 * REDUCTION_COLONNES * sizeof(float));
+    if (!xs || !xf) {
+        free(xs);
+        free(xf);
+        return -1;
+    }
+    ys = xs + 2 * REDUCTION_COLONNES;
+    yf = xf + 2 * REDUCTION_COLONNES;
+
+    m = reduction_minmax(pts->xd, pts->yd, pts->n, REDUCTION_COLONNES, xs, ys);
+    for (i = 0; i < m; i++) {
+        xf[i] = (float)xs[i];
+        yf[i] = (float)ys[i];
+    }
+    for (i = 0; i < POLY_COURBE; i++) {
+        double x = p->centre + p->demi_etendue * (2.0 * i / (POLY_COURBE - 1) - 1.0);
+        courbe_x[i] = (float)x;
+        courbe_y[i] = (float)polynome_valeur(p, x);
+    }
+
+    GrapheSerie series[2] = {
+        { xf, yf, m, "points pt 7 ps 1.5 lc rgb 'blue'", "Donnees" },
+        { courbe_x, courbe_y, POLY_COURBE, "lines lw 2 lc rgb 'red'", "Polynome" },
+    };
+    snprintf(titre, sizeof(titre), "Regression polynomiale de degre %d", p->degre);
+
+    g = graphe_ouvrir(getenv("DISPLAY") ? NULL : "regression_poly.png");
+    if (g) {
+        code = graphe_tracer(g, titre, series, 2);
+        graphe_fermer(g);
+    }
+    free(xs);
+    free(xf);
+    return code;
+}
+
+int main(int argc, char **argv) {
+    const char *fichier = "donnees.txt";
+    int degre = 3, trace = 0, j;
+    Points pts;
+    Polynome p;
+    LectureInfo info;
+    LectureCode lecture;
+    double a[POLYNOME_DEGRE_MAX + 1], rss, tss, debut, duree;
+
+    for (j = 1; j < argc; j++) {
+        if (strcmp(argv[j], "trace") == 0) trace = 1;
+        else if (isdigit((unsigned char)argv[j][0])) {
+            degre = atoi(argv[j]);
+            if (degre > POLYNOME_DEGRE_MAX) {
+                fprintf(stderr, "Degre maximal : %d\n", POLYNOME_DEGRE_MAX);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (argv[j][0] != '-') fichier = argv[j];
+        else {
+            fprintf(stderr, "Usage : %s [degre] [fichier] [trace]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    lecture = lecture_points(fichier, &pts, POINTS_DOUBLE, &info);
+    if (lecture != LECTURE_OK) {
+        fprintf(stderr, "%s : %s (ligne %zu)\n", fichier, lecture_message(lecture), info.ligne);
+        return EXIT_FAILURE;
+    }
+    printf("Lecture: %zu points, %.3f Mo en %.3f s (%.1f Mo/s)\n", pts.n,
+           info.octets / (1024.0 * 1024.0), info.secondes, lecture_debit(&info));
+
+    debut = maintenant();
+    if (polynome_ajuster_points(&pts, degre, &p, &rss) != 0) {
+        fprintf(stderr, "Regression impossible : moins de %d valeurs de x distinctes\n", degre + 1);
+        points_free(&pts);
+        return EXIT_FAILURE;
+    }
+    duree = maintenant() - debut;
+    printf("Ajustement: degre %d en %.3f s, x ramene a [-1, 1] par (x - %.6g) / %.6g\n\n", degre, duree,
+           p.centre, p.demi_etendue);
+
+    polynome_puissances(&p, a);
+    printf("Coefficients:\n");
+    for (j = 0; j <= degre; j++) printf("  a%d = %.9g\n", j, a[j]);
+    printf("Coefficients de Chebyshev:\n");
+    for (j = 0; j <= degre; j++) printf("  c%d = %.9g\n", j, p.c[j]);
+
+    tss = p.yy - p.ty[0] * p.ty[0] / p.n;
+    printf("Somme des residus au carre: %.9g\n", rss);
+    printf("Erreur quadratique moyenne: %.9g\n", rss / (2.0 * p.n));
+    printf("R2: %.9f\n", tss > 0.0 ? 1.0 - rss / tss : 1.0);
+
+    if (trace) {
+        if (tracer(&pts, &p) != 0) fprintf(stderr, "Erreur: impossible de lancer le trace.\n");
+        else printf("Trace envoye a gnuplot (%s).\n", getenv("DISPLAY") ? "fenetre" : "regression_poly.png");
+    }
+
+    points_free(&pts);
+    return 0;
+}
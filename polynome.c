@@ -0,0 +1,168 @@
+/*
+ * polynome.c
+ * Regression polynomiale dans la base de Chebyshev (voir polynome.h).
+ */
+
+#include <math.h>
+#include <string.h>
+#include "polynome.h"
+
+#define POLYNOME_PIVOT 1e-13        /* pivot relatif minimal de Cholesky */
+
+void polynome_init(Polynome *p, int degre, double xmin, double xmax, double y0) {
+    memset(p, 0, sizeof(*p));
+    if (degre < 0) degre = 0;
+    if (degre > POLYNOME_DEGRE_MAX) degre = POLYNOME_DEGRE_MAX;
+    p->degre = degre;
+    p->centre = 0.5 * (xmin + xmax);
+    p->demi_etendue = 0.5 * (xmax - xmin);
+    if (!(p->demi_etendue > 0.0)) p->demi_etendue = 1.0;
+    p->y0 = y0;
+}
+
+/* Moments d'un bloc de points dans des sommes locales, puis ajoutes a p */
+#define POLYNOME_BLOC(X, Y)                                                     \
+    double t[2 * POLYNOME_DEGRE_MAX + 1] = {0.0};                               \
+    double ty[POLYNOME_DEGRE_MAX + 1] = {0.0};                                  \
+    double yy = 0.0, inv = 1.0 / p->demi_etendue;                               \
+    int d2 = 2 * p->degre, k;                                                   \
+    size_t i;                                                                   \
+                                                                                \
+    for (i = 0; i < n; i++) {                                                   \
+        double u = ((X) - p->centre) * inv, v = (Y) - p->y0;                    \
+        double tk = u, tkm1 = 1.0;                                              \
+        t[0] += 1.0;                                                            \
+        ty[0] += v;                                                             \
+        yy += v * v;                                                            \
+        for (k = 1; k <= d2; k++) {                                             \
+            double suivant = 2.0 * u * tk - tkm1;                               \
+            t[k] += tk;                                                         \
+            if (k <= p->degre) ty[k] += v * tk;                                 \
+            tkm1 = tk;                                                          \
+            tk = suivant;                                                       \
+        }                                                                       \
+    }                                                                           \
+    p->n += (double)n;                                                          \
+    for (k = 0; k <= d2; k++) p->t[k] += t[k];                                  \
+    for (k = 0; k <= p->degre; k++) p->ty[k] += ty[k];                          \
+    p->yy += yy;
+
+static void bloc_double(Polynome *p, const double *x, const double *y, size_t n) {
+    POLYNOME_BLOC(x[i], y[i])
+}
+
+static void bloc_float(Polynome *p, const float *x, const float *y, size_t n) {
+    POLYNOME_BLOC((double)x[i], (double)y[i])
+}
+
+void polynome_ajouter(Polynome *p, double x, double y) {
+    bloc_double(p, &x, &y, 1);
+}
+
+void polynome_ajouter_points(Polynome *p, const Points *pts) {
+    if (pts->type == POINTS_FLOAT) bloc_float(p, pts->xf, pts->yf, pts->n);
+    else bloc_double(p, pts->xd, pts->yd, pts->n);
+}
+
+void polynome_fusion(Polynome *p, const Polynome *autre) {
+    int k;
+
+    p->n += autre->n;
+    for (k = 0; k <= 2 * p->degre; k++) p->t[k] += autre->t[k];
+    for (k = 0; k <= p->degre; k++) p->ty[k] += autre->ty[k];
+    p->yy += autre->yy;
+}
+
+int polynome_resoudre(Polynome *p, double *rss) {
+    double g[POLYNOME_DEGRE_MAX + 1][POLYNOME_DEGRE_MAX + 1];
+    double l[POLYNOME_DEGRE_MAX + 1][POLYNOME_DEGRE_MAX + 1];
+    double w[POLYNOME_DEGRE_MAX + 1], reste = p->yy;
+    int m = p->degre + 1, i, j, k;
+
+    /* Σ T_i T_j = (Σ T_{i+j} + Σ T_{|i-j|}) / 2 */
+    for (i = 0; i < m; i++)
+        for (j = 0; j <= i; j++) g[i][j] = 0.5 * (p->t[i + j] + p->t[i - j]);
+
+    for (j = 0; j < m; j++) {
+        double d = g[j][j];
+        for (k = 0; k < j; k++) d -= l[j][k] * l[j][k];
+        if (!(d > POLYNOME_PIVOT * g[j][j])) return -1;
+        l[j][j] = sqrt(d);
+        for (i = j + 1; i < m; i++) {
+            double s = g[i][j];
+            for (k = 0; k < j; k++) s -= l[i][k] * l[j][k];
+            l[i][j] = s / l[j][j];
+        }
+    }
+
+    /* L w = Σ y T, Lᵀ c = w ; Σ residus² = Σ y² - wᵀw */
+    for (i = 0; i < m; i++) {
+        double s = p->ty[i];
+        for (k = 0; k < i; k++) s -= l[i][k] * w[k];
+        w[i] = s / l[i][i];
+        reste -= w[i] * w[i];
+    }
+    for (i = m - 1; i >= 0; i--) {
+        double s = w[i];
+        for (k = i + 1; k < m; k++) s -= l[k][i] * p->c[k];
+        p->c[i] = s / l[i][i];
+    }
+    p->c[0] += p->y0;
+    if (rss) *rss = reste > 0.0 ? reste : 0.0;
+    return 0;
+}
+
+double polynome_valeur(const Polynome *p, double x) {
+    double u = (x - p->centre) / p->demi_etendue, b1 = 0.0, b2 = 0.0;
+    int k;
+
+    for (k = p->degre; k >= 1; k--) {
+        double b0 = 2.0 * u * b1 - b2 + p->c[k];
+        b2 = b1;
+        b1 = b0;
+    }
+    return u * b1 - b2 + p->c[0];
+}
+
+void polynome_puissances(const Polynome *p, double *a) {
+    double prec[POLYNOME_DEGRE_MAX + 2] = {0.0}, cour[POLYNOME_DEGRE_MAX + 2] = {1.0};
+    double at[POLYNOME_DEGRE_MAX + 1] = {0.0}, binome[POLYNOME_DEGRE_MAX + 1];
+    double puissance_e = 1.0;
+    int d = p->degre, i, j, k;
+
+    /* T_k en puissances de t : T_0 = 1, T_1 = t, T_{k+1} = 2t T_k - T_{k-1} */
+    for (k = 0; k <= d; k++) {
+        for (j = 0; j <= k; j++) at[j] += p->c[k] * cour[j];
+        for (j = k + 1; j >= 0; j--) {
+            double suivant = (j > 0 ? (k > 0 ? 2.0 : 1.0) * cour[j - 1] : 0.0) - prec[j];
+            prec[j] = cour[j];
+            cour[j] = suivant;
+        }
+    }
+
+    /* t^j = ((x - centre) / e)^j = e^-j Σ_i C(j, i) x^i (-centre)^(j-i) */
+    for (i = 0; i <= d; i++) a[i] = 0.0;
+    for (j = 0; j <= d; j++) {
+        binome[j] = 1.0;
+        for (i = j - 1; i > 0; i--) binome[i] += binome[i - 1];
+        for (i = 0; i <= j; i++)
+            a[i] += at[j] / puissance_e * binome[i] * pow(-p->centre, j - i);
+        puissance_e *= p->demi_etendue;
+    }
+}
+
+int polynome_ajuster_points(const Points *pts, int degre, Polynome *p, double *rss) {
+    double xmin, xmax, x;
+    size_t i;
+
+    if (pts->n == 0) return -1;
+    xmin = xmax = pts->type == POINTS_FLOAT ? pts->xf[0] : pts->xd[0];
+    for (i = 1; i < pts->n; i++) {
+        x = pts->type == POINTS_FLOAT ? pts->xf[i] : pts->xd[i];
+        if (x < xmin) xmin = x;
+        if (x > xmax) xmax = x;
+    }
+    polynome_init(p, degre, xmin, xmax, pts->type == POINTS_FLOAT ? pts->yf[0] : pts->yd[0]);
+    polynome_ajouter_points(p, pts);
+    return polynome_resoudre(p, rss);
+}
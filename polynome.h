@@ -0,0 +1,78 @@
+/*
+ * polynome.h
+ * Regression polynomiale y = p(x) de degre d <= POLYNOME_DEGRE_MAX, sans
+ * matrice de Vandermonde : la memoire est O(d) quel que soit n.
+ *
+ * x est d'abord ramene a t = (x - centre) / demi_etendue, dans [-1, 1]
+ * pour l'intervalle donne a polynome_init, et p est cherche dans la base
+ * de Chebyshev : p = Σ c_k T_k(t). Comme T_i T_j = (T_{i+j} + T_{|i-j|}) / 2,
+ * la matrice des equations normales ne demande que les moments
+ *   Σ T_k(t)      k = 0..2d
+ *   Σ y T_k(t)    k = 0..d
+ * accumules en une passe (recurrence T_{k+1} = 2t T_k - T_{k-1}, avec y
+ * decale de y0 comme les moments centres de moments.h). Dans cette base la
+ * matrice reste proche de la diagonale pour des x bien repartis, alors
+ * qu'en puissances de x elle est aussi mal conditionnee qu'une matrice de
+ * Hilbert des le degre 5 ou 6. Le systeme (d+1) x (d+1) est resolu par
+ * Cholesky.
+ *
+ * Des points hors de l'intervalle restent valides (|T_k| y croit
+ * seulement plus vite) : un fichier lu par morceaux peut prendre
+ * l'intervalle de son premier morceau. Deux accumulateurs de meme repere
+ * se fusionnent par simple addition.
+ */
+
+#ifndef POLYNOME_H
+#define POLYNOME_H
+
+#include "points.h"
+
+#define POLYNOME_DEGRE_MAX 12
+
+typedef struct {
+    int degre;
+    double centre, demi_etendue;        /* t = (x - centre) / demi_etendue */
+    double y0;                          /* decalage de y */
+    double n;
+    double t[2 * POLYNOME_DEGRE_MAX + 1];  /* Σ T_k(t) */
+    double ty[POLYNOME_DEGRE_MAX + 1];     /* Σ (y - y0) T_k(t) */
+    double yy;                          /* Σ (y - y0)² */
+    double c[POLYNOME_DEGRE_MAX + 1];   /* coefficients de Chebyshev (polynome_resoudre) */
+} Polynome;
+
+/* Accumulateur vide de degre d pour x dans [xmin, xmax] (xmin = xmax admis) */
+void polynome_init(Polynome *p, int degre, double xmin, double xmax, double y0);
+
+/* Ajoute un point */
+void polynome_ajouter(Polynome *p, double x, double y);
+
+/* Ajoute tous les points du stockage */
+void polynome_ajouter_points(Polynome *p, const Points *pts);
+
+/* p <- p ∪ autre (meme degre et meme repere) */
+void polynome_fusion(Polynome *p, const Polynome *autre);
+
+/*
+ * Resout les equations normales et remplit p->c. rss recoit Σ residus²
+ * (peut etre NULL). Retourne -1 si les x distincts ne suffisent pas au
+ * degre (matrice singuliere).
+ */
+int polynome_resoudre(Polynome *p, double *rss);
+
+/* p(x) par l'algorithme de Clenshaw, apres polynome_resoudre */
+double polynome_valeur(const Polynome *p, double x);
+
+/*
+ * Coefficients a[0..d] de p(x) = Σ a_k x^k, pour l'affichage : ils sont
+ * d'autant moins precis que l'intervalle est loin de 0 ou le degre eleve,
+ * la valeur doit etre calculee par polynome_valeur.
+ */
+void polynome_puissances(const Polynome *p, double *a);
+
+/*
+ * Ajustement complet de points en memoire : intervalle [min x, max x],
+ * y0 = premier y. Retourne comme polynome_resoudre.
+ */
+int polynome_ajuster_points(const Points *pts, int degre, Polynome *p, double *rss);
+
+#endif
@@ -0,0 +1,297 @@
+/*
+ * pool.c
+ * Pool de threads persistant et reduction deterministe (voir pool.h).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "pool.h"
+
+struct Pool {
+    int nthreads;                   /* threads au total, appelant compris */
+    pthread_t *threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t debut, fin;
+    unsigned long generation;       /* incremente a chaque lot */
+    int actifs;                     /* travailleurs n'ayant pas fini le lot */
+    int occupe;
+    int arret;
+
+    PoolTache tache;                /* lot courant */
+    void *ctx;
+    size_t ntaches;
+    atomic_size_t suivante;
+
+    double *partiels;               /* sommes partielles par bloc */
+    size_t capacite;
+};
+
+static _Thread_local int dans_pool = 0;
+
+static void executer_taches(Pool *p) {
+    size_t t;
+
+    dans_pool = 1;
+    while ((t = atomic_fetch_add(&p->suivante, 1)) < p->ntaches) {
+        p->tache(p->ctx, t);
+    }
+    dans_pool = 0;
+}
+
+static void *travailleur(void *arg) {
+    Pool *p = (Pool *)arg;
+    unsigned long vue = 0;
+
+    pthread_mutex_lock(&p->mutex);
+    for (;;) {
+        while (!p->arret && p->generation == vue) {
+            pthread_cond_wait(&p->debut, &p->mutex);
+        }
+        if (p->arret) break;
+        vue = p->generation;
+        pthread_mutex_unlock(&p->mutex);
+
+        executer_taches(p);
+
+        pthread_mutex_lock(&p->mutex);
+        if (--p->actifs == 0) pthread_cond_signal(&p->fin);
+    }
+    pthread_mutex_unlock(&p->mutex);
+    return NULL;
+}
+
+static int threads_demandes(void) {
+    const char *env = getenv("REGRESSION_THREADS");
+    long n;
+
+    if (env && *env) {
+        n = strtol(env, NULL, 10);
+        if (n > 0) return (int)n;
+    }
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
+
+Pool *pool_creer(int nthreads) {
+    Pool *p = (Pool *)calloc(1, sizeof(Pool));
+    int i;
+
+    if (!p) return NULL;
+    if (nthreads <= 0) nthreads = threads_demandes();
+
+    pthread_mutex_init(&p->mutex, NULL);
+    pthread_cond_init(&p->debut, NULL);
+    pthread_cond_init(&p->fin, NULL);
+    p->nthreads = 1;
+
+    if (nthreads > 1) {
+        p->threads = (pthread_t *)malloc((size_t)(nthreads - 1) * sizeof(pthread_t));
+        if (!p->threads) {
+            pool_detruire(p);
+            return NULL;
+        }
+        for (i = 0; i < nthreads - 1; i++) {
+            if (pthread_create(&p->threads[i], NULL, travailleur, p) != 0) break;
+            p->nthreads++;
+        }
+    }
+    return p;
+}
+
+void pool_detruire(Pool *p) {
+    int i;
+
+    if (!p) return;
+    pthread_mutex_lock(&p->mutex);
+    p->arret = 1;
+    pthread_cond_broadcast(&p->debut);
+    pthread_mutex_unlock(&p->mutex);
+    for (i = 0; i < p->nthreads - 1; i++) {
+        pthread_join(p->threads[i], NULL);
+    }
+    pthread_cond_destroy(&p->debut);
+    pthread_cond_destroy(&p->fin);
+    pthread_mutex_destroy(&p->mutex);
+    free(p->partiels);
+    free(p->threads);
+    free(p);
+}
+
+static Pool *pool_global = NULL;
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+
+static void pool_global_liberer(void) {
+    pool_detruire(pool_global);
+    pool_global = NULL;
+}
+
+static void pool_global_creer(void) {
+    pool_global = pool_creer(0);
+    if (!pool_global) pool_global = pool_creer(1);
+    atexit(pool_global_liberer);
+}
+
+Pool *pool_defaut(void) {
+    pthread_once(&pool_once, pool_global_creer);
+    return pool_global;
+}
+
+int pool_threads(const Pool *p) {
+    return p ? p->nthreads : 1;
+}
+
+/* Reserve le pool pour un lot ; 0 s'il faut travailler en sequence */
+static int acquerir(Pool *p) {
+    int libre = 0;
+
+    if (!p || p->nthreads <= 1 || dans_pool) return 0;
+    pthread_mutex_lock(&p->mutex);
+    if (!p->occupe) {
+        p->occupe = 1;
+        libre = 1;
+    }
+    pthread_mutex_unlock(&p->mutex);
+    return libre;
+}
+
+/* Execute un lot sur le pool reserve, puis le libere */
+static void lancer(Pool *p, size_t ntaches, PoolTache tache, void *ctx) {
+    pthread_mutex_lock(&p->mutex);
+    p->tache = tache;
+    p->ctx = ctx;
+    p->ntaches = ntaches;
+    atomic_store(&p->suivante, 0);
+    p->actifs = p->nthreads - 1;
+    p->generation++;
+    pthread_cond_broadcast(&p->debut);
+    pthread_mutex_unlock(&p->mutex);
+
+    executer_taches(p);
+
+    pthread_mutex_lock(&p->mutex);
+    while (p->actifs > 0) {
+        pthread_cond_wait(&p->fin, &p->mutex);
+    }
+    p->occupe = 0;
+    pthread_mutex_unlock(&p->mutex);
+}
+
+void pool_executer(Pool *p, size_t ntaches, PoolTache tache, void *ctx) {
+    size_t t;
+
+    if (ntaches > 1 && acquerir(p)) {
+        lancer(p, ntaches, tache, ctx);
+        return;
+    }
+    for (t = 0; t < ntaches; t++) tache(ctx, t);
+}
+
+typedef struct {
+    PoolBloc bloc;
+    void *ctx;
+    size_t n;
+    int nsommes;
+    double *partiels;
+} Reduction;
+
+static void tache_reduction(void *arg, size_t b) {
+    Reduction *r = (Reduction *)arg;
+    size_t debut = b * POOL_BLOC;
+    size_t fin = (r->n - debut > POOL_BLOC) ? debut + POOL_BLOC : r->n;
+    double *s = r->partiels + b * (size_t)r->nsommes;
+
+    memset(s, 0, (size_t)r->nsommes * sizeof(double));
+    r->bloc(r->ctx, debut, fin, s);
+}
+
+/*
+ * Version sequentielle sans allocation : un compteur binaire garde au plus
+ * un partiel par niveau de l'arbre, ce qui reproduit exactement les
+ * regroupements de la version parallele.
+ */
+static void reduire_sequentiel(Reduction *r, size_t nblocs, double *resultat) {
+    double niveaux[64][POOL_SOMMES_MAX];
+    double courant[POOL_SOMMES_MAX];
+    int nsommes = r->nsommes;
+    size_t b;
+    int niveau, k, premier;
+
+    for (b = 0; b < nblocs; b++) {
+        size_t debut = b * POOL_BLOC;
+        size_t fin = (r->n - debut > POOL_BLOC) ? debut + POOL_BLOC : r->n;
+
+        memset(courant, 0, (size_t)nsommes * sizeof(double));
+        r->bloc(r->ctx, debut, fin, courant);
+        for (niveau = 0; (b >> niveau) & 1; niveau++) {
+            for (k = 0; k < nsommes; k++) courant[k] = niveaux[niveau][k] + courant[k];
+        }
+        memcpy(niveaux[niveau], courant, (size_t)nsommes * sizeof(double));
+    }
+
+    /* Niveaux restants, du plus bas (a droite) au plus haut (a gauche) */
+    premier = 1;
+    for (niveau = 0; niveau < 64; niveau++) {
+        if (!((nblocs >> niveau) & 1)) continue;
+        if (premier) {
+            memcpy(resultat, niveaux[niveau], (size_t)nsommes * sizeof(double));
+            premier = 0;
+        } else {
+            for (k = 0; k < nsommes; k++) resultat[k] = niveaux[niveau][k] + resultat[k];
+        }
+    }
+}
+
+void pool_reduire(Pool *p, size_t n, int nsommes, PoolBloc bloc, void *ctx, double *resultat) {
+    size_t nblocs = (n + POOL_BLOC - 1) / POOL_BLOC;
+    size_t pas, b, taille;
+    Reduction r;
+    int k;
+
+    memset(resultat, 0, (size_t)nsommes * sizeof(double));
+    if (nblocs == 0) return;
+    if (nblocs == 1) {
+        bloc(ctx, 0, n, resultat);
+        return;
+    }
+
+    r.bloc = bloc;
+    r.ctx = ctx;
+    r.n = n;
+    r.nsommes = nsommes;
+
+    taille = nblocs * (size_t)nsommes;
+    if (!acquerir(p)) {
+        reduire_sequentiel(&r, nblocs, resultat);
+        return;
+    }
+    if (taille > p->capacite) {
+        double *t = (double *)realloc(p->partiels, taille * sizeof(double));
+        if (!t) {
+            pthread_mutex_lock(&p->mutex);
+            p->occupe = 0;
+            pthread_mutex_unlock(&p->mutex);
+            reduire_sequentiel(&r, nblocs, resultat);
+            return;
+        }
+        p->partiels = t;
+        p->capacite = taille;
+    }
+    r.partiels = p->partiels;
+
+    lancer(p, nblocs, tache_reduction, &r);
+
+    /* Arbre binaire fixe : (0,1) (2,3) ... puis (0,2) (4,6) ... */
+    for (pas = 1; pas < nblocs; pas *= 2) {
+        for (b = 0; b + pas < nblocs; b += 2 * pas) {
+            double *g = r.partiels + b * (size_t)nsommes;
+            double *d = r.partiels + (b + pas) * (size_t)nsommes;
+            for (k = 0; k < nsommes; k++) g[k] += d[k];
+        }
+    }
+    memcpy(resultat, r.partiels, (size_t)nsommes * sizeof(double));
+}
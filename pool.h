@@ -0,0 +1,49 @@
+/*
+ * pool.h
+ * Pool de threads persistant et reduction deterministe.
+ *
+ * Les n points sont decoupes en blocs de POOL_BLOC points ; chaque bloc
+ * produit ses sommes partielles, puis les blocs sont combines par un arbre
+ * binaire dont la forme ne depend que de n. Le resultat est donc identique
+ * au bit pres quel que soit le nombre de threads.
+ *
+ * Nombre de threads : argument de pool_creer, ou variable d'environnement
+ * REGRESSION_THREADS pour le pool par defaut (sinon nombre de coeurs).
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+#define POOL_BLOC 8192
+#define POOL_SOMMES_MAX 16      /* nsommes maximal pour pool_reduire */
+
+typedef struct Pool Pool;
+
+/* Tache numero t d'un lot */
+typedef void (*PoolTache)(void *ctx, size_t t);
+
+/* Sommes partielles des points [debut, fin) dans sommes[] (deja mis a zero) */
+typedef void (*PoolBloc)(void *ctx, size_t debut, size_t fin, double *sommes);
+
+/* nthreads <= 0 : REGRESSION_THREADS ou nombre de coeurs. NULL en cas d'echec. */
+Pool *pool_creer(int nthreads);
+void pool_detruire(Pool *p);
+
+/* Pool partage par le programme, cree au premier appel */
+Pool *pool_defaut(void);
+
+int pool_threads(const Pool *p);
+
+/*
+ * Execute les taches 0..ntaches-1 sur le pool, l'appelant participant.
+ * Un appel depuis une tache (ou pendant qu'un autre lot occupe le pool)
+ * s'execute en sequence dans le thread appelant.
+ */
+void pool_executer(Pool *p, size_t ntaches, PoolTache tache, void *ctx);
+
+/* Reduction deterministe de nsommes sommes sur n points */
+void pool_reduire(Pool *p, size_t n, int nsommes, PoolBloc bloc, void *ctx, double *resultat);
+
+#endif
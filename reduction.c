@@ -0,0 +1,68 @@
+/*
+ * reduction.c
+ * Minimum et maximum par colonne de pixels (voir reduction.h).
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "reduction.h"
+
+#define AUCUN SIZE_MAX
+
+/*
+ * Corps commun aux deux precisions : une passe pour l'etendue des x, une
+ * passe pour les indices des extremums de chaque colonne.
+ */
+#define REDUCTION_MINMAX(T)                                                     \
+    size_t *imin, *imax, m = 0, i;                                              \
+    T xmin, xmax;                                                               \
+    double echelle;                                                             \
+    int c;                                                                      \
+                                                                                \
+    if (n == 0 || colonnes < 1) return 0;                                       \
+    if (n <= 2 * (size_t)colonnes) {                                            \
+        memcpy(xs, x, n * sizeof(T));                                           \
+        memcpy(ys, y, n * sizeof(T));                                           \
+        return n;                                                               \
+    }                                                                           \
+    imin = malloc(2 * (size_t)colonnes * sizeof(size_t));                       \
+    if (!imin) return 0;                                                        \
+    imax = imin + colonnes;                                                     \
+    for (c = 0; c < colonnes; c++) imin[c] = imax[c] = AUCUN;                   \
+                                                                                \
+    xmin = xmax = x[0];                                                         \
+    for (i = 1; i < n; i++) {                                                   \
+        if (x[i] < xmin) xmin = x[i];                                           \
+        if (x[i] > xmax) xmax = x[i];                                           \
+    }                                                                           \
+    echelle = xmax > xmin ? colonnes / ((double)xmax - xmin) : 0.0;             \
+                                                                                \
+    for (i = 0; i < n; i++) {                                                   \
+        c = (int)((x[i] - (double)xmin) * echelle);                             \
+        if (c >= colonnes) c = colonnes - 1;                                    \
+        if (imin[c] == AUCUN) {                                                 \
+            imin[c] = imax[c] = i;                                              \
+        } else {                                                                \
+            if (y[i] < y[imin[c]]) imin[c] = i;                                 \
+            if (y[i] > y[imax[c]]) imax[c] = i;                                 \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    for (c = 0; c < colonnes; c++) {                                            \
+        size_t u = imin[c], v = imax[c];                                        \
+        if (u == AUCUN) continue;                                               \
+        if (x[v] < x[u]) { size_t t = u; u = v; v = t; }                        \
+        xs[m] = x[u]; ys[m] = y[u]; m++;                                        \
+        if (v != u) { xs[m] = x[v]; ys[m] = y[v]; m++; }                        \
+    }                                                                           \
+    free(imin);                                                                 \
+    return m;
+
+size_t reduction_minmax(const double *x, const double *y, size_t n, int colonnes, double *xs, double *ys) {
+    REDUCTION_MINMAX(double)
+}
+
+size_t reduction_minmaxf(const float *x, const float *y, size_t n, int colonnes, float *xs, float *ys) {
+    REDUCTION_MINMAX(float)
+}
@@ -0,0 +1,29 @@
+/*
+ * reduction.h
+ * Reduction des points a tracer a la resolution de l'image : l'etendue
+ * des x est decoupee en `colonnes` colonnes de pixels, et chaque colonne
+ * ne garde que son point de y minimal et son point de y maximal (dans
+ * l'ordre des x). Le nuage garde son enveloppe, et un point isole (comme
+ * (0, 0.8) dans donnees.txt) reste visible puisqu'il est un extremum de sa
+ * colonne. Une passe sur les donnees, dans n'importe quel ordre ; au plus
+ * 2 * colonnes points en sortie, quel que soit n.
+ */
+
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <stddef.h>
+
+#define REDUCTION_COLONNES 800      /* largeur des images PNG des programmes */
+
+/*
+ * Ecrit dans xs, ys (2 * colonnes places) les points retenus et retourne
+ * leur nombre. Si n <= 2 * colonnes, les points sont copies tels quels.
+ * Retourne 0 si n = 0 ou en cas d'allocation impossible.
+ */
+size_t reduction_minmax(const double *x, const double *y, size_t n, int colonnes, double *xs, double *ys);
+
+/* Meme reduction sur des colonnes float */
+size_t reduction_minmaxf(const float *x, const float *y, size_t n, int colonnes, float *xs, float *ys);
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * regression.c
+ * Regression lineaire multiple y = b0 + b1 x1 + ... + bk xk (multiple.h).
+ * Lecture d'un fichier a k variables explicatives : premiere ligne "n k",
+ * puis n lignes "x1, ..., xk, y" ; donnees.txt (premiere ligne n seule)
+ * est lu avec k = 1 et donne la droite de moinCarre.
+ *
+ * Usage : ./regression [fichier] [qr]
+ *   fichier : defaut donnees.txt
+ *   qr      : factorisation QR directement, sans essayer Cholesky
+ * Les sommes sont reparties sur un pool de threads (REGRESSION_THREADS=k) ;
+ * MULTIPLE_ISA=generique|avx2|avx512 force le noyau de la matrice de Gram.
+ *
+ * Compilation : gcc -O2 regression.c multiple.c points.c lecture.c pool.c -o regression -lm -pthread
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "points.h"
+#include "lecture.h"
+#include "pool.h"
+#include "multiple.h"
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    const char *fichier = "donnees.txt";
+    int forcer_qr = 0, code, j;
+    Tableau t;
+    LectureInfo info;
+    LectureCode lecture;
+    MultipleInfo mi;
+    double *beta, debut, duree;
+
+    for (j = 1; j < argc; j++) {
+        if (strcmp(argv[j], "qr") == 0) forcer_qr = 1;
+        else if (argv[j][0] != '-') fichier = argv[j];
+        else {
+            fprintf(stderr, "Usage : %s [fichier] [qr]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    lecture = lecture_tableau(fichier, &t, &info);
+    if (lecture != LECTURE_OK) {
+        fprintf(stderr, "%s : %s (ligne %zu)\n", fichier, lecture_message(lecture), info.ligne);
+        return EXIT_FAILURE;
+    }
+    printf("Lecture: %zu lignes, %d variables, %.3f Mo en %.3f s (%.1f Mo/s)\n", t.n, t.k,
+           info.octets / (1024.0 * 1024.0), info.secondes, lecture_debit(&info));
+
+    beta = (double *)malloc((size_t)(t.k + 1) * sizeof(double));
+    if (!beta) {
+        fprintf(stderr, "Probleme d'allocation memoire\n");
+        tableau_free(&t);
+        return EXIT_FAILURE;
+    }
+
+    debut = maintenant();
+    code = multiple_ajuster(&t, forcer_qr, beta, &mi);
+    duree = maintenant() - debut;
+    if (code != 0) {
+        fprintf(stderr, code == -2 ? "Probleme d'allocation memoire\n"
+                                   : "Regression impossible : moins de k + 1 lignes ou variables colineaires\n");
+        free(beta);
+        tableau_free(&t);
+        return EXIT_FAILURE;
+    }
+
+    printf("Ajustement: %s en %.3f s (%.1f Mo/s, %d threads, noyau %s)", mi.methode == MULTIPLE_QR ? "QR" : "Cholesky",
+           duree, t.n * (t.k + 1.0) * sizeof(double) / (1024.0 * 1024.0) / duree, pool_threads(pool_defaut()),
+           multiple_isa());
+    if (!forcer_qr) printf(", pivot relatif minimal %.3e", mi.pivot_min);
+    printf("\n\nCoefficients:\n");
+    printf("  b0 = %.9g\n", beta[0]);
+    for (j = 1; j <= t.k; j++) printf("  b%d = %.9g\n", j, beta[j]);
+    printf("Somme des residus au carre: %.9g\n", mi.rss);
+    printf("Erreur quadratique moyenne: %.9g\n", mi.rss / (2.0 * t.n));
+    printf("R2: %.9f\n", mi.r2);
+
+    free(beta);
+    tableau_free(&t);
+    return 0;
+}
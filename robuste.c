@@ -0,0 +1,670 @@
+/*
+ * robuste.c
+ * Droites de Theil-Sen et de Siegel (voir robuste.h).
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "robuste.h"
+#include "pool.h"
+#include "alea.h"
+
+#define MARGE 2.0               /* demi-fenetre autour du rang cherche, en sqrt(taille de l'echantillon) */
+#define ARRONDI (8.0 * DBL_EPSILON)     /* erreur relative majorant un ecart de cles (voir avant) */
+#define TOURS_VAINS 4           /* tours consecutifs sans resserrement avant d'abandonner */
+
+/* ===== Selection ===== */
+
+/* k-ieme plus petite valeur ; v est permute : v[0..k) <= v[k] <= v[k+1..m) */
+static double selectionner(double *v, size_t m, size_t k) {
+    ptrdiff_t g = 0, d = (ptrdiff_t)m - 1, kk = (ptrdiff_t)k;
+
+    while (g < d) {
+        ptrdiff_t i = g, j = d, c = g + (d - g) / 2;
+        double pivot, t;
+
+        /* pivot : mediane de trois */
+        if (v[c] < v[g]) { t = v[c]; v[c] = v[g]; v[g] = t; }
+        if (v[d] < v[g]) { t = v[d]; v[d] = v[g]; v[g] = t; }
+        if (v[d] < v[c]) { t = v[d]; v[d] = v[c]; v[c] = t; }
+        pivot = v[c];
+        while (i <= j) {
+            while (v[i] < pivot) i++;
+            while (v[j] > pivot) j--;
+            if (i <= j) {
+                t = v[i]; v[i] = v[j]; v[j] = t;
+                i++;
+                j--;
+            }
+        }
+        if (kk <= j) d = j;
+        else if (kk >= i) g = i;
+        else break;
+    }
+    return v[k];
+}
+
+/* Moyenne des valeurs de rangs k et k + 1 (m pair) ou valeur de rang k (m impair) */
+static double rangs_median(double *v, size_t m, size_t k1, size_t k2) {
+    double a = selectionner(v, m, k1), b = a;
+    size_t i;
+
+    if (k2 != k1) {
+        b = v[k1 + 1];
+        for (i = k1 + 2; i < m; i++) if (v[i] < b) b = v[i];
+    }
+    return 0.5 * (a + b);
+}
+
+static int comparer(const void *a, const void *b) {
+    double u = *(const double *)a, v = *(const double *)b;
+    return (u > v) - (u < v);
+}
+
+/* ===== Tri fusion par cles u = y - s x, avec les inversions ===== */
+
+typedef struct {
+    double u;                   /* cle y - s x */
+    double m;                   /* |y| + |s x| : echelle de l'erreur d'arrondi de u */
+    size_t i;
+} Element;
+
+/* Etat d'une tache de tri : ses inversions et ses tirages */
+typedef struct {
+    size_t inversions;
+    size_t prochain;            /* numero local de la prochaine inversion tiree */
+    uint64_t cle, tirages;
+    double *pentes;
+    size_t npentes, capacite;
+    int erreur;
+} Part;
+
+typedef struct {
+    const double *x, *y;
+    size_t n;
+    Element *a, *b;             /* elements et tampon */
+    double s;                   /* pente des cles */
+    double p;                   /* probabilite de tirer une inversion (0 : compter seulement) */
+    uint64_t graine;
+    size_t *compte;             /* inversions par point (Siegel), ou NULL */
+    Part *parts;                /* parts du niveau courant */
+    size_t largeur;             /* largeur des suites fusionnees au niveau courant */
+} Tri;
+
+static void cle(double s, double x, double y, Element *e) {
+    if (s == -INFINITY) e->u = x;       /* ordre des x croissants */
+    else if (s == INFINITY) e->u = -x;  /* ordre des x decroissants */
+    else {
+        e->u = y - s * x;
+        e->m = fabs(y) + fabs(s * x);
+        return;
+    }
+    e->m = 0.0;                         /* cle exacte */
+}
+
+/* Pente de la paire, calculee comme par le calcul direct */
+static double pente(double x1, double y1, double x2, double y2) {
+    return (y2 - y1) / (x2 - x1);
+}
+
+/*
+ * a avant b dans l'ordre de pente s. Les cles tranchent si leur ecart
+ * depasse l'erreur d'arrondi possible (celle des cles et celle de la
+ * pente de la paire). Sinon la pente de la paire est comparee a s : la
+ * paire est dans l'ordre des x croissants si elle vaut au moins s,
+ * inversee si elle est < s. Des cles arrondies seules laisseraient des
+ * paires de pente proche de s (ou egale, sur donnees quantifiees) du
+ * mauvais cote et fausseraient les comptes.
+ */
+static int avant(const Tri *t, const Element *a, const Element *b) {
+    double d = b->u - a->u, marge = ARRONDI * (a->m + b->m);
+    double xa, xb, ya, yb;
+
+    if (d > marge) return 1;
+    if (d < -marge) return 0;
+    xa = t->x[a->i];
+    xb = t->x[b->i];
+    ya = t->y[a->i];
+    yb = t->y[b->i];
+    if (xa == xb) return ya < yb;
+    if (xa < xb) return !(pente(xa, ya, xb, yb) < t->s);
+    return pente(xb, yb, xa, ya) < t->s;
+}
+
+/* Inversions a passer avant la prochaine tiree : loi geometrique de parametre p */
+static size_t saut(const Tri *t, Part *q) {
+    double v;
+
+    if (t->p >= 1.0) return 0;
+    v = floor(log(alea_uniforme(alea_melange(q->cle ^ alea_melange(q->tirages++)))) / log1p(-t->p));
+    return v < (double)(SIZE_MAX / 2) ? (size_t)v : SIZE_MAX / 2;
+}
+
+static void tirer(const Tri *t, Part *q, const Element *g, const Element *d) {
+    double dx = t->x[d->i] - t->x[g->i];
+
+    if (dx == 0.0) return;
+    if (q->npentes == q->capacite) {
+        size_t capacite = q->capacite ? 2 * q->capacite : 1024;
+        double *pentes = (double *)realloc(q->pentes, capacite * sizeof(double));
+        if (!pentes) {
+            q->erreur = 1;
+            return;
+        }
+        q->pentes = pentes;
+        q->capacite = capacite;
+    }
+    q->pentes[q->npentes++] = pente(t->x[g->i], t->y[g->i], t->x[d->i], t->y[d->i]);
+}
+
+/* Fusion stable de g et d dans sortie ; un element de d qui passe devant des elements de g est inverse avec eux */
+static void fusionner(const Tri *t, Part *q, const Element *g, size_t ng, const Element *d, size_t nd, Element *sortie) {
+    size_t i = 0, j = 0;
+
+    while (i < ng && j < nd) {
+        if (avant(t, &d[j], &g[i])) {
+            size_t reste = ng - i;
+            if (t->compte) t->compte[d[j].i] += reste;
+            if (t->p > 0.0) {
+                while (q->prochain < q->inversions + reste) {
+                    tirer(t, q, &g[i + (q->prochain - q->inversions)], &d[j]);
+                    q->prochain += 1 + saut(t, q);
+                }
+            }
+            q->inversions += reste;
+            *sortie++ = d[j++];
+        } else {
+            if (t->compte) t->compte[g[i].i] += j;
+            *sortie++ = g[i++];
+        }
+    }
+    for (; i < ng; i++) {
+        if (t->compte) t->compte[g[i].i] += nd;
+        *sortie++ = g[i];
+    }
+    for (; j < nd; j++) *sortie++ = d[j];
+}
+
+static void part_init(const Tri *t, Part *q, size_t numero) {
+    memset(q, 0, sizeof(*q));
+    q->cle = alea_melange(t->graine ^ alea_melange(numero));
+    if (t->p > 0.0) q->prochain = saut(t, q);
+}
+
+/* Premier niveau : cles et tri complet d'un bloc de ROBUSTE_BLOC elements */
+static void tache_bloc(void *ctx, size_t numero) {
+    Tri *t = (Tri *)ctx;
+    size_t debut = numero * ROBUSTE_BLOC, fin = debut + ROBUSTE_BLOC, m, w, k;
+    Element *src, *dst, *tmp;
+    Part *q = &t->parts[numero];
+
+    if (fin > t->n) fin = t->n;
+    m = fin - debut;
+    src = t->a + debut;
+    dst = t->b + debut;
+    part_init(t, q, numero);
+    for (k = 0; k < m; k++) cle(t->s, t->x[src[k].i], t->y[src[k].i], &src[k]);
+
+    for (w = 1; w < m; w *= 2) {
+        for (k = 0; k < m; k += 2 * w) {
+            size_t ng = k + w < m ? w : m - k;
+            size_t nd = k + w < m ? (k + 2 * w < m ? w : m - k - w) : 0;
+            fusionner(t, q, src + k, ng, src + k + ng, nd, dst + k);
+        }
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != t->a + debut) memcpy(t->a + debut, src, m * sizeof(Element));
+}
+
+/* Niveaux suivants : fusion de deux suites de largeur t->largeur */
+static void tache_fusion(void *ctx, size_t numero) {
+    Tri *t = (Tri *)ctx;
+    size_t debut = numero * 2 * t->largeur, milieu = debut + t->largeur, fin = milieu + t->largeur;
+
+    if (milieu > t->n) milieu = t->n;
+    if (fin > t->n) fin = t->n;
+    part_init(t, &t->parts[numero], numero);
+    fusionner(t, &t->parts[numero], t->a + debut, milieu - debut, t->a + milieu, fin - milieu, t->b + debut);
+}
+
+/* Recupere les resultats des parts ; retourne -1 si un tirage a manque de memoire */
+static int recueillir(Part *parts, size_t nparts, size_t *inversions, double **pentes, size_t *npentes) {
+    size_t k;
+    int erreur = 0;
+
+    for (k = 0; k < nparts; k++) {
+        *inversions += parts[k].inversions;
+        erreur |= parts[k].erreur;
+        if (pentes && !erreur && parts[k].npentes) {
+            double *v = (double *)realloc(*pentes, (*npentes + parts[k].npentes) * sizeof(double));
+            if (!v) erreur = 1;
+            else {
+                memcpy(v + *npentes, parts[k].pentes, parts[k].npentes * sizeof(double));
+                *pentes = v;
+                *npentes += parts[k].npentes;
+            }
+        }
+        free(parts[k].pentes);
+    }
+    return erreur ? -1 : 0;
+}
+
+/*
+ * Trie t->a selon les cles de pente s et retourne dans *inversions le
+ * nombre de paires qui ont change d'ordre. p > 0 : ajoute a *pentes
+ * (malloc) chacune de ces pentes avec la probabilite p. Retourne 0 ou -2.
+ */
+static int trier(Tri *t, double s, double p, uint64_t graine, size_t *inversions, double **pentes, size_t *npentes) {
+    size_t nblocs = (t->n + ROBUSTE_BLOC - 1) / ROBUSTE_BLOC, nparts;
+    Element *tmp;
+    int code = 0;
+
+    t->s = s;
+    t->p = p;
+    t->graine = graine;
+    *inversions = 0;
+    if (pentes) {
+        *pentes = NULL;
+        *npentes = 0;
+    }
+    t->parts = (Part *)malloc(nblocs * sizeof(Part));
+    if (!t->parts) return -2;
+
+    pool_executer(pool_defaut(), nblocs, tache_bloc, t);
+    if (recueillir(t->parts, nblocs, inversions, pentes, npentes) != 0) code = -2;
+
+    for (t->largeur = ROBUSTE_BLOC; t->largeur < t->n; t->largeur *= 2) {
+        nparts = (t->n + 2 * t->largeur - 1) / (2 * t->largeur);
+        /* numeros de parts distincts d'un niveau a l'autre pour les tirages */
+        t->graine = alea_melange(t->graine);
+        pool_executer(pool_defaut(), nparts, tache_fusion, t);
+        if (recueillir(t->parts, nparts, inversions, pentes, npentes) != 0) code = -2;
+        tmp = t->a;
+        t->a = t->b;
+        t->b = tmp;
+    }
+    free(t->parts);
+    t->parts = NULL;
+    if (code != 0 && pentes) {
+        free(*pentes);
+        *pentes = NULL;
+    }
+    return code;
+}
+
+/* ===== Donnees communes ===== */
+
+typedef struct {
+    Tri tri;
+    double *xy;                 /* copies en double de points float, ou NULL */
+    Element *ordre;             /* points dans l'ordre des x croissants (pente -inf) */
+    Element *travail, *tampon;
+    size_t paires;              /* paires de x distincts */
+    size_t *groupe;             /* nombre de points de meme x que chaque point, ou NULL */
+} Robuste;
+
+static void robuste_liberer(Robuste *r) {
+    free(r->xy);
+    free(r->ordre);
+    free(r->travail);
+    free(r->tampon);
+    free(r->groupe);
+}
+
+/* Copie des points, tri par x et comptage des paires ; retourne 0, -1 ou -2 */
+static int robuste_preparer(Robuste *r, const Points *pts, int groupes) {
+    size_t n = pts->n, i, j, k, inversions;
+
+    memset(r, 0, sizeof(*r));
+    if (n < 2) return -1;
+    if (pts->type == POINTS_FLOAT) {
+        r->xy = (double *)malloc(2 * n * sizeof(double));
+        if (!r->xy) return -2;
+        for (i = 0; i < n; i++) {
+            r->xy[i] = pts->xf[i];
+            r->xy[n + i] = pts->yf[i];
+        }
+        r->tri.x = r->xy;
+        r->tri.y = r->xy + n;
+    } else {
+        r->tri.x = pts->xd;
+        r->tri.y = pts->yd;
+    }
+    r->tri.n = n;
+    r->ordre = (Element *)malloc(n * sizeof(Element));
+    r->travail = (Element *)malloc(n * sizeof(Element));
+    r->tampon = (Element *)malloc(n * sizeof(Element));
+    if (groupes) r->groupe = (size_t *)malloc(n * sizeof(size_t));
+    if (!r->ordre || !r->travail || !r->tampon || (groupes && !r->groupe)) {
+        robuste_liberer(r);
+        return -2;
+    }
+
+    for (i = 0; i < n; i++) r->travail[i].i = i;
+    r->tri.a = r->travail;
+    r->tri.b = r->tampon;
+    if (trier(&r->tri, -INFINITY, 0.0, 0, &inversions, NULL, NULL) != 0) {
+        robuste_liberer(r);
+        return -2;
+    }
+    memcpy(r->ordre, r->tri.a, n * sizeof(Element));
+
+    r->paires = n * (n - 1) / 2;
+    for (i = 0; i < n; i = j) {
+        for (j = i + 1; j < n && r->tri.x[r->ordre[j].i] == r->tri.x[r->ordre[i].i]; j++) ;
+        r->paires -= (j - i) * (j - i - 1) / 2;
+        if (groupes) for (k = i; k < j; k++) r->groupe[r->ordre[k].i] = j - i;
+    }
+    if (r->paires == 0) {
+        robuste_liberer(r);
+        return -1;
+    }
+    return 0;
+}
+
+/* Trie une copie de depart selon la pente s ; travail recoit le nouvel ordre */
+static int robuste_trier(Robuste *r, const Element *depart, double s, double p, uint64_t graine,
+                         size_t *inversions, double **pentes, size_t *npentes) {
+    int code;
+
+    memcpy(r->travail, depart, r->tri.n * sizeof(Element));
+    r->tri.a = r->travail;
+    r->tri.b = r->tampon;
+    code = trier(&r->tri, s, p, graine, inversions, pentes, npentes);
+    /* le resultat est dans tri.a : travail et tampon ont pu etre echanges */
+    r->travail = r->tri.a;
+    r->tampon = r->tri.b;
+    return code;
+}
+
+/* a0 = mediane des y - a1 x */
+static int ordonnee(const Robuste *r, double a1, double *a0) {
+    size_t n = r->tri.n, i;
+    double *v = (double *)malloc(n * sizeof(double));
+
+    if (!v) return -2;
+    for (i = 0; i < n; i++) v[i] = r->tri.y[i] - a1 * r->tri.x[i];
+    *a0 = rangs_median(v, n, (n - 1) / 2, n / 2);
+    free(v);
+    return 0;
+}
+
+/* Bornes [lo, hi) autour des rangs k1..k2 d'une population de taille total, d'apres l'echantillon trie s[m] */
+static void fenetre(const double *s, size_t m, double k1, double k2, double total, double *lo, double *hi) {
+    double q1 = k1 / total * m - MARGE * sqrt((double)m), q2 = k2 / total * m + MARGE * sqrt((double)m);
+
+    if (q1 >= 0.0) *lo = s[(size_t)q1];
+    if (ceil(q2) < (double)m) *hi = nextafter(s[(size_t)ceil(q2)], INFINITY);
+}
+
+/* ===== Theil-Sen ===== */
+
+int robuste_theil_sen(const Points *pts, double *a0, double *a1, RobusteInfo *info) {
+    Robuste r;
+    Element *courant;           /* ordre des points pour la pente lo */
+    double lo = -INFINITY, hi = INFINITY, *pentes = NULL;
+    size_t n = pts->n, bas = 0, haut, k1, k2, limite, echantillon, npentes, inv;
+    size_t bas_avant = SIZE_MAX, haut_avant = SIZE_MAX;
+    uint64_t graine = 1;
+    int code, tours = 0, vains = 0;
+
+    code = robuste_preparer(&r, pts, 0);
+    if (code != 0) return code;
+    haut = r.paires;
+    k1 = (r.paires - 1) / 2;
+    k2 = r.paires / 2;
+    limite = ROBUSTE_ENUMERATION * n > 65536 ? ROBUSTE_ENUMERATION * n : 65536;
+    echantillon = n < 1024 ? 1024 : (n > ROBUSTE_ECHANTILLON ? ROBUSTE_ECHANTILLON : n);
+    courant = (Element *)malloc(n * sizeof(Element));
+    if (!courant) {
+        robuste_liberer(&r);
+        return -2;
+    }
+    memcpy(courant, r.ordre, n * sizeof(Element));
+
+    /* invariant : bas pentes < lo <= pentes de rangs k1, k2 < hi, haut pentes < hi */
+    while (haut - bas > limite && hi != nextafter(lo, INFINITY)) {
+        double nlo = lo, nhi = hi;
+
+        /* garde-fou : l'intervalle ne se resserre plus, on enumere ce qu'il reste */
+        vains = bas == bas_avant && haut == haut_avant ? vains + 1 : 0;
+        if (vains >= TOURS_VAINS) break;
+        bas_avant = bas;
+        haut_avant = haut;
+        tours++;
+        code = robuste_trier(&r, courant, hi, (double)echantillon / (double)(haut - bas), graine++,
+                             &inv, &pentes, &npentes);
+        if (code != 0) goto fin;
+        if (npentes == 0) continue;
+        qsort(pentes, npentes, sizeof(double), comparer);
+        fenetre(pentes, npentes, (double)(k1 - bas), (double)(k2 - bas), (double)(haut - bas), &nlo, &nhi);
+        free(pentes);
+        pentes = NULL;
+
+        if (nlo > lo) {
+            code = robuste_trier(&r, courant, nlo, 0.0, 0, &inv, NULL, NULL);
+            if (code != 0) goto fin;
+            if (bas + inv <= k1) {
+                lo = nlo;
+                bas += inv;
+                memcpy(courant, r.travail, n * sizeof(Element));
+            } else {
+                /* rangs cherches sous nlo (echantillon atypique) */
+                if (bas + inv > k2) {
+                    hi = nlo;
+                    haut = bas + inv;
+                }
+                continue;
+            }
+        }
+        if (nhi < hi) {
+            code = robuste_trier(&r, courant, nhi, 0.0, 0, &inv, NULL, NULL);
+            if (code != 0) goto fin;
+            if (bas + inv > k2) {
+                hi = nhi;
+                haut = bas + inv;
+            } else if (bas + inv <= k1) {
+                lo = nhi;
+                bas += inv;
+                memcpy(courant, r.travail, n * sizeof(Element));
+            }
+        }
+    }
+
+    if (hi == nextafter(lo, INFINITY)) {
+        /* toutes les pentes restantes valent lo */
+        *a1 = lo;
+        npentes = 0;
+    } else {
+        code = robuste_trier(&r, courant, hi, 1.0, 0, &inv, &pentes, &npentes);
+        if (code != 0) goto fin;
+        *a1 = rangs_median(pentes, npentes, k1 - bas, k2 - bas);
+    }
+    code = ordonnee(&r, *a1, a0);
+    if (info) {
+        info->tours = tours;
+        info->calculs = npentes;
+    }
+
+fin:
+    free(pentes);
+    free(courant);
+    robuste_liberer(&r);
+    return code;
+}
+
+/* ===== Siegel ===== */
+
+typedef struct {
+    const Robuste *r;
+    const size_t *indices;
+    double *mediane;
+    int erreur;
+} MedianeCtx;
+
+/* Mediane des pentes du point indices[k] vers tous les points de x different */
+static void tache_mediane(void *ctx, size_t k) {
+    MedianeCtx *c = (MedianeCtx *)ctx;
+    const double *x = c->r->tri.x, *y = c->r->tri.y;
+    size_t n = c->r->tri.n, i = c->indices[k], j, m = 0;
+    double *v = (double *)malloc(n * sizeof(double));
+
+    if (!v) {
+        c->erreur = 1;
+        return;
+    }
+    for (j = 0; j < n; j++)
+        if (x[j] != x[i]) v[m++] = pente(x[i], y[i], x[j], y[j]);
+    c->mediane[k] = rangs_median(v, m, (m - 1) / 2, m / 2);
+    free(v);
+}
+
+static int medianes(const Robuste *r, const size_t *indices, size_t m, double *mediane) {
+    MedianeCtx c = { r, indices, mediane, 0 };
+
+    pool_executer(pool_defaut(), m, tache_mediane, &c);
+    return c.erreur ? -2 : 0;
+}
+
+/*
+ * Marque dans dessous[k] les actifs[k] dont la mediane interieure est
+ * < s et en retourne le nombre dans *nombre. Les points dont le compte
+ * tombe entre les deux pentes centrales (nombre pair de pentes) sont
+ * tranches par le calcul exact de leur mediane.
+ */
+static int classer(Robuste *r, size_t *compte, double s, const size_t *actifs, size_t nactifs,
+                   char *dessous, size_t *ambigus, double *mediane, size_t *nombre, size_t *calculs) {
+    size_t k, nambigus = 0, inv;
+    int code;
+
+    memset(compte, 0, r->tri.n * sizeof(size_t));
+    r->tri.compte = compte;
+    code = robuste_trier(r, r->ordre, s, 0.0, 0, &inv, NULL, NULL);
+    r->tri.compte = NULL;
+    if (code != 0) return code;
+
+    *nombre = 0;
+    for (k = 0; k < nactifs; k++) {
+        size_t i = actifs[k], m = r->tri.n - r->groupe[i];
+        if (compte[i] > m / 2) dessous[k] = 1;                 /* les deux pentes centrales < s */
+        else if (compte[i] <= (m - 1) / 2) dessous[k] = 0;     /* la pente centrale basse >= s */
+        else {
+            dessous[k] = 2;
+            ambigus[nambigus++] = i;
+        }
+    }
+    if (nambigus) {
+        size_t a = 0;
+        code = medianes(r, ambigus, nambigus, mediane);
+        if (code != 0) return code;
+        *calculs += nambigus;
+        for (k = 0; k < nactifs; k++)
+            if (dessous[k] == 2) dessous[k] = mediane[a++] < s;
+    }
+    for (k = 0; k < nactifs; k++) *nombre += dessous[k];
+    return 0;
+}
+
+/* Garde les actifs dont dessous[k] vaut garder */
+static size_t filtrer(size_t *actifs, size_t nactifs, const char *dessous, int garder) {
+    size_t k, m = 0;
+
+    for (k = 0; k < nactifs; k++)
+        if (dessous[k] == garder) actifs[m++] = actifs[k];
+    return m;
+}
+
+int robuste_siegel(const Points *pts, double *a0, double *a1, RobusteInfo *info) {
+    Robuste r;
+    size_t n = pts->n, *compte = NULL, *actifs = NULL, *ambigus = NULL, tirages[ROBUSTE_TIRAGES];
+    size_t nactifs = n, bas = 0, k1 = (n - 1) / 2, k2 = n / 2, k, nombre, calculs = 0;
+    size_t bas_avant = SIZE_MAX, nactifs_avant = SIZE_MAX;
+    double *mediane = NULL, lo = -INFINITY, hi = INFINITY;
+    char *dessous = NULL;
+    uint64_t graine = 1;
+    int code, tours = 0, vains = 0;
+
+    code = robuste_preparer(&r, pts, 1);
+    if (code != 0) return code;
+    compte = (size_t *)malloc(n * sizeof(size_t));
+    actifs = (size_t *)malloc(n * sizeof(size_t));
+    ambigus = (size_t *)malloc(n * sizeof(size_t));
+    mediane = (double *)malloc(n * sizeof(double));
+    dessous = (char *)malloc(n);
+    code = -2;
+    if (!compte || !actifs || !ambigus || !mediane || !dessous) goto fin;
+    for (k = 0; k < n; k++) actifs[k] = k;
+
+    /* invariant : actifs = points de mediane interieure dans [lo, hi), bas = nombre sous lo */
+    while (nactifs > 2 * ROBUSTE_TIRAGES && hi != nextafter(lo, INFINITY)) {
+        double nlo = lo, nhi = hi;
+
+        /* garde-fou : plus aucun point ecarte, on calcule les medianes restantes */
+        vains = bas == bas_avant && nactifs == nactifs_avant ? vains + 1 : 0;
+        if (vains >= TOURS_VAINS) break;
+        bas_avant = bas;
+        nactifs_avant = nactifs;
+        tours++;
+        for (k = 0; k < ROBUSTE_TIRAGES; k++) tirages[k] = actifs[alea_melange(graine++) % nactifs];
+        code = medianes(&r, tirages, ROBUSTE_TIRAGES, mediane);
+        if (code != 0) goto fin;
+        calculs += ROBUSTE_TIRAGES;
+        qsort(mediane, ROBUSTE_TIRAGES, sizeof(double), comparer);
+        fenetre(mediane, ROBUSTE_TIRAGES, (double)(k1 - bas), (double)(k2 - bas), (double)nactifs, &nlo, &nhi);
+
+        if (nlo > lo) {
+            code = classer(&r, compte, nlo, actifs, nactifs, dessous, ambigus, mediane, &nombre, &calculs);
+            if (code != 0) goto fin;
+            if (bas + nombre <= k1) {
+                lo = nlo;
+                bas += nombre;
+                nactifs = filtrer(actifs, nactifs, dessous, 0);
+            } else {
+                if (bas + nombre > k2) {
+                    hi = nlo;
+                    nactifs = filtrer(actifs, nactifs, dessous, 1);
+                }
+                continue;
+            }
+        }
+        if (nhi < hi) {
+            code = classer(&r, compte, nhi, actifs, nactifs, dessous, ambigus, mediane, &nombre, &calculs);
+            if (code != 0) goto fin;
+            if (bas + nombre > k2) {
+                hi = nhi;
+                nactifs = filtrer(actifs, nactifs, dessous, 1);
+            } else if (bas + nombre <= k1) {
+                lo = nhi;
+                bas += nombre;
+                nactifs = filtrer(actifs, nactifs, dessous, 0);
+            }
+        }
+    }
+
+    if (hi == nextafter(lo, INFINITY)) *a1 = lo;
+    else {
+        code = medianes(&r, actifs, nactifs, mediane);
+        if (code != 0) goto fin;
+        calculs += nactifs;
+        *a1 = rangs_median(mediane, nactifs, k1 - bas, k2 - bas);
+    }
+    code = ordonnee(&r, *a1, a0);
+    if (info) {
+        info->tours = tours;
+        info->calculs = calculs;
+    }
+
+fin:
+    free(compte);
+    free(actifs);
+    free(ambigus);
+    free(mediane);
+    free(dessous);
+    robuste_liberer(&r);
+    return code;
+}
@@ -0,0 +1,62 @@
+/*
+ * robuste.h
+ * Droites y = a0 + a1 x resistantes aux points aberrants :
+ *   Theil-Sen    a1 = mediane des pentes (yj - yi) / (xj - xi) de toutes
+ *                les paires de x distincts
+ *   Siegel       a1 = mediane sur i de la mediane sur j des memes pentes
+ *                (mediane repetee : resiste jusqu'a 50 % d'aberrants)
+ * et a0 = mediane des yi - a1 xi dans les deux cas.
+ *
+ * Aucune des n(n-1)/2 pentes n'est rangee. Trions les points selon
+ * u = y - s x (ex aequo : x puis y croissants) : une paire xi < xj change
+ * d'ordre entre les pentes s et s' > s exactement si s <= pente < s'. Le
+ * nombre de pentes dans [s, s') est donc le nombre d'inversions entre les
+ * deux ordres, compte par un tri fusion en O(n log n). Le meme tri tire au
+ * hasard des inversions (donc des pentes de l'intervalle) ou les
+ * enumere toutes. Quand deux cles sont trop proches pour que leur arrondi
+ * tranche, la pente de la paire, calculee comme par le calcul direct, est
+ * comparee a s : les comptes sont exacts meme avec beaucoup de pentes
+ * egales (donnees quantifiees), et le resultat est celui du calcul direct
+ * au bit pres (verif_robuste.c).
+ *
+ * Theil-Sen : on part de ]-inf, +inf[, on tire au plus ROBUSTE_ECHANTILLON
+ * pentes de l'intervalle, et les quantiles de l'echantillon autour du rang
+ * cherche donnent un intervalle plus etroit, verifie par deux comptages.
+ * Chaque tour divise le nombre de pentes par ~sqrt(echantillon) : quelques
+ * tours suffisent pour qu'il en reste moins de ROBUSTE_ENUMERATION * n,
+ * enumerees et selectionnees. O(n log n) en moyenne.
+ *
+ * Siegel : le tri compte aussi, pour chaque point, ses pentes inferieures
+ * a s, donc le nombre de medianes interieures sous s. Les medianes
+ * interieures de ROBUSTE_TIRAGES points tires parmi ceux encore possibles
+ * (O(n) chacune) resserrent de meme l'intervalle de la mediane exterieure.
+ * O(n log^2 n) en moyenne.
+ *
+ * Le tri fusion est reparti sur le pool (pool.h) en parts fixes ; les
+ * tirages ne dependent que de la part : le resultat ne depend pas du nombre
+ * de threads.
+ */
+
+#ifndef ROBUSTE_H
+#define ROBUSTE_H
+
+#include "points.h"
+
+#define ROBUSTE_BLOC 4096               /* points tries par tache au premier niveau */
+#define ROBUSTE_ECHANTILLON (1u << 20)  /* pentes tirees par tour, au plus */
+#define ROBUSTE_ENUMERATION 4           /* pentes enumerees a la fin, en multiples de n */
+#define ROBUSTE_TIRAGES 128             /* medianes interieures tirees par tour (Siegel) */
+
+typedef struct {
+    int tours;              /* tours de resserrement */
+    size_t calculs;         /* pentes enumerees (Theil-Sen) ou medianes interieures calculees (Siegel) */
+} RobusteInfo;
+
+/*
+ * Retournent 0 ; -1 si les x sont tous egaux (ou n < 2) ; -2 en cas
+ * d'allocation impossible. info peut etre NULL.
+ */
+int robuste_theil_sen(const Points *pts, double *a0, double *a1, RobusteInfo *info);
+int robuste_siegel(const Points *pts, double *a0, double *a1, RobusteInfo *info);
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * sgd.c
+ * Gradient stochastique en mini-lots pour a*exp(b x) (voir sgd.h).
+ */
+
+#include <math.h>
+#include "sgd.h"
+#include "expvec.h"
+#include "alea.h"
+
+/* Points rassembles par appel au noyau expvec */
+#define SGD_BLOC 256
+
+void sgd_options_defaut(SgdOptions *o) {
+    o->taille_lot = 256;
+    o->pas = 0.01;              /* celui de la descente de gauchy_exp.c */
+    o->tau = 1000.0;
+    o->exposant = 0.6;
+    o->max_epoques = 50;
+    o->tol = 1e-4;
+    o->melange = 1;
+    o->graine = 1;
+}
+
+void sgd_init(Sgd *s, double a, double b, const SgdOptions *o) {
+    s->opt = *o;
+    if (s->opt.taille_lot == 0) s->opt.taille_lot = 1;
+    s->a = a;
+    s->b = b;
+    s->pas_faits = 0;
+    s->rejetes = 0;
+    s->tirages = 0;
+    sgd_reprendre_moyenne(s);
+}
+
+uint64_t sgd_tirage(Sgd *s) {
+    return alea_melange(s->opt.graine ^ alea_melange(s->tirages++));
+}
+
+void sgd_reprendre_moyenne(Sgd *s) {
+    s->moy_a = s->a;
+    s->moy_b = s->b;
+    s->moyennes = 0;
+}
+
+void sgd_parametres(const Sgd *s, double *a, double *b) {
+    *a = s->moyennes ? s->moy_a : s->a;
+    *b = s->moyennes ? s->moy_b : s->b;
+}
+
+/* Pas a partir des sommes de expvec sur m points */
+static void pas_gradient(Sgd *s, const double sommes[3], size_t m) {
+    double ga = sommes[1] / (double)m, gb = sommes[2] / (double)m;
+    double eta;
+
+    if (!isfinite(ga) || !isfinite(gb)) {
+        s->rejetes++;
+        return;
+    }
+    eta = s->opt.pas / pow(1.0 + s->pas_faits / s->opt.tau, s->opt.exposant);
+    s->a -= eta * ga;
+    s->b -= eta * gb;
+    s->pas_faits++;
+
+    s->moyennes++;
+    s->moy_a += (s->a - s->moy_a) / (double)s->moyennes;
+    s->moy_b += (s->b - s->moy_b) / (double)s->moyennes;
+}
+
+void sgd_lot(Sgd *s, const double *x, const double *y, size_t m) {
+    double sommes[3];
+
+    if (m == 0) return;
+    expvec_sommes(x, y, m, s->a, s->b, sommes);
+    pas_gradient(s, sommes, m);
+}
+
+/*
+ * Permutation pseudo-aleatoire de [0, n) sans memoire : reseau de Feistel
+ * a quatre tours sur 2k bits (4^k >= n), dont on suit le cycle jusqu'a
+ * retomber dans [0, n) (moins de quatre tours de boucle en moyenne).
+ */
+static size_t permuter(size_t i, size_t n, int demi, uint64_t cle) {
+    uint64_t masque = (1ULL << demi) - 1, v = i;
+    int tour;
+
+    do {
+        uint64_t g = v >> demi, d = v & masque;
+        for (tour = 0; tour < 4; tour++) {
+            uint64_t t = d;
+            d = g ^ (alea_melange(d ^ (cle + (uint64_t)tour)) & masque);
+            g = t;
+        }
+        v = (g << demi) | d;
+    } while (v >= n);
+    return (size_t)v;
+}
+
+void sgd_epoque(Sgd *s, const Points *pts) {
+    double xs[SGD_BLOC], ys[SGD_BLOC];
+    uint64_t cle = sgd_tirage(s);
+    size_t n = pts->n, m = s->opt.taille_lot, debut;
+    int demi = 1;
+
+    while (demi < 32 && ((uint64_t)1 << (2 * demi)) < n) demi++;
+
+    for (debut = 0; debut < n; debut += m) {
+        size_t fin = debut + m < n ? debut + m : n;
+        double sommes[3] = { 0.0, 0.0, 0.0 };
+        size_t i, k;
+
+        if (!s->opt.melange) {
+            expvec_sommes(pts->xd + debut, pts->yd + debut, fin - debut, s->a, s->b, sommes);
+            pas_gradient(s, sommes, fin - debut);
+            continue;
+        }
+        /* lot rassemble par blocs pour le noyau vectorise */
+        for (i = debut; i < fin; i += SGD_BLOC) {
+            size_t nb = fin - i < SGD_BLOC ? fin - i : SGD_BLOC;
+            double t[3];
+            for (k = 0; k < nb; k++) {
+                size_t j = permuter(i + k, n, demi, cle);
+                xs[k] = pts->xd[j];
+                ys[k] = pts->yd[j];
+            }
+            expvec_sommes(xs, ys, nb, s->a, s->b, t);
+            sommes[0] += t[0];
+            sommes[1] += t[1];
+            sommes[2] += t[2];
+        }
+        pas_gradient(s, sommes, fin - debut);
+    }
+}
+
+SgdResultat sgd_exponentiel(const Points *pts, double a, double b, const SgdOptions *o) {
+    SgdResultat r = { a, b, 0.0, 0, 0, 0 };
+    double s3[3];
+    Sgd s;
+
+    sgd_init(&s, a, b, o);
+    if (pts->n == 0) return r;
+    while (r.epoques < o->max_epoques) {
+        double pa = r.a, pb = r.b;
+
+        sgd_reprendre_moyenne(&s);
+        sgd_epoque(&s, pts);
+        sgd_parametres(&s, &r.a, &r.b);
+        r.epoques++;
+        if (r.epoques > 1 && sqrt((r.a - pa) * (r.a - pa) + (r.b - pb) * (r.b - pb)) < o->tol) {
+            r.converge = 1;
+            break;
+        }
+    }
+    r.pas_faits = s.pas_faits;
+    expvec_sommes(pts->xd, pts->yd, pts->n, r.a, r.b, s3);
+    r.cout = s3[0] / (2.0 * pts->n);
+    return r;
+}
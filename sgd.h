@@ -0,0 +1,76 @@
+/*
+ * sgd.h
+ * Ajustement de f(x) = a * exp(b x) par gradient stochastique en
+ * mini-lots : chaque pas utilise le gradient moyen d'un lot de m points
+ * au lieu de tout le jeu, avec un pas decroissant
+ *   η_t = η0 / (1 + t/τ)^p      (1/2 < p < 1)
+ * et la moyenne de Polyak-Ruppert des iteres, qui annule l'essentiel du
+ * bruit des pas stochastiques.
+ *
+ * Hors ligne, une epoque parcourt les points dans un ordre pseudo-aleatoire
+ * different a chaque epoque (permutation calculee, sans tableau d'indices) ;
+ * la moyenne est reprise a chaque epoque et l'arret se fait quand deux
+ * moyennes d'epoques successives sont a moins de tol. En ligne, l'appelant
+ * fournit les lots au fil de l'arrivee des donnees (sgd_lot).
+ */
+
+#ifndef SGD_H
+#define SGD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "points.h"
+
+typedef struct {
+    size_t taille_lot;      /* m, points par pas */
+    double pas;             /* η0 */
+    double tau;             /* pas avant que η ne commence a decroitre */
+    double exposant;        /* p */
+    int max_epoques;
+    double tol;             /* ecart entre moyennes d'epoques successives */
+    int melange;            /* 0 : points dans l'ordre du stockage */
+    uint64_t graine;
+} SgdOptions;
+
+/* Etat d'un ajustement, utilisable en ligne */
+typedef struct {
+    SgdOptions opt;
+    double a, b;            /* itere courant */
+    double moy_a, moy_b;    /* moyenne des iteres depuis la derniere reprise */
+    long pas_faits;
+    long moyennes;          /* iteres dans la moyenne */
+    long rejetes;           /* lots au gradient non fini, ignores */
+    uint64_t tirages;       /* compteur du generateur */
+} Sgd;
+
+typedef struct {
+    double a, b;            /* moyenne de la derniere epoque */
+    double cout;            /* J = (1/2n) Σ r², une passe complete */
+    int epoques;
+    long pas_faits;
+    int converge;           /* 0 : max_epoques atteint */
+} SgdResultat;
+
+void sgd_options_defaut(SgdOptions *o);
+
+void sgd_init(Sgd *s, double a, double b, const SgdOptions *o);
+
+/* Un pas sur le lot (x, y) de m points */
+void sgd_lot(Sgd *s, const double *x, const double *y, size_t m);
+
+/* Recommence la moyenne de Polyak a partir de l'itere courant */
+void sgd_reprendre_moyenne(Sgd *s);
+
+/* Parametres estimes : la moyenne si elle existe, sinon l'itere */
+void sgd_parametres(const Sgd *s, double *a, double *b);
+
+/* Une epoque sur les points (double precision), en lots de taille_lot */
+void sgd_epoque(Sgd *s, const Points *pts);
+
+/* Entier pseudo-aleatoire de 64 bits (splitmix64 sur un compteur) */
+uint64_t sgd_tirage(Sgd *s);
+
+/* Ajustement hors ligne complet depuis (a, b) */
+SgdResultat sgd_exponentiel(const Points *pts, double a, double b, const SgdOptions *o);
+
+#endif
@@ -0,0 +1,308 @@
+/*
+ * solveurs.c
+ * Ajustements de la serie sur un jeu de points charge (voir solveurs.h).
+ */
+
+#include <math.h>
+#include <string.h>
+#include "solveurs.h"
+#include "moments.h"
+#include "lm.h"
+#include "sgd.h"
+#include "optim.h"
+#include "flux.h"
+#include "ajuste.h"
+#include "robuste.h"
+
+static const char *noms[SOLVEUR_NOMBRE] = { "moindres", "lineaire", "exp", "lm", "sgd", "theilsen", "siegel" };
+
+const char *solveur_nom(Solveur s) {
+    return noms[s];
+}
+
+int solveur_depuis_nom(const char *nom, Solveur *s) {
+    int k;
+
+    for (k = 0; k < SOLVEUR_NOMBRE; k++) {
+        if (strcmp(nom, noms[k]) == 0) {
+            *s = (Solveur)k;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+PointsType solveur_type(Solveur s) {
+    return s == SOLVEUR_LINEAIRE ? POINTS_FLOAT : POINTS_DOUBLE;
+}
+
+/* Descente du gradient sur les moments, parametres de gauchy.c (float) */
+static OptimResultat descente_lineaire(const Moments *m, float *a0, float *a1) {
+    OptimOptions opt;
+
+    optim_options_defaut(&opt, OPTIM_FIXE, 0.01, 0.0001, 10000);
+    opt.norme_max = 1;
+    *a0 = *a1 = 0.0f;
+    return ajuste_droitef_descente_moments(m, a0, a1, &opt);
+}
+
+/* ===== Donnees : points en memoire ou fichier lu par morceaux ===== */
+
+typedef struct {
+    const Points *pts;      /* en memoire : un seul morceau */
+    Flux *flux;
+    size_t n;
+    LectureCode code;       /* premiere erreur de lecture */
+} Source;
+
+static int parcourir(Source *src, FluxMorceau traiter, void *ctx) {
+    if (src->pts) traiter(ctx, src->pts);
+    else if (src->code == LECTURE_OK) src->code = flux_parcourir(src->flux, traiter, ctx);
+    return src->code == LECTURE_OK ? 0 : -1;
+}
+
+static void morceau_moments(void *ctx, const Points *morceau) {
+    moments_ajouter_points((Moments *)ctx, morceau);
+}
+
+typedef struct {
+    Moments m;
+    size_t utilises;
+} LogCtx;
+
+static void morceau_log(void *ctx, const Points *morceau) {
+    LogCtx *c = (LogCtx *)ctx;
+    c->utilises += moments_ajouter_log(&c->m, morceau);
+}
+
+/* Sommes de ajuste_exp (3 ou 6) sur un morceau, reparties sur le pool, cumulees */
+typedef struct {
+    double a, b;
+    int nsommes;
+    double s[6];
+} ExpCtx;
+
+static void morceau_exp(void *ctx, const Points *morceau) {
+    ExpCtx *c = (ExpCtx *)ctx;
+    double t[6];
+    int j;
+
+    ajuste_exp_sommes(morceau->xd, morceau->yd, morceau->n, c->a, c->b, c->nsommes, t);
+    for (j = 0; j < c->nsommes; j++) c->s[j] += t[j];
+}
+
+static int sommes_exp(Source *src, double a, double b, int nsommes, double *s) {
+    ExpCtx ctx;
+    int j;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.a = a;
+    ctx.b = b;
+    ctx.nsommes = nsommes;
+    if (parcourir(src, morceau_exp, &ctx) != 0) return -1;
+    for (j = 0; j < nsommes; j++) s[j] = ctx.s[j];
+    return 0;
+}
+
+/* Evaluateur de lm_minimiser : une passe par evaluation */
+static int evaluer_lm(void *ctx, double a, double b, double s[6]) {
+    Source *src = (Source *)ctx;
+    int j;
+
+    if (sommes_exp(src, a, b, 6, s) != 0) return -1;
+    for (j = 0; j < 6; j++) s[j] /= (double)src->n;
+    return 0;
+}
+
+/* Evaluateur de optim_minimiser : une passe par iteration */
+static int evaluer_exp(void *ctx, const double p[2], double *cout, double g[2]) {
+    Source *src = (Source *)ctx;
+    double s[3];
+
+    if (sommes_exp(src, p[0], p[1], 3, s) != 0) return -1;
+    *cout = s[0] / (2.0 * src->n);
+    g[0] = s[1] / (double)src->n;
+    g[1] = s[2] / (double)src->n;
+    return 0;
+}
+
+/* Descente du gradient pour a*exp(b x), parametres de gauchy_exp.c */
+static OptimResultat descente_exp(Source *src, double a, double b) {
+    OptimOptions opt;
+    double p[2] = { a, b };
+
+    optim_options_defaut(&opt, OPTIM_FIXE, 0.01, 0.001, 200000);
+    return optim_minimiser(evaluer_exp, src, p, &opt);
+}
+
+static void morceau_sgd(void *ctx, const Points *morceau) {
+    sgd_epoque((Sgd *)ctx, morceau);
+}
+
+/*
+ * Gradient stochastique, une passe par epoque ; retourne le nombre
+ * d'epoques terminees, *epuise = 1 si le budget l'a ete sans convergence
+ */
+static int epoques_sgd(Source *src, const SgdOptions *opt, double *a, double *b, int *epuise) {
+    Sgd s;
+    int faites = 0;
+
+    *epuise = 0;
+    sgd_init(&s, *a, *b, opt);
+    while (faites < opt->max_epoques) {
+        double pa = *a, pb = *b;
+
+        sgd_reprendre_moyenne(&s);
+        if (parcourir(src, morceau_sgd, &s) != 0) return faites;
+        sgd_parametres(&s, a, b);
+        faites++;
+        if (faites > 1 && sqrt((*a - pa) * (*a - pa) + (*b - pb) * (*b - pb)) < opt->tol) return faites;
+    }
+    *epuise = 1;
+    return faites;
+}
+
+/* Points d'un fichier lu par morceaux, recopies a la suite */
+typedef struct {
+    Points pts;
+    size_t utilises;
+} CopieCtx;
+
+static void morceau_copie(void *ctx, const Points *morceau) {
+    CopieCtx *c = (CopieCtx *)ctx;
+    size_t k = morceau->n;
+
+    if (c->utilises + k > c->pts.n) k = c->pts.n - c->utilises;
+    memcpy(c->pts.xd + c->utilises, morceau->xd, k * sizeof(double));
+    memcpy(c->pts.yd + c->utilises, morceau->yd, k * sizeof(double));
+    c->utilises += k;
+}
+
+/* Droite robuste (robuste.h) ; les points d'un flux sont d'abord charges */
+static void ajuster_robuste(Solveur s, Source *src, Ajustement *r) {
+    CopieCtx copie;
+    const Points *pts = src->pts;
+    RobusteInfo info;
+    Moments m;
+    int code;
+
+    if (!pts) {
+        if (points_alloc(&copie.pts, src->n, POINTS_DOUBLE) != 0) {
+            r->statut = "memoire insuffisante";
+            return;
+        }
+        copie.utilises = 0;
+        if (parcourir(src, morceau_copie, &copie) != 0) {
+            points_free(&copie.pts);
+            return;
+        }
+        copie.pts.n = copie.utilises;
+        pts = &copie.pts;
+    }
+    code = s == SOLVEUR_THEILSEN ? robuste_theil_sen(pts, &r->p0, &r->p1, &info)
+                                 : robuste_siegel(pts, &r->p0, &r->p1, &info);
+    r->passes = 1;
+    if (code == 0) {
+        r->iterations = info.tours;
+        moments_init(&m);
+        moments_ajouter_points(&m, pts);
+        r->cout = moments_cout(&m, r->p0, r->p1);
+    } else r->statut = code == -1 ? "x constants" : "memoire insuffisante";
+    if (pts != src->pts) points_free(&copie.pts);
+}
+
+static Ajustement ajuster(Solveur s, Source *src, int init_log) {
+    Ajustement r = { 0.0, 0.0, 0.0, 0, 0, "ok" };
+    Moments m;
+
+    if (src->n == 0) {
+        r.statut = "aucun point";
+        return r;
+    }
+
+    switch (s) {
+        case SOLVEUR_MOINDRES:
+        case SOLVEUR_LINEAIRE:
+            moments_init(&m);
+            parcourir(src, morceau_moments, &m);
+            r.passes = 1;
+            if (src->code != LECTURE_OK) break;
+            if (s == SOLVEUR_MOINDRES) {
+                if (moments_droite(&m, &r.p0, &r.p1) != 0) r.statut = "x constants";
+            } else {
+                float a0, a1;
+                OptimResultat d = descente_lineaire(&m, &a0, &a1);
+                r.p0 = a0;
+                r.p1 = a1;
+                r.iterations = d.iterations;
+                if (d.raison != OPTIM_CONVERGE) r.statut = optim_raison(d.raison);
+            }
+            r.cout = moments_cout(&m, r.p0, r.p1);
+            break;
+
+        case SOLVEUR_EXP:
+        case SOLVEUR_LM:
+        case SOLVEUR_SGD:
+            r.p0 = 1.0;
+            r.p1 = 0.1;
+            if (init_log) {
+                LogCtx c;
+                moments_init(&c.m);
+                c.utilises = 0;
+                if (parcourir(src, morceau_log, &c) != 0) break;
+                moments_vers_exponentielle(&c.m, c.utilises, &r.p0, &r.p1);
+                r.passes = 1;
+            }
+            if (s == SOLVEUR_EXP) {
+                OptimResultat d = descente_exp(src, r.p0, r.p1);
+                r.p0 = d.p[0];
+                r.p1 = d.p[1];
+                r.cout = d.cout;
+                r.iterations = d.iterations;
+                r.passes += d.evaluations;
+                if (d.raison == OPTIM_ECHEC) break;
+                if (d.raison != OPTIM_CONVERGE) r.statut = optim_raison(d.raison);
+            } else if (s == SOLVEUR_SGD) {
+                SgdOptions opt;
+                double t[3];
+                int epuise;
+                sgd_options_defaut(&opt);
+                r.iterations = epoques_sgd(src, &opt, &r.p0, &r.p1, &epuise);
+                r.passes += r.iterations;
+                if (sommes_exp(src, r.p0, r.p1, 3, t) != 0) break;
+                r.cout = t[0] / (2.0 * src->n);
+                r.passes++;             /* passe du cout final */
+                if (epuise) r.statut = "maximum d'iterations";
+            } else {
+                LmOptions opt;
+                LmResultat res;
+                lm_options_defaut(&opt);
+                res = lm_minimiser(evaluer_lm, src, r.p0, r.p1, &opt);
+                r.p0 = res.a;
+                r.p1 = res.b;
+                r.cout = res.cout;
+                r.iterations = res.iterations;
+                r.passes += res.evaluations;
+                if (res.raison == LM_MAX_ITERATIONS || res.raison == LM_STAGNATION)
+                    r.statut = lm_raison(res.raison);
+            }
+            break;
+
+        case SOLVEUR_THEILSEN:
+        case SOLVEUR_SIEGEL:
+            ajuster_robuste(s, src, &r);
+            break;
+    }
+    if (src->code != LECTURE_OK) r.statut = lecture_message(src->code);
+    return r;
+}
+
+Ajustement solveur_ajuster(Solveur s, const Points *pts, int init_log) {
+    Source src = { pts, NULL, pts->n, LECTURE_OK };
+    return ajuster(s, &src, init_log);
+}
+
+Ajustement solveur_ajuster_flux(Solveur s, Flux *flux, int init_log) {
+    Source src = { NULL, flux, flux_n(flux), LECTURE_OK };
+    return ajuster(s, &src, init_log);
+}
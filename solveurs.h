@@ -0,0 +1,56 @@
+/*
+ * solveurs.h
+ * Les ajustements des programmes de la serie, appelables sur un jeu de
+ * points deja charge (traitement par lot, banc de mesure) :
+ *   moindres   droite des moindres carres (moinCarre.c)
+ *   lineaire   droite par descente du gradient sur les moments (gauchy.c)
+ *   exp        a*exp(b x) par descente du gradient (gauchy_exp.c, gradient.c)
+ *   lm         a*exp(b x) par Levenberg-Marquardt (lm.c)
+ *   sgd        a*exp(b x) par gradient stochastique en mini-lots (sgd.c)
+ *   theilsen   droite de Theil-Sen, mediane des pentes (robuste.h)
+ *   siegel     droite de Siegel, mediane repetee des pentes (robuste.h)
+ * avec les parametres et criteres d'arret de ces programmes.
+ */
+
+#ifndef SOLVEURS_H
+#define SOLVEURS_H
+
+#include "points.h"
+#include "flux.h"
+
+typedef enum {
+    SOLVEUR_MOINDRES, SOLVEUR_LINEAIRE, SOLVEUR_EXP, SOLVEUR_LM, SOLVEUR_SGD, SOLVEUR_THEILSEN, SOLVEUR_SIEGEL
+} Solveur;
+
+#define SOLVEUR_NOMBRE 7
+
+typedef struct {
+    double p0, p1;          /* (a0, a1) pour une droite, (a, b) pour l'exponentielle */
+    double cout;            /* J = (1/2n) Σ r² */
+    int iterations;
+    int passes;             /* passes sur les donnees */
+    const char *statut;     /* "ok" ou cause de l'echec */
+} Ajustement;
+
+const char *solveur_nom(Solveur s);
+
+/* Retourne 0 et remplit *s si nom designe un solveur, -1 sinon */
+int solveur_depuis_nom(const char *nom, Solveur *s);
+
+/* Precision de chargement attendue par le solveur */
+PointsType solveur_type(Solveur s);
+
+/* init_log : depart log-lineaire (moments_exponentielle) pour exp, lm et sgd */
+Ajustement solveur_ajuster(Solveur s, const Points *pts, int init_log);
+
+/*
+ * Idem sur un fichier lu par morceaux (flux.h) : une passe pour les
+ * droites (moments), une passe par iteration pour exp, une par
+ * evaluation pour lm, une par epoque pour sgd (ordre melange a
+ * l'interieur de chaque morceau). theilsen et siegel ont besoin de tous
+ * les points : le fichier est charge en une passe. Une erreur de lecture
+ * est rapportee dans statut.
+ */
+Ajustement solveur_ajuster_flux(Solveur s, Flux *flux, int init_log);
+
+#endif
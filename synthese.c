@@ -0,0 +1,73 @@
+/*
+ * synthese.c
+ * Generation de donnees synthetiques (voir synthese.h).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "synthese.h"
+#include "points.h"
+#include "binaire.h"
+#include "alea.h"
+#include "ecriture.h"
+
+#define DEUX_PI 6.283185307179586
+
+void synthese_defaut(Synthese *s, SyntheseModele modele) {
+    s->modele = modele;
+    if (modele == SYNTHESE_LINEAIRE) {
+        s->p0 = 0.2;
+        s->p1 = 0.025;
+        s->bruit = 0.05;
+    } else {
+        s->p0 = 0.3;
+        s->p1 = 0.2;
+        s->bruit = 0.02;
+    }
+    s->xmin = 0.0;
+    s->xmax = 10.0;
+    s->aberrants = 0.0;
+    s->amplitude = 1.0;
+    s->graine = 1;
+}
+
+void synthese_point(const Synthese *s, size_t i, double *x, double *y) {
+    /* quatre tirages independants par point : x, deux pour Box-Muller, aberrant */
+    uint64_t base = alea_melange(s->graine) ^ ((uint64_t)i << 2);
+    double u0 = alea_uniforme(alea_melange(base));
+    double u1 = alea_uniforme(alea_melange(base + 1));
+    double u2 = alea_uniforme(alea_melange(base + 2));
+    double u3 = alea_uniforme(alea_melange(base + 3));
+    double xv = s->xmin + (s->xmax - s->xmin) * u0;
+    double yv = s->modele == SYNTHESE_LINEAIRE ? s->p0 + s->p1 * xv : s->p0 * exp(s->p1 * xv);
+
+    yv += s->bruit * sqrt(-2.0 * log(u1)) * cos(DEUX_PI * u2);
+    if (u3 < s->aberrants) yv += s->amplitude * (2.0 * (u3 / s->aberrants) - 1.0);
+    *x = xv;
+    *y = yv;
+}
+
+int synthese_ecrire(const Synthese *s, size_t n, const char *fichier) {
+    Ecriture e;
+    size_t i;
+
+    if (ecriture_ouvrir(&e, fichier, 0) != 0) return -1;
+    ecriture_format(&e, "%zu\n", n);
+    for (i = 0; i < n; i++) {
+        double v[2];
+        synthese_point(s, i, &v[0], &v[1]);
+        ecriture_ligne(&e, v, 2, ", ", 6);
+    }
+    return ecriture_fermer(&e);
+}
+
+int synthese_ecrire_binaire(const Synthese *s, size_t n, const char *fichier) {
+    Points pts;
+    size_t i;
+
+    if (binaire_creer(fichier, n, POINTS_DOUBLE, &pts) != 0) return -1;
+    for (i = 0; i < n; i++) synthese_point(s, i, &pts.xd[i], &pts.yd[i]);
+    points_free(&pts);
+    return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * synthese.h
+ * Jeux de donnees synthetiques reproductibles pour les mesures :
+ * droite y = p0 + p1 x ou exponentielle y = p0 e^{p1 x}, x uniforme sur
+ * [xmin, xmax], bruit gaussien d'ecart-type bruit, et une proportion de
+ * points aberrants decales de ±amplitude.
+ *
+ * Le point i ne depend que de (graine, i) (generateur a compteur
+ * splitmix64) : un fichier de 10^8 points s'ecrit sans etre stocke, et
+ * ses n premiers points sont ceux de tout fichier plus grand.
+ */
+
+#ifndef SYNTHESE_H
+#define SYNTHESE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum { SYNTHESE_LINEAIRE, SYNTHESE_EXP } SyntheseModele;
+
+typedef struct {
+    SyntheseModele modele;
+    double p0, p1;          /* parametres vrais */
+    double xmin, xmax;
+    double bruit;           /* ecart-type du bruit gaussien */
+    double aberrants;       /* proportion de points aberrants, dans [0, 1] */
+    double amplitude;       /* decalage maximal d'un point aberrant */
+    uint64_t graine;
+} Synthese;
+
+/* Parametres par defaut du modele (ceux de donnees.txt a peu pres) */
+void synthese_defaut(Synthese *s, SyntheseModele modele);
+
+/* Point numero i */
+void synthese_point(const Synthese *s, size_t i, double *x, double *y);
+
+/* Ecrit n points au format de donnees.txt. Retourne 0, ou -1 en cas d'erreur d'ecriture. */
+int synthese_ecrire(const Synthese *s, size_t n, const char *fichier);
+
+/* Idem au format binaire en colonnes (binaire.h), rempli dans la projection du fichier */
+int synthese_ecrire_binaire(const Synthese *s, size_t n, const char *fichier);
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ * trace.c
+ * Tampon circulaire et fichier binaire de la trace de convergence
+ * (voir trace.h).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "trace.h"
+
+static uint64_t maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+int trace_ouvrir(Trace *t, size_t capacite, long pas, const char *fichier, const char *solveur) {
+    memset(t, 0, sizeof(*t));
+    if (capacite == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    t->tampon = malloc(capacite * sizeof(*t->tampon));
+    if (!t->tampon) return -1;
+    t->capacite = capacite;
+    t->pas = pas < 1 ? 1 : pas;
+
+    if (fichier) {
+        TraceEntete e;
+
+        t->fichier = fopen(fichier, "wb");
+        if (!t->fichier) {
+            free(t->tampon);
+            t->tampon = NULL;
+            return -1;
+        }
+        memset(&e, 0, sizeof(e));
+        memcpy(e.magie, TRACE_MAGIE, sizeof(e.magie));
+        e.boutisme = TRACE_BOUTISME;
+        e.taille = sizeof(TraceEnregistrement);
+        e.pas = (uint64_t)t->pas;
+        if (solveur) strncpy(e.solveur, solveur, sizeof(e.solveur) - 1);
+        if (fwrite(&e, sizeof(e), 1, t->fichier) != 1) t->erreur = 1;
+    }
+    t->origine = maintenant();
+    return 0;
+}
+
+int trace_env(Trace *t, const char *solveur) {
+    const char *fichier = getenv("REGRESSION_TRACE");
+    const char *pas = getenv("REGRESSION_TRACE_PAS");
+
+    if (!fichier || !*fichier) return 0;
+    if (trace_ouvrir(t, TRACE_CAPACITE, pas ? strtol(pas, NULL, 10) : 1, fichier, solveur) != 0) return -1;
+    return 1;
+}
+
+/* Ecrit le tampon d'un bloc (il ne fait jamais le tour avec un fichier) */
+static void vider(Trace *t) {
+    if (t->nombre > 0 && fwrite(t->tampon, sizeof(*t->tampon), t->nombre, t->fichier) != t->nombre)
+        t->erreur = 1;
+    t->debut = 0;
+    t->nombre = 0;
+}
+
+void trace_ajouter(Trace *t, long iteration, const double p[2], double cout, double norme_gradient, double pas) {
+    TraceEnregistrement *e;
+
+    if (t->nombre == t->capacite) {
+        if (t->fichier) {
+            vider(t);
+        } else {
+            /* le plus ancien est remplace */
+            t->debut = (t->debut + 1) % t->capacite;
+            t->nombre--;
+        }
+    }
+    e = &t->tampon[(t->debut + t->nombre) % t->capacite];
+    e->ns = maintenant() - t->origine;
+    e->iteration = iteration;
+    e->p[0] = p[0];
+    e->p[1] = p[1];
+    e->cout = cout;
+    e->norme_gradient = norme_gradient;
+    e->pas = pas;
+    t->nombre++;
+    t->total++;
+}
+
+int trace_fermer(Trace *t) {
+    int erreur;
+
+    if (t->fichier) {
+        vider(t);
+        if (fclose(t->fichier) != 0) t->erreur = 1;
+    }
+    erreur = t->erreur;
+    free(t->tampon);
+    memset(t, 0, sizeof(*t));
+    return erreur ? -1 : 0;
+}
+
+void trace_ecrire_ligne(FILE *f, const TraceEnregistrement *e) {
+    fprintf(f, "%8lld  %12.6f  %12.6f  %12.6f  %12.6e  %12.6e  %10.4g\n",
+            (long long)e->iteration, (double)e->ns * 1e-9, e->p[0], e->p[1],
+            e->cout, e->norme_gradient, e->pas);
+}
+
+void trace_ecrire_texte(const Trace *t, FILE *f) {
+    size_t k;
+
+    for (k = 0; k < t->nombre; k++) trace_ecrire_ligne(f, &t->tampon[(t->debut + k) % t->capacite]);
+}
@@ -0,0 +1,105 @@
+/*
+ * trace.h
+ * Trace de convergence des solveurs sans affichage dans la boucle : un
+ * enregistrement (iteration, parametres, cout, norme du gradient, pas,
+ * instant) toutes les `pas` iterations, copie dans un tampon circulaire
+ * alloue une fois pour toutes.
+ *   - avec un fichier, le tampon plein est ecrit d'un bloc (fwrite) et
+ *     la trace est complete ;
+ *   - sans fichier, le tampon garde les `capacite` derniers
+ *     enregistrements, a lire par trace_ecrire_texte.
+ * Un solveur sans trace (pointeur NULL) ne paie qu'un test par iteration ;
+ * compile avec -DTRACE_DESACTIVEE, trace_enregistrer disparait.
+ *
+ * Fichier binaire : TraceEntete puis les TraceEnregistrement bruts, dans
+ * l'ordre des octets de la machine ; trace_dump.c les relit en texte.
+ * L'instant est en nanosecondes depuis trace_ouvrir (horloge monotone).
+ *
+ * Les programmes ouvrent la trace par trace_env : REGRESSION_TRACE=fichier
+ * et REGRESSION_TRACE_PAS=N (defaut 1).
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define TRACE_MAGIE "TRACECV1"
+#define TRACE_BOUTISME 0x01020304u
+#define TRACE_CAPACITE 4096     /* enregistrements par ecriture */
+
+typedef struct {
+    uint64_t ns;            /* instant depuis trace_ouvrir */
+    int64_t iteration;
+    double p[2];
+    double cout;
+    double norme_gradient;
+    double pas;             /* η des descentes, λ de Levenberg-Marquardt */
+} TraceEnregistrement;
+
+typedef struct {
+    char magie[8];          /* TRACE_MAGIE, sans zero final */
+    uint32_t boutisme;      /* TRACE_BOUTISME tel qu'ecrit */
+    uint32_t taille;        /* sizeof(TraceEnregistrement) */
+    uint64_t pas;
+    char solveur[16];       /* nom du solveur, termine par un zero */
+} TraceEntete;
+
+typedef struct {
+    TraceEnregistrement *tampon;
+    size_t capacite;
+    size_t debut, nombre;   /* enregistrements presents dans le tampon */
+    uint64_t total;         /* enregistrements depuis l'ouverture */
+    int64_t pas;
+    uint64_t origine;       /* instant d'ouverture */
+    FILE *fichier;          /* NULL : tampon circulaire seul */
+    int erreur;             /* ecriture echouee */
+} Trace;
+
+/*
+ * Alloue le tampon et, si fichier n'est pas NULL, cree le fichier et
+ * ecrit l'entete. pas < 1 vaut 1. Retourne 0, ou -1 (errno renseigne).
+ */
+int trace_ouvrir(Trace *t, size_t capacite, long pas, const char *fichier, const char *solveur);
+
+/*
+ * Ouvre la trace demandee par REGRESSION_TRACE. Retourne 1 si elle est
+ * ouverte, 0 si la variable est absente ou vide, -1 en cas d'erreur.
+ */
+int trace_env(Trace *t, const char *solveur);
+
+/* Vide le tampon dans le fichier et le ferme. Retourne 0, ou -1 si une ecriture a echoue. */
+int trace_fermer(Trace *t);
+
+/* Ajoute un enregistrement (appele par trace_enregistrer) */
+void trace_ajouter(Trace *t, long iteration, const double p[2], double cout, double norme_gradient, double pas);
+
+/* Enregistre l'iteration si t n'est pas NULL et si elle tombe sur le pas */
+static inline void trace_enregistrer(Trace *t, long iteration, const double p[2], double cout,
+                                     double norme_gradient, double pas) {
+#ifndef TRACE_DESACTIVEE
+    if (t && iteration % t->pas == 0) trace_ajouter(t, iteration, p, cout, norme_gradient, pas);
+#else
+    (void)t; (void)iteration; (void)p; (void)cout; (void)norme_gradient; (void)pas;
+#endif
+}
+
+/* Point d'arret : enregistre meme hors du pas (s'il ne l'a pas deja ete) */
+static inline void trace_terminer(Trace *t, long iteration, const double p[2], double cout,
+                                  double norme_gradient, double pas) {
+#ifndef TRACE_DESACTIVEE
+    if (t && iteration % t->pas != 0) trace_ajouter(t, iteration, p, cout, norme_gradient, pas);
+#else
+    (void)t; (void)iteration; (void)p; (void)cout; (void)norme_gradient; (void)pas;
+#endif
+}
+
+/* Une ligne par enregistrement : iteration, temps (s), a, b, cout, |∇J|, pas */
+void trace_ecrire_ligne(FILE *f, const TraceEnregistrement *e);
+
+/* Enregistrements du tampon, du plus ancien au plus recent */
+void trace_ecrire_texte(const Trace *t, FILE *f);
+
+#endif
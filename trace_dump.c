@@ -0,0 +1,89 @@
+/*
+ * trace_dump.c
+ * Relecture d'une trace de convergence binaire (trace.h) en texte.
+ *
+ * Usage : ./trace_dump trace.bin [pas]
+ *   une ligne par enregistrement (un sur `pas`, defaut 1), puis un resume :
+ *   duree, iterations par seconde, et instant ou le cout passe pour la
+ *   premiere fois sous 1 + 1e-3, 1e-6 fois le cout final
+ *
+ * Compilation : gcc -O2 trace_dump.c trace.c -o trace_dump
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+static void error_and_exit(const char *msg) {
+    fprintf(stderr, "%s\n", msg);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+    static const double seuils[2] = { 1e-3, 1e-6 };
+    TraceEntete e;
+    TraceEnregistrement r, premier, dernier;
+    TraceEnregistrement *tous = NULL;
+    size_t n = 0, capacite = 0, k;
+    long pas = 1;
+    FILE *f;
+
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Usage : %s trace.bin [pas]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc == 3 && (pas = strtol(argv[2], NULL, 10)) < 1) error_and_exit("pas >= 1 attendu");
+
+    f = fopen(argv[1], "rb");
+    if (!f) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+    if (fread(&e, sizeof(e), 1, f) != 1 || memcmp(e.magie, TRACE_MAGIE, sizeof(e.magie)) != 0)
+        error_and_exit("Pas une trace de convergence");
+    if (e.boutisme != TRACE_BOUTISME || e.taille != sizeof(TraceEnregistrement))
+        error_and_exit("Trace ecrite sur une autre architecture");
+    e.solveur[sizeof(e.solveur) - 1] = '\0';
+
+    /* les enregistrements sont gardes pour le resume (cout final connu a la fin) */
+    while (fread(&r, sizeof(r), 1, f) == 1) {
+        if (n == capacite) {
+            TraceEnregistrement *t;
+            capacite = capacite ? 2 * capacite : 1024;
+            t = realloc(tous, capacite * sizeof(*tous));
+            if (!t) error_and_exit("Allocation echouee");
+            tous = t;
+        }
+        tous[n++] = r;
+    }
+    if (ferror(f)) error_and_exit("Erreur de lecture");
+    fclose(f);
+
+    printf("# solveur %s, une iteration sur %llu enregistree, %zu enregistrements\n",
+           e.solveur, (unsigned long long)e.pas, n);
+    printf("# iteration     temps (s)             a             b          cout         |grad|         pas\n");
+    for (k = 0; k < n; k += (size_t)pas) trace_ecrire_ligne(stdout, &tous[k]);
+    if (n == 0) {
+        free(tous);
+        return EXIT_SUCCESS;
+    }
+
+    premier = tous[0];
+    dernier = tous[n - 1];
+    printf("# duree %.6f s", (double)(dernier.ns - premier.ns) * 1e-9);
+    if (dernier.ns > premier.ns)
+        printf(", %.0f iterations/s", (double)(dernier.iteration - premier.iteration) * 1e9
+                                      / (double)(dernier.ns - premier.ns));
+    printf("\n");
+    for (int s = 0; s < 2; s++) {
+        double cible = dernier.cout * (1.0 + seuils[s]);
+        for (k = 0; k < n && !(tous[k].cout <= cible); k++) {}
+        if (k == n) continue;       /* cout final non fini */
+        printf("# cout <= final x (1 + %g) : iteration %lld, %.6f s\n", seuils[s],
+               (long long)tous[k].iteration, (double)tous[k].ns * 1e-9);
+    }
+
+    free(tous);
+    return EXIT_SUCCESS;
+}
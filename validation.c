@@ -0,0 +1,109 @@
+/*
+ * validation.c
+ * Choix entre la droite des moindres carres (moinCarre.c) et
+ * a * exp(b x) (gradient.c) par validation croisee (croisee.h) : chaque
+ * point est predit par le modele ajuste sans son pli, et le modele de
+ * plus faible RMSE hors echantillon est retenu.
+ *
+ * Usage : ./validation [k|loo] [graine=S] [fichier]
+ *   k       : nombre de plis, 2 a n (defaut 10)
+ *   loo     : leave-one-out (un pli par point ; O(n²) pour l'exponentielle)
+ *   graine  : tirage des plis (defaut 1)
+ *   fichier : defaut donnees.txt
+ * L'exponentielle est ajustee sur toutes les donnees par Levenberg-Marquardt
+ * depuis la droite de ln y (moments_exponentielle), sinon depuis (1.0, 0.1),
+ * puis chaque pli depuis cette solution.
+ *
+ * Compilation : gcc -O2 validation.c croisee.c points.c lecture.c pool.c moments.c expvec.c lm.c trace.c -o validation -lm -pthread
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "points.h"
+#include "lecture.h"
+#include "pool.h"
+#include "moments.h"
+#include "lm.h"
+#include "croisee.h"
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void afficher(const char *modele, int code, const CroiseeResultat *r, double duree) {
+    if (code != 0) {
+        printf("%-14s %s\n", modele, code == -2 ? "memoire insuffisante" : "ajustement impossible");
+        return;
+    }
+    printf("%-14s %16.9g %16.9g %8zu %10.3f\n", modele, r->rmse, r->rmse_ajustement, r->echecs, duree);
+}
+
+int main(int argc, char **argv) {
+    const char *fichier = "donnees.txt";
+    size_t plis = CROISEE_PLIS;
+    uint64_t graine = 1;
+    int j, code_droite, code_exp;
+    Points pts;
+    LectureInfo info;
+    LectureCode lecture;
+    LmOptions opt;
+    LmResultat lm;
+    CroiseeResultat droite, expo;
+    double a = 1.0, b = 0.1, debut, duree_droite, duree_exp;
+
+    for (j = 1; j < argc; j++) {
+        if (strcmp(argv[j], "loo") == 0) plis = 0;
+        else if (strncmp(argv[j], "graine=", 7) == 0) graine = strtoull(argv[j] + 7, NULL, 10);
+        else if (isdigit((unsigned char)argv[j][0])) plis = (size_t)atol(argv[j]);
+        else if (argv[j][0] != '-') fichier = argv[j];
+        else {
+            fprintf(stderr, "Usage : %s [k|loo] [graine=S] [fichier]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    lecture = lecture_points(fichier, &pts, POINTS_DOUBLE, &info);
+    if (lecture != LECTURE_OK) {
+        fprintf(stderr, "%s : %s (ligne %zu)\n", fichier, lecture_message(lecture), info.ligne);
+        return EXIT_FAILURE;
+    }
+    if (plis == 1 || plis > pts.n || pts.n < 3) {
+        fprintf(stderr, "Plis : 2 a %zu (au moins 3 points)\n", pts.n);
+        points_free(&pts);
+        return EXIT_FAILURE;
+    }
+
+    debut = maintenant();
+    code_droite = croisee_droite(&pts, plis, graine, &droite);
+    duree_droite = maintenant() - debut;
+
+    debut = maintenant();
+    moments_exponentielle(&pts, &a, &b);
+    lm_options_defaut(&opt);
+    lm = lm_exponentiel(&pts, a, b, &opt);
+    code_exp = croisee_exponentiel(&pts, lm.a, lm.b, plis, graine, &expo);
+    duree_exp = maintenant() - debut;
+
+    if (plis) printf("Validation croisee: %zu points, %zu plis, %d threads\n", pts.n, plis, pool_threads(pool_defaut()));
+    else printf("Validation croisee: %zu points, leave-one-out, %d threads\n", pts.n, pool_threads(pool_defaut()));
+    printf("Exponentielle sur toutes les donnees: a = %.6f, b = %.6f (%s)\n\n", lm.a, lm.b, lm_raison(lm.raison));
+    printf("%-14s %16s %16s %8s %10s\n", "Modele", "RMSE hors ech.", "RMSE ajust.", "echecs", "temps (s)");
+    afficher("droite", code_droite, &droite, duree_droite);
+    afficher("exponentielle", code_exp, &expo, duree_exp);
+    if (code_exp == 0)
+        printf("Evaluations (exponentielle): %ld, %.1f par pli\n", expo.evaluations,
+               (double)expo.evaluations / (double)expo.plis);
+
+    if (code_droite == 0 && code_exp == 0)
+        printf("\nModele retenu: %s\n", droite.rmse <= expo.rmse ? "droite" : "exponentielle");
+
+    points_free(&pts);
+    return code_droite == 0 || code_exp == 0 ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,113 @@
+/*
+ * verif_expvec.c
+ * Verification des chemins vectorises de expvec.h contre le chemin
+ * scalaire sur les valeurs limites : NaN, ±inf, arguments hors des bornes
+ * [-708.39, 709.43] (double) et [-87.33, 88.37] (float). Chaque valeur est
+ * placee tour a tour a toutes les positions d'un tableau, pour passer par
+ * le corps vectoriel comme par la fin scalaire. NaN doit rester NaN (et
+ * rendre les sommes NaN) ; les autres resultats doivent concorder a
+ * l'arrondi pres (l'ordre des sommes differe d'un chemin a l'autre).
+ *
+ * Usage : ./verif_expvec
+ * Retourne 1 si un chemin differe du chemin scalaire.
+ *
+ * Compilation : gcc -O2 verif_expvec.c expvec.c -o verif_expvec -lm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "expvec.h"
+
+#define TAILLE 37                   /* corps vectoriel et fin scalaire pour toutes les largeurs */
+
+static const char *chemins[] = { "sse2", "avx2", "avx512" };
+
+static const double limites[] = {
+    NAN, INFINITY, -INFINITY, 709.43, 709.44, 710.0, 1000.0, -708.39, -708.4, -745.0, -1000.0, 0.0, 1.0,
+};
+
+static const float limitesf[] = {
+    NAN, INFINITY, -INFINITY, 88.37f, 88.38f, 89.0f, 1000.0f, -87.33f, -87.34f, -104.0f, -1000.0f, 0.0f, 1.0f,
+};
+
+/* Meme NaN, meme infini, ou ecart relatif sous tol */
+static int concorde(double u, double v, double tol) {
+    if (isnan(u) || isnan(v)) return isnan(u) && isnan(v);
+    if (isinf(u) || isinf(v)) return u == v;
+    return fabs(u - v) <= tol * fabs(v);
+}
+
+/* Resultats d'un chemin pour la valeur v a la position k */
+typedef struct {
+    double e[TAILLE];
+    double s[3];
+    double sf[3];
+} Resultats;
+
+static void calculer(double v, float vf, int k, Resultats *r) {
+    double x[TAILLE], y[TAILLE];
+    float xf[TAILLE], yf[TAILLE];
+    int i;
+
+    for (i = 0; i < TAILLE; i++) {
+        x[i] = 0.01 * i;
+        y[i] = 1.0 + 0.02 * i;
+        xf[i] = (float)x[i];
+        yf[i] = (float)y[i];
+    }
+    x[k] = v;
+    xf[k] = vf;
+    expvec_exp(x, r->e, TAILLE);
+    expvec_sommes(x, y, TAILLE, 1.0, 1.0, r->s);
+    expvec_sommesf(xf, yf, TAILLE, 1.0f, 1.0f, r->sf);
+}
+
+/* Compare le chemin courant a la reference ; retourne le nombre d'ecarts */
+static int comparer(const char *chemin, int l, int k, const Resultats *ref, const Resultats *r) {
+    int i, ecarts = 0;
+
+    for (i = 0; i < TAILLE; i++) {
+        if (!concorde(r->e[i], ref->e[i], 4e-16)) ecarts++;
+    }
+    if (isnan(limites[l]) && !isnan(r->e[k])) ecarts++;
+    for (i = 0; i < 3; i++) {
+        if (!concorde(r->s[i], ref->s[i], 1e-12)) ecarts++;
+        if (!concorde(r->sf[i], ref->sf[i], 1e-5)) ecarts++;
+        if (isnan(limites[l]) && (!isnan(r->s[i]) || !isnan(r->sf[i]))) ecarts++;
+    }
+    if (ecarts) {
+        printf("ECHEC %-8s x = %-9g position %2d : exp %.17g au lieu de %.17g, sommes %g %g %g au lieu de %g %g %g\n",
+               chemin, limites[l], k, r->e[k], ref->e[k], r->s[0], r->s[1], r->s[2], ref->s[0], ref->s[1], ref->s[2]);
+    }
+    return ecarts;
+}
+
+int main(void) {
+    int nlimites = (int)(sizeof(limites) / sizeof(limites[0]));
+    int echecs = 0, l, k;
+    unsigned c;
+
+    for (c = 0; c < sizeof(chemins) / sizeof(chemins[0]); c++) {
+        int ecarts = 0;
+
+        if (expvec_forcer(chemins[c]) != 0) {
+            printf("%-8s non supporte par ce processeur\n", chemins[c]);
+            continue;
+        }
+        for (l = 0; l < nlimites; l++) {
+            for (k = 0; k < TAILLE; k++) {
+                Resultats ref, r;
+                expvec_forcer("scalaire");
+                calculer(limites[l], limitesf[l], k, &ref);
+                expvec_forcer(chemins[c]);
+                calculer(limites[l], limitesf[l], k, &r);
+                ecarts += comparer(chemins[c], l, k, &ref, &r);
+            }
+        }
+        printf("%-8s %s\n", chemins[c], ecarts ? "differe du chemin scalaire" : "ok");
+        if (ecarts) echecs++;
+    }
+    printf(echecs ? "%d chemin(s) en echec\n" : "Tous les chemins concordent%.0d\n", echecs);
+    return echecs ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * verif_robuste.c
+ * Verification des droites robustes (robuste.h) contre le calcul direct
+ * en O(n²) : toutes les pentes pour Theil-Sen, la mediane des pentes de
+ * chaque point pour Siegel. Les jeux sont surtout des grilles entieres,
+ * ou les pentes egales abondent, plus un nuage continu ; les resultats
+ * doivent etre identiques au bit pres.
+ *
+ * Usage : ./verif_robuste [n]   (plus grande taille, defaut 3000)
+ * Retourne 1 si un jeu differe.
+ *
+ * Compilation : gcc -O2 verif_robuste.c robuste.c points.c pool.c -o verif_robuste -lm -pthread
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "points.h"
+#include "robuste.h"
+#include "alea.h"
+
+typedef struct {
+    const char *nom;
+    int largeur, hauteur;       /* x dans [0, largeur), y dans [0, hauteur) ; 0 : nuage continu */
+    double pente;               /* tendance ajoutee a y avant arrondi */
+} Jeu;
+
+static const Jeu jeux[] = {
+    { "grille 20 x 10", 20, 10, 0.0 },
+    { "grille 5 x 3", 5, 3, 0.0 },
+    { "grille 2 x 1000", 2, 1000, 0.0 },
+    { "grille 1000 x 2", 1000, 2, 0.0 },
+    { "tendance 1/3 arrondie", 60, 5, 1.0 / 3.0 },
+    { "nuage continu", 0, 0, 0.5 },
+};
+
+static int comparer(const void *a, const void *b) {
+    double u = *(const double *)a, v = *(const double *)b;
+    return (u > v) - (u < v);
+}
+
+static double mediane(double *v, size_t m) {
+    qsort(v, m, sizeof(double), comparer);
+    return 0.5 * (v[(m - 1) / 2] + v[m / 2]);
+}
+
+static double ordonnee(const Points *p, double a1, double *v) {
+    size_t i;
+    for (i = 0; i < p->n; i++) v[i] = p->yd[i] - a1 * p->xd[i];
+    return mediane(v, p->n);
+}
+
+/* Calcul direct ; meme expression des pentes que robuste.c */
+static void direct(const Points *p, int siegel, double *a0, double *a1) {
+    size_t n = p->n, i, j, m = 0;
+    double *v = (double *)malloc((siegel ? n : n * (n - 1) / 2) * sizeof(double));
+    double *w = (double *)malloc(n * sizeof(double));
+    size_t nw = 0;
+
+    if (!v || !w) {
+        fprintf(stderr, "memoire insuffisante\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < n; i++) {
+        if (siegel) m = 0;
+        for (j = siegel ? 0 : i + 1; j < n; j++)
+            if (p->xd[j] != p->xd[i]) v[m++] = (p->yd[j] - p->yd[i]) / (p->xd[j] - p->xd[i]);
+        if (siegel && m) w[nw++] = mediane(v, m);
+    }
+    *a1 = siegel ? mediane(w, nw) : mediane(v, m);
+    *a0 = ordonnee(p, *a1, w);
+    free(v);
+    free(w);
+}
+
+int main(int argc, char **argv) {
+    size_t nmax = argc > 1 ? (size_t)atol(argv[1]) : 3000, tailles[] = { 50, 500, 2000, 3000 }, t, i;
+    int echecs = 0, siegel;
+    unsigned k;
+
+    for (k = 0; k < sizeof(jeux) / sizeof(jeux[0]); k++) {
+        const Jeu *jeu = &jeux[k];
+        for (t = 0; t < sizeof(tailles) / sizeof(tailles[0]) && tailles[t] <= nmax; t++) {
+            Points p;
+            size_t n = tailles[t];
+            uint64_t z = 1000 * k + t;
+
+            if (points_alloc(&p, n, POINTS_DOUBLE) != 0) return EXIT_FAILURE;
+            for (i = 0; i < n; i++) {
+                double u = alea_uniforme(alea_melange(z++)), v = alea_uniforme(alea_melange(z++));
+                if (jeu->largeur) {
+                    p.xd[i] = floor(u * jeu->largeur);
+                    p.yd[i] = floor(v * jeu->hauteur + jeu->pente * p.xd[i]);
+                } else {
+                    p.xd[i] = u * 10.0;
+                    p.yd[i] = jeu->pente * p.xd[i] + v;
+                }
+            }
+            for (siegel = 0; siegel < 2; siegel++) {
+                double a0, a1, b0, b1;
+                int code = siegel ? robuste_siegel(&p, &a0, &a1, NULL) : robuste_theil_sen(&p, &a0, &a1, NULL);
+                direct(&p, siegel, &b0, &b1);
+                if (code != 0 || a0 != b0 || a1 != b1) {
+                    printf("ECHEC %-22s n = %4zu %-9s : %.17g %.17g au lieu de %.17g %.17g (code %d)\n", jeu->nom, n,
+                           siegel ? "siegel" : "theil-sen", a0, a1, b0, b1, code);
+                    echecs++;
+                }
+            }
+            points_free(&p);
+        }
+        printf("%-22s ok\n", jeu->nom);
+    }
+    printf(echecs ? "%d echec(s)\n" : "Tous les jeux concordent%.0d\n", echecs);
+    return echecs ? EXIT_FAILURE : 0;
+}